@@ -66,6 +66,10 @@ void setup() {
   usb_msc.setStartStopCallback(msc_start_stop_callback);
   usb_msc.setReadyCallback(msc_ready_callback);
 
+  // RAM disk is memory-mapped: transfer data directly from/to msc_disk without
+  // copying, read/write callbacks are still used as fallback
+  usb_msc.setMemoryMapped(msc_disk, msc_disk);
+
   // Set Lun ready (RAM disk is always ready)
   usb_msc.setUnitReady(true);
   usb_msc.begin();
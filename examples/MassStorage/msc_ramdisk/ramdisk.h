@@ -28,7 +28,8 @@
 #define README_CONTENTS                                                        \
   "This is TinyUSB MassStorage device demo for Arduino on RAM disk."
 
-uint8_t msc_disk[DISK_BLOCK_NUM][DISK_BLOCK_SIZE] = {
+// word aligned since it is transferred in place by USB controller (memory-mapped)
+TU_ATTR_ALIGNED(4) uint8_t msc_disk[DISK_BLOCK_NUM][DISK_BLOCK_SIZE] = {
     //------------- Block0: Boot Sector -------------//
     // byte_per_sector    = DISK_BLOCK_SIZE; fat12_sector_num_16  =
     // DISK_BLOCK_NUM; sector_per_cluster = 1; reserved_sectors = 1; fat_num =
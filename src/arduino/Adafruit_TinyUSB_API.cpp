@@ -47,6 +47,10 @@ void TinyUSB_Device_Init(uint8_t rhport) {
 void TinyUSB_Device_Task(void) {
   // Run tinyusb device task
   tud_task();
+
+#if CFG_TUD_MSC
+  TinyUSB_Device_FlushMSC();
+#endif
 }
 #endif
 
@@ -54,7 +58,10 @@ void TinyUSB_Device_Task(void) {
 void TinyUSB_Device_FlushCDC(void) {
   uint8_t const cdc_instance = Adafruit_USBD_CDC::getInstanceCount();
   for (uint8_t instance = 0; instance < cdc_instance; instance++) {
-    tud_cdc_n_write_flush(instance);
+    // pending data is sent by coalescing idle timer
+    if (!tud_cdc_n_write_auto_flush(instance)) {
+      tud_cdc_n_write_flush(instance);
+    }
   }
 }
 #endif
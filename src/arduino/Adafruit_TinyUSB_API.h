@@ -69,6 +69,9 @@ void TinyUSB_Device_Task(void) __attribute__((weak));
 // Called by core/sketch to flush write on CDC
 void TinyUSB_Device_FlushCDC(void) __attribute__((weak));
 
+// Called in device task to write back idle MSC sector cache
+void TinyUSB_Device_FlushMSC(void) __attribute__((weak));
+
 #ifdef __cplusplus
 }
 #endif
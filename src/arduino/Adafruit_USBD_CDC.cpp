@@ -46,6 +46,10 @@ Adafruit_USBD_CDC::Adafruit_USBD_CDC(void) { _instance = INVALID_INSTANCE; }
 
 #if CFG_TUD_ENABLED
 
+// writeDirect() completion callback of each instance
+static Adafruit_USBD_CDC::write_direct_callback_t
+    _write_direct_cb[CFG_TUD_CDC];
+
 uint16_t Adafruit_USBD_CDC::getInterfaceDescriptor(uint8_t itfnum_deprecated,
                                                    uint8_t *buf,
                                                    uint16_t bufsize) {
@@ -116,6 +120,7 @@ void Adafruit_USBD_CDC::end(void) {
   TinyUSBDevice.clearConfiguration();
   _instance_count = 0;
   _instance = INVALID_INSTANCE;
+  memset(_write_direct_cb, 0, sizeof(_write_direct_cb));
 }
 
 uint32_t Adafruit_USBD_CDC::baud(void) {
@@ -257,6 +262,15 @@ size_t Adafruit_USBD_CDC::write(const uint8_t *buffer, size_t size) {
   return size - remain;
 }
 
+void Adafruit_USBD_CDC::setWriteCoalescing(uint16_t threshold, uint32_t idle_us,
+                                           bool flush_on_newline) {
+  if (!isValid()) {
+    return;
+  }
+
+  tud_cdc_n_write_coalesce(_instance, threshold, idle_us, flush_on_newline);
+}
+
 int Adafruit_USBD_CDC::availableForWrite(void) {
   if (!isValid()) {
     return 0;
@@ -264,6 +278,51 @@ int Adafruit_USBD_CDC::availableForWrite(void) {
   return tud_cdc_n_write_available(_instance);
 }
 
+size_t Adafruit_USBD_CDC::writeDirect(const uint8_t *buffer, size_t size,
+                                      bool blocking) {
+  if (!isValid()) {
+    return 0;
+  }
+
+#if CFG_TUD_CDC_WRITE_BUFFER
+  if (!tud_cdc_n_write_buffer(_instance, buffer, size)) {
+    return write(buffer, size);
+  }
+
+  if (!blocking) {
+    return size;
+  }
+
+  // controller reads buffer until done, bus reset or unplug aborts it
+  while (tud_cdc_n_write_buffer_busy(_instance)) {
+    yield();
+  }
+
+  return tud_cdc_n_write_buffer_sent(_instance);
+#else
+  (void)blocking;
+  return write(buffer, size);
+#endif
+}
+
+bool Adafruit_USBD_CDC::writeDirectBusy(void) {
+#if CFG_TUD_CDC_WRITE_BUFFER
+  if (!isValid()) {
+    return false;
+  }
+  return tud_cdc_n_write_buffer_busy(_instance);
+#else
+  return false;
+#endif
+}
+
+void Adafruit_USBD_CDC::setWriteDirectCallback(write_direct_callback_t fp) {
+  if (!isValid()) {
+    return;
+  }
+  _write_direct_cb[_instance] = fp;
+}
+
 extern "C" {
 
 // Invoked when cdc when line state changed e.g connected/disconnected
@@ -284,6 +343,15 @@ void tud_cdc_line_state_cb(uint8_t instance, bool dtr, bool rts) {
     }
   }
 }
+
+#if CFG_TUD_CDC_WRITE_BUFFER
+// Invoked when buffer of writeDirect() is sent
+void tud_cdc_tx_buffer_complete_cb(uint8_t itf, uint32_t sent_bytes) {
+  if (itf < CFG_TUD_CDC && _write_direct_cb[itf]) {
+    _write_direct_cb[itf](sent_bytes);
+  }
+}
+#endif
 }
 
 #else
@@ -342,5 +410,26 @@ size_t Adafruit_USBD_CDC::write(const uint8_t *buffer, size_t size) {
 
 int Adafruit_USBD_CDC::availableForWrite(void) { return 0; }
 
+size_t Adafruit_USBD_CDC::writeDirect(const uint8_t *buffer, size_t size,
+                                      bool blocking) {
+  (void)buffer;
+  (void)size;
+  (void)blocking;
+  return 0;
+}
+
+bool Adafruit_USBD_CDC::writeDirectBusy(void) { return false; }
+
+void Adafruit_USBD_CDC::setWriteDirectCallback(write_direct_callback_t fp) {
+  (void)fp;
+}
+
+void Adafruit_USBD_CDC::setWriteCoalescing(uint16_t threshold, uint32_t idle_us,
+                                           bool flush_on_newline) {
+  (void)threshold;
+  (void)idle_us;
+  (void)flush_on_newline;
+}
+
 #endif // CFG_TUD_ENABLED
 #endif // CDC + ESP32
@@ -42,6 +42,7 @@
 
 class Adafruit_USBD_CDC : public Stream, public Adafruit_USBD_Interface {
 public:
+  typedef void (*write_direct_callback_t)(size_t sent);
   Adafruit_USBD_CDC(void);
 
   static uint8_t getInstanceCount(void) { return _instance_count; }
@@ -78,6 +79,25 @@ public:
 
   virtual int availableForWrite(void);
   using Print::write; // pull in write(str) from Print
+
+  // Coalesce small writes into full packets: pending data is sent once
+  // threshold bytes are queued (0: packet size), on newline if enabled, or
+  // after idle_us without write. With idle timer, the periodic flush after
+  // each loop() is skipped. Must be called after begin()
+  void setWriteCoalescing(uint16_t threshold, uint32_t idle_us,
+                          bool flush_on_newline = false);
+
+  // Send buffer straight from caller's memory without copying to FIFO.
+  // Requires CFG_TUD_CDC_WRITE_BUFFER, FIFO to be empty and buffer to be word
+  // aligned in RAM the controller's DMA can read (not flash), otherwise it is
+  // the same as write() and callback is not invoked. Blocking (default): wait
+  // until buffer is sent or transfer is aborted by bus reset/unplug, return
+  // number of bytes sent. Non-blocking: return size once queued, buffer must
+  // stay valid and unchanged until writeDirectBusy() is false or callback is
+  // invoked. Callback must be set after begin()
+  size_t writeDirect(const uint8_t *buffer, size_t size, bool blocking = true);
+  bool writeDirectBusy(void);
+  void setWriteDirectCallback(write_direct_callback_t fp);
   operator bool();
 
   // from Adafruit_USBD_Interface
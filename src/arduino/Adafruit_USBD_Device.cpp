@@ -153,6 +153,10 @@ uint8_t Adafruit_USBD_Device::addStringDescriptor(const char *s) {
 void Adafruit_USBD_Device::task(void) {
   tud_task();
 
+#if CFG_TUD_MSC
+  TinyUSB_Device_FlushMSC();
+#endif
+
 #ifdef TINYUSB_NEED_POLLING_TASK
   // can also be used with port with built-in support
   if (SerialTinyUSB) {
@@ -26,12 +26,16 @@
 
 #if CFG_TUD_ENABLED && CFG_TUD_MSC
 
+#include "Arduino.h"
+
 #include "Adafruit_USBD_MSC.h"
+#include "device/usbd_pvt.h"
 
 static Adafruit_USBD_MSC *_msc_dev = NULL;
 
 Adafruit_USBD_MSC::Adafruit_USBD_MSC(void) {
   _maxlun = 1;
+  _flush_idle_queued = false;
   memset(_lun_info, 0, sizeof(_lun_info));
 }
 
@@ -76,6 +80,19 @@ void Adafruit_USBD_MSC::setID(uint8_t lun, const char *vendor_id,
 
 void Adafruit_USBD_MSC::setCapacity(uint8_t lun, uint32_t block_count,
                                     uint16_t block_size) {
+  // medium changed: write back pending data then discard cache, disable it if
+  // line size no longer fits
+  if (_lun_info[lun].cache_count) {
+    (void)flush(lun);
+
+    if (block_size != _lun_info[lun].block_size) {
+      _lun_info[lun].cache_count = 0;
+    } else {
+      memset(_lun_info[lun].cache_lines, 0,
+             _lun_info[lun].cache_count * sizeof(cache_line_t));
+    }
+  }
+
   _lun_info[lun].block_count = block_count;
   _lun_info[lun].block_size = block_size;
 }
@@ -106,6 +123,323 @@ void Adafruit_USBD_MSC::setWritableCallback(uint8_t lun,
   _lun_info[lun].writable_cb = cb;
 }
 
+bool Adafruit_USBD_MSC::setCache(uint8_t lun, void *buffer, uint32_t bufsize,
+                                 uint32_t erase_size) {
+  // write back and drop current cache if any
+  (void)flush(lun);
+  _lun_info[lun].cache_count = 0;
+
+  if (!buffer) {
+    return true;
+  }
+
+  uint16_t const block_size = _lun_info[lun].block_size;
+  // READ10/WRITE10 chunks must be whole blocks to go through the cache
+  if (block_size == 0 || (CFG_TUD_MSC_EP_BUFSIZE % block_size) != 0 ||
+      erase_size < block_size || (erase_size % block_size) != 0 ||
+      erase_size / block_size > 32) {
+    return false;
+  }
+
+  // line info array is placed at (word-aligned) start of buffer, followed by
+  // line data
+  uintptr_t const addr = (uintptr_t)buffer;
+  uint32_t const pad = (uint32_t)(((addr + 3) & ~(uintptr_t)3) - addr);
+  if (bufsize <= pad) {
+    return false;
+  }
+
+  uint32_t const count = tu_min32(
+      (bufsize - pad) / (sizeof(cache_line_t) + erase_size), UINT16_MAX);
+  if (count == 0) {
+    return false;
+  }
+
+  _lun_info[lun].cache_lines = (cache_line_t *)(addr + pad);
+  _lun_info[lun].cache_data = (uint8_t *)(_lun_info[lun].cache_lines + count);
+  _lun_info[lun].cache_line_blocks = (uint8_t)(erase_size / block_size);
+  _lun_info[lun].cache_stamp = 0;
+  _lun_info[lun].cache_seq_lba = 0;
+  _lun_info[lun].cache_seq_count = 0;
+  memset(_lun_info[lun].cache_lines, 0, count * sizeof(cache_line_t));
+  _lun_info[lun].cache_count = (uint16_t)count;
+
+  return true;
+}
+
+void Adafruit_USBD_MSC::setMemoryMapped(uint8_t lun, const void *rd_addr,
+                                        void *wr_addr) {
+  _lun_info[lun].mem_rd = (const uint8_t *)rd_addr;
+  _lun_info[lun].mem_wr = (uint8_t *)wr_addr;
+}
+
+// Return address of blocks in memory-mapped media, NULL if out of range, not
+// word aligned (controller DMA requirement) or cache is enabled (it may hold
+// newer data)
+uint8_t *Adafruit_USBD_MSC::memAddress(uint8_t lun, uint8_t *base,
+                                       uint32_t lba, uint32_t offset,
+                                       uint32_t bufsize) {
+  uint64_t const addr = (uint64_t)lba * _lun_info[lun].block_size + offset;
+  uint64_t const disk_size =
+      (uint64_t)_lun_info[lun].block_count * _lun_info[lun].block_size;
+
+  if (!base || _lun_info[lun].cache_count || addr + bufsize > disk_size ||
+      ((uintptr_t)(base + addr) & 3u)) {
+    return NULL;
+  }
+
+  return base + addr;
+}
+
+bool Adafruit_USBD_MSC::flush(uint8_t lun) {
+  bool ret = true;
+
+  for (uint16_t i = 0; i < _lun_info[lun].cache_count; i++) {
+    if (!cacheFlushLine(lun, &_lun_info[lun].cache_lines[i])) {
+      ret = false;
+    }
+  }
+
+  if (_lun_info[lun].fl_cb) {
+    _lun_info[lun].fl_cb();
+  }
+
+  _lun_info[lun].cache_pending = !ret;
+  return ret;
+}
+
+// Check if cache holds data that host has not written for a while
+bool Adafruit_USBD_MSC::cacheIdle(uint8_t lun) {
+  return _lun_info[lun].cache_pending &&
+         (millis() - _lun_info[lun].cache_write_ms) >= CACHE_IDLE_MS;
+}
+
+// Write back cache once host has stopped writing for a while, must be called
+// in device task like the other tinyusb callbacks
+void Adafruit_USBD_MSC::cacheFlushIdle(uint8_t lun) {
+  if (cacheIdle(lun)) {
+    (void)flush(lun);
+  }
+}
+
+void Adafruit_USBD_MSC::cacheFlushIdleTask(void *param) {
+  Adafruit_USBD_MSC *msc = (Adafruit_USBD_MSC *)param;
+  msc->_flush_idle_queued = false;
+  for (uint8_t lun = 0; lun < msc->_maxlun; lun++) {
+    msc->cacheFlushIdle(lun);
+  }
+}
+
+void Adafruit_USBD_MSC::flushIfIdle(void) {
+  if (_flush_idle_queued || !tud_inited()) {
+    return;
+  }
+
+  for (uint8_t lun = 0; lun < _maxlun; lun++) {
+    if (cacheIdle(lun)) {
+      // cache is used by tinyusb callbacks, write it back in device task
+      _flush_idle_queued = true;
+      usbd_defer_func(cacheFlushIdleTask, this, false);
+      return;
+    }
+  }
+}
+
+// Return cached block data or NULL if not cached
+uint8_t *Adafruit_USBD_MSC::cacheLookup(uint8_t lun, uint32_t lba) {
+  uint8_t const line_blocks = _lun_info[lun].cache_line_blocks;
+  uint32_t const line_lba = lba - (lba % line_blocks);
+  uint32_t const bit = 1UL << (lba % line_blocks);
+
+  for (uint16_t i = 0; i < _lun_info[lun].cache_count; i++) {
+    cache_line_t *line = &_lun_info[lun].cache_lines[i];
+    if ((line->valid & bit) && line->lba == line_lba) {
+      line->stamp = ++_lun_info[lun].cache_stamp;
+      return _lun_info[lun].cache_data +
+             (uint32_t)i * line_blocks * _lun_info[lun].block_size +
+             (lba % line_blocks) * _lun_info[lun].block_size;
+    }
+  }
+
+  return NULL;
+}
+
+// Get line holding lba, allocate one (evict least recently used) if needed.
+// Return NULL if evicted line cannot be written back.
+Adafruit_USBD_MSC::cache_line_t *Adafruit_USBD_MSC::cacheGetLine(uint8_t lun,
+                                                                 uint32_t lba) {
+  uint8_t const line_blocks = _lun_info[lun].cache_line_blocks;
+  uint32_t const line_lba = lba - (lba % line_blocks);
+  cache_line_t *victim = NULL;
+
+  for (uint16_t i = 0; i < _lun_info[lun].cache_count; i++) {
+    cache_line_t *line = &_lun_info[lun].cache_lines[i];
+    if (line->valid && line->lba == line_lba) {
+      line->stamp = ++_lun_info[lun].cache_stamp;
+      return line;
+    }
+
+    // prefer empty line, then least recently used
+    if (!victim ||
+        (victim->valid && (!line->valid || line->stamp < victim->stamp))) {
+      victim = line;
+    }
+  }
+
+  if (victim->dirty && !cacheFlushLine(lun, victim)) {
+    return NULL;
+  }
+
+  victim->lba = line_lba;
+  victim->valid = 0;
+  victim->dirty = 0;
+  victim->stamp = ++_lun_info[lun].cache_stamp;
+
+  return victim;
+}
+
+// Write back dirty blocks of a line. Span from first to last dirty block is
+// written with a single callback so that its erase block is programmed once,
+// missing clean blocks within the span are read from storage first.
+bool Adafruit_USBD_MSC::cacheFlushLine(uint8_t lun, cache_line_t *line) {
+  if (!line->dirty) {
+    return true;
+  }
+
+  uint16_t const block_size = _lun_info[lun].block_size;
+  uint8_t *data = _lun_info[lun].cache_data +
+                  (uint32_t)(line - _lun_info[lun].cache_lines) *
+                      _lun_info[lun].cache_line_blocks * block_size;
+
+  uint8_t first = 0;
+  while (!(line->dirty & (1UL << first))) {
+    first++;
+  }
+  uint8_t last = _lun_info[lun].cache_line_blocks - 1;
+  while (!(line->dirty & (1UL << last))) {
+    last--;
+  }
+
+  for (uint8_t b = first; b <= last; b++) {
+    if (!(line->valid & (1UL << b))) {
+      if (!_lun_info[lun].rd_cb ||
+          _lun_info[lun].rd_cb(line->lba + b, data + b * block_size,
+                               block_size) != block_size) {
+        return false;
+      }
+      line->valid |= 1UL << b;
+    }
+  }
+
+  if (!_lun_info[lun].wr_cb) {
+    return false;
+  }
+
+  uint32_t const len = (uint32_t)(last - first + 1) * block_size;
+  uint32_t count = 0;
+  while (count < len) {
+    int32_t const wr =
+        _lun_info[lun].wr_cb(line->lba + first + count / block_size,
+                             data + first * block_size + count, len - count);
+    if (wr <= 0) {
+      return false; // keep dirty, retry on next flush
+    }
+    count += (uint32_t)wr;
+  }
+
+  line->dirty = 0;
+  return true;
+}
+
+// Read blocks, cached ones are copied from cache and others are read from
+// storage. Only short reads are added to cache, so that large file data reads
+// (which arrive as sequential chunks) do not evict file system metadata.
+int32_t Adafruit_USBD_MSC::cacheRead(uint8_t lun, uint32_t lba,
+                                     uint8_t *buffer, uint32_t bufsize) {
+  uint16_t const block_size = _lun_info[lun].block_size;
+  uint32_t const count = bufsize / block_size;
+  uint32_t i = 0;
+
+  if (lba == _lun_info[lun].cache_seq_lba) {
+    _lun_info[lun].cache_seq_count += count;
+  } else {
+    _lun_info[lun].cache_seq_count = count;
+  }
+  _lun_info[lun].cache_seq_lba = lba + count;
+  bool const fill =
+      (_lun_info[lun].cache_seq_count <= _lun_info[lun].cache_line_blocks);
+
+  while (i < count) {
+    uint8_t const *cached = cacheLookup(lun, lba + i);
+    if (cached) {
+      memcpy(buffer + i * block_size, cached, block_size);
+      i++;
+      continue;
+    }
+
+    // read run of not-cached blocks from storage
+    uint32_t n = 1;
+    while (i + n < count && !cacheLookup(lun, lba + i + n)) {
+      n++;
+    }
+
+    int32_t const rd = _lun_info[lun].rd_cb(lba + i, buffer + i * block_size,
+                                            n * block_size);
+    if (rd <= 0) {
+      return i ? (int32_t)(i * block_size) : rd;
+    }
+
+    uint32_t const got = (uint32_t)rd / block_size;
+    if (fill) {
+      for (uint32_t k = 0; k < got; k++) {
+        cache_line_t *line = cacheGetLine(lun, lba + i + k);
+        if (line) {
+          uint8_t const b = (lba + i + k) % _lun_info[lun].cache_line_blocks;
+          memcpy(_lun_info[lun].cache_data +
+                     ((uint32_t)(line - _lun_info[lun].cache_lines) *
+                          _lun_info[lun].cache_line_blocks + b) * block_size,
+                 buffer + (i + k) * block_size, block_size);
+          line->valid |= 1UL << b;
+        }
+      }
+    }
+
+    if ((uint32_t)rd < n * block_size) {
+      return (int32_t)(i * block_size) + rd;
+    }
+    i += n;
+  }
+
+  return (int32_t)bufsize;
+}
+
+// Write blocks into cache, written back to storage on flush() or eviction
+int32_t Adafruit_USBD_MSC::cacheWrite(uint8_t lun, uint32_t lba,
+                                      const uint8_t *buffer, uint32_t bufsize) {
+  uint16_t const block_size = _lun_info[lun].block_size;
+  uint32_t const count = bufsize / block_size;
+
+  for (uint32_t i = 0; i < count; i++) {
+    cache_line_t *line = cacheGetLine(lun, lba + i);
+    if (!line) {
+      return i ? (int32_t)(i * block_size) : -1;
+    }
+
+    uint8_t const b = (lba + i) % _lun_info[lun].cache_line_blocks;
+    memcpy(_lun_info[lun].cache_data +
+               ((uint32_t)(line - _lun_info[lun].cache_lines) *
+                    _lun_info[lun].cache_line_blocks + b) * block_size,
+           buffer + i * block_size, block_size);
+    line->valid |= 1UL << b;
+    line->dirty |= 1UL << b;
+  }
+
+  _lun_info[lun].cache_pending = true;
+  _lun_info[lun].cache_write_ms = millis();
+
+  return (int32_t)bufsize;
+}
+
 bool Adafruit_USBD_MSC::begin(void) {
   if (!TinyUSBDevice.addInterface(*this)) {
     return false;
@@ -118,6 +452,18 @@ bool Adafruit_USBD_MSC::begin(void) {
 //------------- TinyUSB callbacks -------------//
 extern "C" {
 
+// Called in device task to write back cache once host has stopped writing,
+// without waiting for TEST UNIT READY polling
+void TinyUSB_Device_FlushMSC(void) {
+  if (!_msc_dev) {
+    return;
+  }
+
+  for (uint8_t lun = 0; lun < _msc_dev->_maxlun; lun++) {
+    _msc_dev->cacheFlushIdle(lun);
+  }
+}
+
 // Invoked to determine max LUN
 uint8_t tud_msc_get_maxlun_cb(void) {
   if (!_msc_dev) {
@@ -158,6 +504,9 @@ bool tud_msc_test_unit_ready_cb(uint8_t lun) {
     return false;
   }
 
+  // host polls while idle
+  _msc_dev->cacheFlushIdle(lun);
+
   if (_msc_dev->_lun_info[lun].ready_cb) {
     _msc_dev->_lun_info[lun].unit_ready = _msc_dev->_lun_info[lun].ready_cb();
   }
@@ -192,6 +541,13 @@ int32_t tud_msc_scsi_cb(uint8_t lun, const uint8_t scsi_cmd[16], void *buffer,
   int32_t resplen = 0;
 
   switch (scsi_cmd[0]) {
+  case SCSI_CMD_SYNCHRONIZE_CACHE_10:
+    if (_msc_dev && !_msc_dev->flush(lun)) {
+      // Sense = Write Error
+      tud_msc_set_sense(lun, SCSI_SENSE_MEDIUM_ERROR, 0x0C, 0x00);
+      resplen = -1;
+    }
+    break;
 
   default:
     // Set Sense = Invalid Command Operation
@@ -219,6 +575,11 @@ int32_t tud_msc_scsi_cb(uint8_t lun, const uint8_t scsi_cmd[16], void *buffer,
 // Callback invoked on start/stop
 bool tud_msc_start_stop_cb(uint8_t lun, uint8_t power_condition, bool start,
                            bool load_eject) {
+  // write back cache on stop/eject
+  if (_msc_dev && !start) {
+    (void)_msc_dev->flush(lun);
+  }
+
   if (!(_msc_dev && _msc_dev->_lun_info[lun].start_stop_cb)) {
     return true;
   }
@@ -237,9 +598,39 @@ int32_t tud_msc_read10_cb(uint8_t lun, uint32_t lba, uint32_t offset,
     return -1;
   }
 
+  // whole blocks, see setCache()
+  if (_msc_dev->_lun_info[lun].cache_count) {
+    return _msc_dev->cacheRead(lun, lba, (uint8_t *)buffer, bufsize);
+  }
+
   return _msc_dev->_lun_info[lun].rd_cb(lba, buffer, bufsize);
 }
 
+// Callback invoked when received READ10 command, return memory-mapped contents
+// to be sent to host directly if available
+void *tud_msc_read10_mem_cb(uint8_t lun, uint32_t lba, uint32_t offset,
+                            uint32_t *bufsize) {
+  if (!_msc_dev) {
+    return NULL;
+  }
+
+  // read-only memory is never written by USB controller
+  uint8_t *base = (uint8_t *)(uintptr_t)_msc_dev->_lun_info[lun].mem_rd;
+  return _msc_dev->memAddress(lun, base, lba, offset, *bufsize);
+}
+
+// Callback invoked when received WRITE10 command, return memory-mapped
+// location where host data is received directly if available
+void *tud_msc_write10_mem_cb(uint8_t lun, uint32_t lba, uint32_t offset,
+                             uint32_t *bufsize) {
+  if (!_msc_dev) {
+    return NULL;
+  }
+
+  return _msc_dev->memAddress(lun, _msc_dev->_lun_info[lun].mem_wr, lba,
+                              offset, *bufsize);
+}
+
 // Callback invoked when received WRITE10 command.
 // Process data in buffer to disk's storage and return number of written bytes
 int32_t tud_msc_write10_cb(uint8_t lun, uint32_t lba, uint32_t offset,
@@ -250,13 +641,20 @@ int32_t tud_msc_write10_cb(uint8_t lun, uint32_t lba, uint32_t offset,
     return -1;
   }
 
+  // whole blocks, see setCache()
+  if (_msc_dev->_lun_info[lun].cache_count) {
+    return _msc_dev->cacheWrite(lun, lba, buffer, bufsize);
+  }
+
   return _msc_dev->_lun_info[lun].wr_cb(lba, buffer, bufsize);
 }
 
 // Callback invoked when WRITE10 command is completed (status received and
 // accepted by host). used to flush any pending cache.
 void tud_msc_write10_complete_cb(uint8_t lun) {
-  if (!(_msc_dev && _msc_dev->_lun_info[lun].fl_cb)) {
+  // sector cache is kept across commands, written back by flush() later
+  if (!(_msc_dev && _msc_dev->_lun_info[lun].fl_cb) ||
+      _msc_dev->_lun_info[lun].cache_count) {
     return;
   }
 
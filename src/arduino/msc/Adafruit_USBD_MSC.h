@@ -25,6 +25,7 @@
 #ifndef ADAFRUIT_USBD_MSC_H_
 #define ADAFRUIT_USBD_MSC_H_
 
+#include "arduino/Adafruit_TinyUSB_API.h"
 #include "arduino/Adafruit_USBD_Device.h"
 
 class Adafruit_USBD_MSC : public Adafruit_USBD_Interface {
@@ -57,6 +58,38 @@ public:
   void setWritableCallback(uint8_t lun, writable_callback_t cb);
   void setStartStopCallback(uint8_t lun, start_stop_callback_t cb);
 
+  // Enable sector cache using application provided buffer (NULL to disable).
+  // Buffer is split into lines of erase_size bytes (1-32 blocks), each holds
+  // an erase-block-aligned group of blocks. Small reads e.g file system
+  // metadata are served from cache, writes are held and coalesced per erase
+  // block until flush(), which is invoked on SYNCHRONIZE CACHE, stop/eject and
+  // once host has not written for a second (checked by device task, TEST UNIT
+  // READY polling and flushIfIdle()). A dirty line is also written back when
+  // evicted. Must be called after setCapacity(), block size must divide
+  // CFG_TUD_MSC_EP_BUFSIZE.
+  // Data loss window: written data is only in RAM until it is written back,
+  // i.e for about a second after host's last write (longer if device task is
+  // not running). Reset or power loss meanwhile loses it although host has
+  // completed the write, call flush() before resetting the board.
+  bool setCache(uint8_t lun, void *buffer, uint32_t bufsize,
+                uint32_t erase_size);
+
+  // Write back cached blocks then invoke flush callback
+  bool flush(uint8_t lun);
+
+  // Write back cache of all LUNs that host has not written for a second.
+  // Write-back is deferred to device task, so it is safe to call from loop()
+  // e.g on cores where device task does not run periodically
+  void flushIfIdle(void);
+
+  // Set address of memory-mapped media e.g RAM disk or XIP flash. READ10 data
+  // is sent to host directly from rd_addr, WRITE10 data is received directly
+  // into wr_addr (NULL if writes must go through write callback e.g flash),
+  // without copying through endpoint buffer. Memory must be accessible by USB
+  // controller and word aligned (e.g TU_ATTR_ALIGNED(4)), misaligned data
+  // goes through read/write callbacks. Not used while sector cache is enabled.
+  void setMemoryMapped(uint8_t lun, const void *rd_addr, void *wr_addr);
+
   //------------- Single LUN API -------------//
   void setID(const char *vendor_id, const char *product_id,
              const char *product_rev) {
@@ -81,6 +114,13 @@ public:
   void setStartStopCallback(start_stop_callback_t cb) {
     setStartStopCallback(0, cb);
   }
+  bool setCache(void *buffer, uint32_t bufsize, uint32_t erase_size) {
+    return setCache(0, buffer, bufsize, erase_size);
+  }
+  bool flush(void) { return flush(0); }
+  void setMemoryMapped(const void *rd_addr, void *wr_addr) {
+    setMemoryMapped(0, rd_addr, wr_addr);
+  }
 
   // from Adafruit_USBD_Interface
   virtual uint16_t getInterfaceDescriptor(uint8_t itfnum_deprecated,
@@ -88,6 +128,15 @@ public:
 
 private:
   enum { MAX_LUN = 2 }; // TODO make it configurable
+  enum { CACHE_IDLE_MS = 1000 };
+
+  typedef struct {
+    uint32_t lba;   // first block, aligned to line size
+    uint32_t valid; // bitmap of cached blocks
+    uint32_t dirty; // bitmap of blocks not yet written to storage
+    uint32_t stamp; // last access, for LRU eviction
+  } cache_line_t;
+
   struct {
     read_callback_t rd_cb;
     write_callback_t wr_cb;
@@ -104,11 +153,40 @@ private:
     uint16_t block_size;
     bool unit_ready;
 
+    // memory-mapped media, see setMemoryMapped()
+    const uint8_t *mem_rd;
+    uint8_t *mem_wr;
+
+    // sector cache, enabled if cache_count > 0
+    cache_line_t *cache_lines;
+    uint8_t *cache_data;
+    uint32_t cache_stamp;
+    uint32_t cache_seq_lba;   // next lba of sequential read
+    uint32_t cache_seq_count; // blocks read sequentially so far
+    uint32_t cache_write_ms;  // millis() of last write into cache
+    uint16_t cache_count;
+    uint8_t cache_line_blocks;
+    bool cache_pending; // written since last flush()
   } _lun_info[MAX_LUN];
 
   uint8_t _maxlun;
+  volatile bool _flush_idle_queued;
+
+  uint8_t *memAddress(uint8_t lun, uint8_t *base, uint32_t lba,
+                     uint32_t offset, uint32_t bufsize);
+  uint8_t *cacheLookup(uint8_t lun, uint32_t lba);
+  cache_line_t *cacheGetLine(uint8_t lun, uint32_t lba);
+  bool cacheFlushLine(uint8_t lun, cache_line_t *line);
+  bool cacheIdle(uint8_t lun);
+  void cacheFlushIdle(uint8_t lun);
+  static void cacheFlushIdleTask(void *param);
+  int32_t cacheRead(uint8_t lun, uint32_t lba, uint8_t *buffer,
+                    uint32_t bufsize);
+  int32_t cacheWrite(uint8_t lun, uint32_t lba, const uint8_t *buffer,
+                     uint32_t bufsize);
 
   // Make all tinyusb callback friend to access private data
+  friend void TinyUSB_Device_FlushMSC(void);
   friend void tud_msc_inquiry_cb(uint8_t lun, uint8_t vendor_id[8],
                                  uint8_t product_id[16],
                                  uint8_t product_rev[4]);
@@ -119,7 +197,13 @@ private:
                                    void *buffer, uint32_t bufsize);
   friend int32_t tud_msc_write10_cb(uint8_t lun, uint32_t lba, uint32_t offset,
                                     uint8_t *buffer, uint32_t bufsize);
+  friend void *tud_msc_read10_mem_cb(uint8_t lun, uint32_t lba,
+                                     uint32_t offset, uint32_t *bufsize);
+  friend void *tud_msc_write10_mem_cb(uint8_t lun, uint32_t lba,
+                                      uint32_t offset, uint32_t *bufsize);
   friend void tud_msc_write10_complete_cb(uint8_t lun);
+  friend int32_t tud_msc_scsi_cb(uint8_t lun, const uint8_t scsi_cmd[16],
+                                 void *buffer, uint16_t bufsize);
   friend bool tud_msc_is_writable_cb(uint8_t lun);
   friend bool tud_msc_start_stop_cb(uint8_t lun, uint8_t power_condition,
                                     bool start, bool load_eject);
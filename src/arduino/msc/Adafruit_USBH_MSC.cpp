@@ -38,32 +38,53 @@
 
 Adafruit_USBH_MSC_BlockDevice::Adafruit_USBH_MSC_BlockDevice() {
   _daddr = _lun = 0;
-  _busy = false;
+  _req_head = _req_count = 0;
+  _io_failed = false;
   _wr_cb = NULL;
+
+  _cache_buf = NULL;
+  _cache_bufsize = _cache_wrsize = 0;
+  cache_layout();
 }
 
 bool Adafruit_USBH_MSC_BlockDevice::begin(uint8_t dev_addr) {
   _daddr = dev_addr;
+  cache_layout();
   return true;
 }
 
 bool Adafruit_USBH_MSC_BlockDevice::setActiveLUN(uint8_t lun) {
+  bool const ret = wb_flush();
   _lun = lun;
-  return true;
+  cache_layout();
+  return ret;
 }
 void Adafruit_USBH_MSC_BlockDevice::setWriteCompleteCallback(
     tuh_msc_complete_cb_t cb) {
   _wr_cb = cb;
 }
 
-void Adafruit_USBH_MSC_BlockDevice::end(void) { _daddr = _lun = 0; }
+void Adafruit_USBH_MSC_BlockDevice::end(void) {
+  _daddr = _lun = 0;
+  _req_head = _req_count = 0;
+  cache_layout();
+}
 
 bool Adafruit_USBH_MSC_BlockDevice::mounted(void) { return _daddr > 0; }
 
-bool Adafruit_USBH_MSC_BlockDevice::isBusy(void) { return _busy; }
+bool Adafruit_USBH_MSC_BlockDevice::isBusy(void) { return _req_count > 0; }
+
+uint8_t Adafruit_USBH_MSC_BlockDevice::pendingCount(void) { return _req_count; }
+
+// Run usb host task until at most max_pending requests are in progress
+bool Adafruit_USBH_MSC_BlockDevice::wait_for_io(uint8_t max_pending) {
+  while (_req_count > max_pending) {
+    if (!(_daddr && tuh_msc_mounted(_daddr))) {
+      // device removed: its requests are dropped
+      _req_head = _req_count = 0;
+      return false;
+    }
 
-bool Adafruit_USBH_MSC_BlockDevice::wait_for_io(void) {
-  while (_busy) {
     if (tuh_task_event_ready()) {
       tuh_task();
     }
@@ -74,24 +95,38 @@ bool Adafruit_USBH_MSC_BlockDevice::wait_for_io(void) {
 
 bool Adafruit_USBH_MSC_BlockDevice::_io_complete_cb(
     uint8_t dev_addr, tuh_msc_complete_data_t const *cb_data) {
-  (void)cb_data;
-  if (dev_addr != _daddr) {
+  if (dev_addr != _daddr || _req_count == 0) {
     // something wrong occurred, maybe device removed while transferring
     return false;
   }
 
-  // TODO skip csw status: assuming io is successful
-  _busy = false;
+  bool const success = (cb_data->csw->status == MSC_CSW_STATUS_PASSED);
+  if (!success) {
+    _io_failed = true;
+  }
+
+  // requests are completed in submitted order
+  tuh_msc_complete_cb_t const req_cb = _req[_req_head].cb;
+  uintptr_t const req_arg = _req[_req_head].arg;
+  _req_head = (_req_head + 1) % REQ_MAX;
+  _req_count--;
 
   switch (cb_data->cbw->command[0]) {
   case SCSI_CMD_WRITE_10:
+  case SCSI_CMD_WRITE_16:
     if (_wr_cb) {
       _wr_cb(dev_addr, cb_data);
     }
     break;
   }
 
-  return true;
+  if (req_cb) {
+    tuh_msc_complete_data_t req_data = *cb_data;
+    req_data.user_arg = req_arg;
+    req_cb(dev_addr, &req_data);
+  }
+
+  return success;
 }
 
 static bool _msc_io_complete_cb(uint8_t dev_addr,
@@ -107,35 +142,297 @@ uint32_t Adafruit_USBH_MSC_BlockDevice::sectorCount(void) {
 }
 
 bool Adafruit_USBH_MSC_BlockDevice::syncDevice(void) {
-  // no caching
-  return true;
+  // write back held sectors and wait for submitted requests
+  bool const ret = wb_flush();
+  return wait_for_io(0) && ret;
 }
 
-bool Adafruit_USBH_MSC_BlockDevice::readSectors(uint32_t block, uint8_t *dst,
-                                                size_t ns) {
-  _busy = true;
-  if (tuh_msc_read10(_daddr, _lun, dst, block, (uint16_t)ns,
-                     _msc_io_complete_cb, (uintptr_t)this)) {
-    wait_for_io();
+//--------------------------------------------------------------------+
+// Cache
+//--------------------------------------------------------------------+
+
+bool Adafruit_USBH_MSC_BlockDevice::setCache(void *buffer, uint32_t bufsize,
+                                             uint32_t write_size) {
+  // write back and drop current cache if any
+  bool const ret = wb_flush();
+
+  _cache_buf = buffer;
+  _cache_bufsize = buffer ? bufsize : 0;
+  _cache_wrsize = tu_min32(write_size, _cache_bufsize);
+  cache_layout();
+
+  return ret;
+}
+
+// Split cache buffer for current device's block size, held data is discarded
+void Adafruit_USBH_MSC_BlockDevice::cache_layout(void) {
+  _cache_count = 0;
+  _cache_stamp = 0;
+  _wb_max = _wb_count = 0;
+  _cache_block_size = 0;
+
+  if (!_cache_buf || !mounted()) {
+    return;
+  }
+
+  uint32_t const block_size = tuh_msc_get_block_size(_daddr, _lun);
+  if (block_size == 0) {
+    return;
+  }
+  _cache_block_size = block_size;
+
+  // line info array is placed at (word-aligned) start of buffer, followed by
+  // write buffer then line data
+  uintptr_t const addr = (uintptr_t)_cache_buf;
+  uint32_t const pad = (uint32_t)(((addr + 3) & ~(uintptr_t)3) - addr);
+  if (_cache_bufsize <= pad) {
+    return;
+  }
+
+  _wb_max = tu_min32(_cache_wrsize, _cache_bufsize - pad) / block_size;
+  uint32_t const remain = _cache_bufsize - pad - _wb_max * block_size;
+  uint32_t const count =
+      tu_min32(remain / (sizeof(cache_line_t) + block_size), UINT16_MAX);
+
+  _cache_lines = (cache_line_t *)(addr + pad);
+  _wb_data = (uint8_t *)(_cache_lines + count);
+  _cache_data = _wb_data + _wb_max * block_size;
+  memset(_cache_lines, 0, count * sizeof(cache_line_t));
+  _cache_count = (uint16_t)count;
+}
+
+// Return cached sector data or NULL if not cached
+uint8_t *Adafruit_USBH_MSC_BlockDevice::cache_lookup(uint32_t lba) {
+  for (uint16_t i = 0; i < _cache_count; i++) {
+    cache_line_t *line = &_cache_lines[i];
+    if (line->stamp && line->lba == lba) {
+      line->stamp = ++_cache_stamp;
+      return _cache_data + (uint32_t)i * _cache_block_size;
+    }
+  }
+
+  return NULL;
+}
+
+// Add sector to cache, evict least recently used line if needed
+void Adafruit_USBH_MSC_BlockDevice::cache_insert(uint32_t lba,
+                                                 uint8_t const *data) {
+  if (_cache_count == 0) {
+    return;
+  }
+
+  uint16_t victim = 0;
+  for (uint16_t i = 0; i < _cache_count; i++) {
+    if (_cache_lines[i].stamp < _cache_lines[victim].stamp) {
+      victim = i;
+    }
+  }
+
+  _cache_lines[victim].lba = lba;
+  _cache_lines[victim].stamp = ++_cache_stamp;
+  memcpy(_cache_data + (uint32_t)victim * _cache_block_size, data,
+         _cache_block_size);
+}
+
+// Update cached sectors with newly written data
+void Adafruit_USBH_MSC_BlockDevice::cache_update(uint32_t lba,
+                                                 uint8_t const *data,
+                                                 size_t ns) {
+  for (uint16_t i = 0; i < _cache_count; i++) {
+    cache_line_t const *line = &_cache_lines[i];
+    if (line->stamp && line->lba >= lba && line->lba - lba < ns) {
+      memcpy(_cache_data + (uint32_t)i * _cache_block_size,
+             data + (line->lba - lba) * _cache_block_size, _cache_block_size);
+    }
+  }
+}
+
+bool Adafruit_USBH_MSC_BlockDevice::wb_overlap(uint32_t lba, size_t ns) {
+  return _wb_count && (uint64_t)lba < (uint64_t)_wb_lba + _wb_count &&
+         (uint64_t)_wb_lba < (uint64_t)lba + ns;
+}
+
+// Write back held sectors with a single request
+bool Adafruit_USBH_MSC_BlockDevice::wb_flush(void) {
+  if (_wb_count == 0) {
     return true;
+  }
+
+  uint32_t const count = _wb_count;
+  _wb_count = 0;
+  return rw_sectors(false, _wb_lba, _wb_data, count);
+}
+
+// READ/WRITE(10) carries up to 65535 blocks, READ/WRITE(16) is only used with
+// device larger than 2^32 blocks (which must support it) for up to 4 GiB per
+// command.
+uint32_t Adafruit_USBH_MSC_BlockDevice::ioMaxSectors(void) {
+  uint32_t const block_size = tuh_msc_get_block_size(_daddr, _lun);
+  if (block_size == 0) {
+    return 0;
+  }
+
+  bool const rw16 = tuh_msc_get_block_count64(_daddr, _lun) > UINT32_MAX;
+  return rw16 ? (UINT32_MAX / block_size) : UINT16_MAX;
+}
+
+// Submit a single SCSI read/write command
+bool Adafruit_USBH_MSC_BlockDevice::submit(bool is_read, uint32_t block,
+                                           uint8_t *buf, uint32_t count,
+                                           tuh_msc_complete_cb_t cb,
+                                           uintptr_t arg) {
+  if (_req_count >= REQ_MAX) {
+    return false;
+  }
+
+  uint8_t const idx = (_req_head + _req_count) % REQ_MAX;
+  _req[idx].cb = cb;
+  _req[idx].arg = arg;
+  _req_count++;
+
+  bool ok;
+  if (tuh_msc_get_block_count64(_daddr, _lun) > UINT32_MAX) {
+    ok = is_read ? tuh_msc_read16(_daddr, _lun, buf, block, count,
+                                  _msc_io_complete_cb, (uintptr_t)this)
+                 : tuh_msc_write16(_daddr, _lun, buf, block, count,
+                                   _msc_io_complete_cb, (uintptr_t)this);
   } else {
-    _busy = false;
+    ok = is_read ? tuh_msc_read10(_daddr, _lun, buf, block, (uint16_t)count,
+                                  _msc_io_complete_cb, (uintptr_t)this)
+                 : tuh_msc_write10(_daddr, _lun, buf, block, (uint16_t)count,
+                                   _msc_io_complete_cb, (uintptr_t)this);
+  }
+
+  if (!ok) {
+    _req_count--;
+  }
+
+  return ok;
+}
+
+// Blocking read/write split into maximally-sized SCSI commands, which are
+// queued back-to-back if CFG_TUH_MSC_QUEUE_DEPTH > 0
+bool Adafruit_USBH_MSC_BlockDevice::rw_sectors(bool is_read, uint32_t block,
+                                               uint8_t *buf, size_t ns) {
+  uint32_t const block_size = tuh_msc_get_block_size(_daddr, _lun);
+  uint32_t const max_blocks = ioMaxSectors();
+  if (max_blocks == 0) {
+    return false;
+  }
+
+  // complete previously submitted requests first
+  if (!wait_for_io(0)) {
+    return false;
+  }
+  _io_failed = false;
+
+  while (ns) {
+    uint32_t const count = (uint32_t)tu_min32(ns, max_blocks);
+
+    if (!wait_for_io(REQ_MAX - 1) ||
+        !submit(is_read, block, buf, count, NULL, 0)) {
+      (void)wait_for_io(0);
+      return false;
+    }
+
+    block += count;
+    buf += count * block_size;
+    ns -= count;
+  }
+
+  return wait_for_io(0) && !_io_failed;
+}
+
+bool Adafruit_USBH_MSC_BlockDevice::readSectorsAsync(uint32_t block,
+                                                     uint8_t *dst, size_t ns,
+                                                     tuh_msc_complete_cb_t cb,
+                                                     uintptr_t arg) {
+  if (ns == 0 || ns > ioMaxSectors()) {
+    return false;
+  }
+  if (wb_overlap(block, ns) && !wb_flush()) {
+    return false;
+  }
+  return submit(true, block, dst, (uint32_t)ns, cb, arg);
+}
+
+bool Adafruit_USBH_MSC_BlockDevice::writeSectorsAsync(
+    uint32_t block, const uint8_t *src, size_t ns, tuh_msc_complete_cb_t cb,
+    uintptr_t arg) {
+  if (ns == 0 || ns > ioMaxSectors()) {
+    return false;
+  }
+  // held sectors must not be written back after this request
+  if (wb_overlap(block, ns) && !wb_flush()) {
     return false;
   }
+  cache_update(block, src, ns);
+  return submit(false, block, (uint8_t *)(uintptr_t)src, (uint32_t)ns, cb,
+                arg);
+}
+
+bool Adafruit_USBH_MSC_BlockDevice::readSectors(uint32_t block, uint8_t *dst,
+                                                size_t ns) {
+  if (wb_overlap(block, ns)) {
+    if (block >= _wb_lba && block - _wb_lba + ns <= _wb_count) {
+      memcpy(dst, _wb_data + (block - _wb_lba) * _cache_block_size,
+             ns * _cache_block_size);
+      return true;
+    }
+
+    if (!wb_flush()) {
+      return false;
+    }
+  }
+
+  // only single sector reads are cached, large ones are most likely file data
+  if (ns == 1 && _cache_count) {
+    uint8_t const *cached = cache_lookup(block);
+    if (cached) {
+      memcpy(dst, cached, _cache_block_size);
+      return true;
+    }
+
+    if (!rw_sectors(true, block, dst, 1)) {
+      return false;
+    }
+    cache_insert(block, dst);
+    return true;
+  }
+
+  return rw_sectors(true, block, dst, ns);
 }
 
 bool Adafruit_USBH_MSC_BlockDevice::writeSectors(uint32_t block,
                                                  const uint8_t *src,
                                                  size_t ns) {
-  _busy = true;
-  if (tuh_msc_write10(_daddr, _lun, src, block, (uint16_t)ns,
-                      _msc_io_complete_cb, (uintptr_t)this)) {
-    wait_for_io();
-    return true;
-  } else {
-    _busy = false;
-    return false;
+  cache_update(block, src, ns);
+
+  if (_wb_max) {
+    // overwrite or append to held sectors
+    if (_wb_count && block >= _wb_lba && block - _wb_lba <= _wb_count &&
+        block - _wb_lba + ns <= _wb_max) {
+      uint32_t const offset = block - _wb_lba;
+      memcpy(_wb_data + offset * _cache_block_size, src,
+             ns * _cache_block_size);
+      _wb_count = tu_max32(_wb_count, offset + ns);
+      return true;
+    }
+
+    if (!wb_flush()) {
+      return false;
+    }
+
+    // hold it if there is room for following sectors
+    if (ns < _wb_max) {
+      memcpy(_wb_data, src, ns * _cache_block_size);
+      _wb_lba = block;
+      _wb_count = ns;
+      return true;
+    }
   }
+
+  return rw_sectors(false, block, (uint8_t *)(uintptr_t)src, ns);
 }
 
 bool Adafruit_USBH_MSC_BlockDevice::readSector(uint32_t block, uint8_t *dst) {
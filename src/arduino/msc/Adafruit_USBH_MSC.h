@@ -55,6 +55,35 @@ public:
   virtual bool writeSector(uint32_t block, const uint8_t *src);
   virtual bool writeSectors(uint32_t block, const uint8_t *src, size_t ns);
 
+  //------------- Non-blocking API -------------//
+  // Submit read/write of up to ioMaxSectors() and return immediately. Buffer
+  // must be kept valid until request is complete. Optional complete callback
+  // is invoked from tuh_task() with user_arg = arg, check cb_data->csw->status
+  // for result. Up to CFG_TUH_MSC_QUEUE_DEPTH + 1 requests can be submitted,
+  // they are executed in order with next CBW sent right after previous CSW.
+  // Pending requests are completed with failed status if device is removed.
+  // Must be called from the context (task/core) that runs tuh_task().
+  bool readSectorsAsync(uint32_t block, uint8_t *dst, size_t ns,
+                        tuh_msc_complete_cb_t cb = NULL, uintptr_t arg = 0);
+  bool writeSectorsAsync(uint32_t block, const uint8_t *src, size_t ns,
+                         tuh_msc_complete_cb_t cb = NULL, uintptr_t arg = 0);
+
+  // Number of submitted requests not yet complete
+  uint8_t pendingCount(void);
+
+  // Max number of sectors of a single request
+  uint32_t ioMaxSectors(void);
+
+  //------------- Cache -------------//
+  // Enable sector cache using application provided buffer (NULL to disable).
+  // First write_size bytes (rounded down to sectors) collect sequential writes
+  // which are sent with a single WRITE command when a non-sequential write or
+  // an overlapping read occurs, and on syncDevice(). Rest of buffer holds
+  // recently read single sectors e.g FAT and directory. Write errors of held
+  // data are reported by the call that writes them back. Can be called before
+  // begin(), cache is discarded when device is unmounted.
+  bool setCache(void *buffer, uint32_t bufsize, uint32_t write_size = 0);
+
   //------------- Internal APIs -------------//
   bool _io_complete_cb(uint8_t dev_addr,
                        tuh_msc_complete_data_t const *cb_data);
@@ -63,13 +92,54 @@ private:
   uint8_t _daddr;
   uint8_t _lun;
 
-  // TODO use mutex to prevent race condition or atomic for better
-  // implementation
-  volatile bool _busy;
+  // submitted requests, completed in order
+  enum { REQ_MAX = CFG_TUH_MSC_QUEUE_DEPTH + 1 };
+  struct {
+    tuh_msc_complete_cb_t cb;
+    uintptr_t arg;
+  } _req[REQ_MAX];
+
+  // Updated by submit() and _io_complete_cb() without locking: the block
+  // device must be used from the context (task/core) that runs tuh_task(),
+  // as its blocking API also runs tuh_task() while waiting
+  volatile uint8_t _req_head;
+  volatile uint8_t _req_count;
+  volatile bool _io_failed;
 
   tuh_msc_complete_cb_t _wr_cb;
 
-  bool wait_for_io(void);
+  typedef struct {
+    uint32_t lba;
+    uint32_t stamp; // last access for LRU eviction, 0 if line is empty
+  } cache_line_t;
+
+  // sector cache, see setCache()
+  void *_cache_buf;
+  uint32_t _cache_bufsize;
+  uint32_t _cache_wrsize;
+  uint32_t _cache_block_size;
+  cache_line_t *_cache_lines;
+  uint8_t *_cache_data;
+  uint32_t _cache_stamp;
+  uint16_t _cache_count;
+
+  // write coalescing buffer holds _wb_count sectors starting at _wb_lba
+  uint8_t *_wb_data;
+  uint32_t _wb_max;
+  uint32_t _wb_lba;
+  uint32_t _wb_count;
+
+  void cache_layout(void);
+  uint8_t *cache_lookup(uint32_t lba);
+  void cache_insert(uint32_t lba, uint8_t const *data);
+  void cache_update(uint32_t lba, uint8_t const *data, size_t ns);
+  bool wb_overlap(uint32_t lba, size_t ns);
+  bool wb_flush(void);
+
+  bool wait_for_io(uint8_t max_pending);
+  bool submit(bool is_read, uint32_t block, uint8_t *buf, uint32_t count,
+              tuh_msc_complete_cb_t cb, uintptr_t arg);
+  bool rw_sectors(bool is_read, uint32_t block, uint8_t *buf, size_t ns);
 };
 
 #endif
@@ -30,6 +30,7 @@
 #include "nrfx_power.h"
 
 #include "Arduino.h"
+#include "arduino/Adafruit_TinyUSB_API.h"
 #include "arduino/Adafruit_USBD_Device.h"
 
 //--------------------------------------------------------------------+
@@ -38,6 +39,9 @@
 
 #define USBD_STACK_SZ (200)
 
+// max time device task waits for event
+#define USBD_IDLE_WAKEUP_MS (100)
+
 //--------------------------------------------------------------------+
 // Forward USB interrupt events to TinyUSB IRQ Handler
 //--------------------------------------------------------------------+
@@ -79,7 +83,13 @@ static void usb_device_task(void *param) {
 
   // RTOS forever loop
   while (1) {
+#if CFG_TUD_MSC
+    // wake up without event to write back idle MSC cache
+    tud_task_ext(USBD_IDLE_WAKEUP_MS, false);
+    TinyUSB_Device_FlushMSC();
+#else
     tud_task();
+#endif
     TinyUSB_Device_FlushCDC();
   }
 }
@@ -139,6 +139,9 @@ void TinyUSB_Device_Task(void) {
   // Since tud_task() is also invoked in ISR, we need to get the mutex first
   if (mutex_try_enter(&__usb_mutex, NULL)) {
     tud_task();
+#if CFG_TUD_MSC
+    TinyUSB_Device_FlushMSC();
+#endif
     mutex_exit(&__usb_mutex);
   }
 }
@@ -126,6 +126,7 @@ Adafruit_USBD_WebUSB::Adafruit_USBD_WebUSB(const void *url) {
   _connected = false;
   _url = (const uint8_t *)url;
   _linestate_cb = NULL;
+  _write_direct_cb = NULL;
 }
 
 bool Adafruit_USBD_WebUSB::begin(void) {
@@ -240,6 +241,39 @@ int Adafruit_USBD_WebUSB::peek(void) {
 
 void Adafruit_USBD_WebUSB::flush(void) { tud_vendor_flush(); }
 
+size_t Adafruit_USBD_WebUSB::writeDirect(const uint8_t *buffer, size_t size,
+                                         bool blocking) {
+#if CFG_TUD_VENDOR_TXRX_BUFFERED && CFG_TUD_VENDOR_WRITE_BUFFER
+  if (tud_vendor_write_buffer(buffer, size)) {
+    if (!blocking) {
+      return size;
+    }
+
+    // controller reads buffer until done, bus reset or unplug aborts it
+    while (tud_vendor_write_buffer_busy()) {
+      yield();
+    }
+    return tud_vendor_write_buffer_sent();
+  }
+#else
+  (void)blocking;
+#endif
+
+  return write(buffer, size);
+}
+
+bool Adafruit_USBD_WebUSB::writeDirectBusy(void) {
+#if CFG_TUD_VENDOR_TXRX_BUFFERED && CFG_TUD_VENDOR_WRITE_BUFFER
+  return tud_vendor_write_buffer_busy();
+#else
+  return false;
+#endif
+}
+
+void Adafruit_USBD_WebUSB::setWriteDirectCallback(write_direct_callback_t fp) {
+  _write_direct_cb = fp;
+}
+
 //--------------------------------------------------------------------+
 // TinyUSB stack callbacks
 //--------------------------------------------------------------------+
@@ -317,6 +351,16 @@ tud_vendor_control_xfer_cb(uint8_t rhport, uint8_t stage,
 
   return true;
 }
+
+#if CFG_TUD_VENDOR_WRITE_BUFFER
+// Invoked when buffer of writeDirect() is sent
+void tud_vendor_tx_buffer_complete_cb(uint8_t idx, uint32_t sent_bytes) {
+  (void)idx;
+  if (_webusb_dev && _webusb_dev->_write_direct_cb) {
+    _webusb_dev->_write_direct_cb(sent_bytes);
+  }
+}
+#endif
 }
 
 #endif // CFG_TUD_ENABLED
@@ -39,6 +39,7 @@
 class Adafruit_USBD_WebUSB : public Stream, public Adafruit_USBD_Interface {
 public:
   typedef void (*linestate_callback_t)(bool connected);
+  typedef void (*write_direct_callback_t)(size_t sent);
   Adafruit_USBD_WebUSB(const void *url = NULL);
 
   bool begin(void);
@@ -61,6 +62,13 @@ public:
     return write((const uint8_t *)buffer, size);
   }
 
+  // Send buffer straight from caller's memory without copying to FIFO, needs
+  // CFG_TUD_VENDOR_WRITE_BUFFER (else same as write()). Blocking by default,
+  // return number of bytes sent, see Adafruit_USBD_CDC::writeDirect()
+  size_t writeDirect(const uint8_t *buffer, size_t size, bool blocking = true);
+  bool writeDirectBusy(void);
+  void setWriteDirectCallback(write_direct_callback_t fp);
+
   bool connected(void);
   operator bool();
 
@@ -72,10 +80,13 @@ private:
   bool _connected;
   const uint8_t *_url;
   linestate_callback_t _linestate_cb;
+  write_direct_callback_t _write_direct_cb;
 
   // Make all tinyusb callback friend to access private data
   friend bool tud_vendor_control_xfer_cb(uint8_t rhport, uint8_t stage,
                                          tusb_control_request_t const *request);
+  friend void tud_vendor_tx_buffer_complete_cb(uint8_t idx,
+                                              uint32_t sent_bytes);
 };
 
 #endif /* ADAFRUIT_USBD_WEBUSB_H_ */
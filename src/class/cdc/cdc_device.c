@@ -48,15 +48,25 @@ typedef struct {
   uint8_t itf_num;
   uint8_t ep_notify;
   uint8_t line_state; // Bit 0: DTR, Bit 1: RTS
+  volatile uint8_t isr_notify; // callbacks pending for transfers completed in ISR
+
+  uint16_t tx_idle_start_frame;   // frame number when idle time counting started
+  volatile bool tx_idle_started;  // tx_idle_start_frame is recorded by SOF, cleared by write to restart counting
+  volatile bool tx_idle_expired;  // idle time is over, pending data must be sent
 
   /*------------- From this point, data is not cleared by bus reset -------------*/
   TU_ATTR_ALIGNED(4) cdc_line_coding_t line_coding;
   char wanted_char;
 
+  // transmit coalescing policy
+  bool tx_flush_on_newline;
+  uint16_t tx_threshold;   // pending bytes to start a transfer, 0: endpoint packet size
+  uint16_t tx_idle_frames; // flush after frames without write, 0: disabled
+
   tu_edpt_stream_t tx_stream;
   tu_edpt_stream_t rx_stream;
 
-  uint8_t tx_ff_buf[CFG_TUD_CDC_TX_BUFSIZE];
+  TU_ATTR_ALIGNED(4) uint8_t tx_ff_buf[CFG_TUD_CDC_TX_BUFSIZE];
   uint8_t rx_ff_buf[CFG_TUD_CDC_RX_BUFSIZE];
 } cdcd_interface_t;
 
@@ -92,6 +102,13 @@ TU_ATTR_WEAK void tud_cdc_tx_complete_cb(uint8_t itf) {
   (void)itf;
 }
 
+#if CFG_TUD_CDC_WRITE_BUFFER
+TU_ATTR_WEAK void tud_cdc_tx_buffer_complete_cb(uint8_t itf, uint32_t sent_bytes) {
+  (void)itf;
+  (void)sent_bytes;
+}
+#endif
+
 TU_ATTR_WEAK void tud_cdc_notify_complete_cb(uint8_t itf) {
   (void)itf;
 }
@@ -115,7 +132,14 @@ TU_ATTR_WEAK void tud_cdc_send_break_cb(uint8_t itf, uint16_t duration_ms) {
 //--------------------------------------------------------------------+
 // INTERNAL OBJECT & FUNCTION DECLARATION
 //--------------------------------------------------------------------+
-static cdcd_interface_t _cdcd_itf[CFG_TUD_CDC];
+// tx fifo is read by controller with CFG_TUD_CDC_TX_DIRECT
+#if CFG_TUD_CDC_TX_DIRECT
+  #define CDCD_ITF_MEM_ATTR CFG_TUD_MEM_SECTION
+#else
+  #define CDCD_ITF_MEM_ATTR
+#endif
+
+CDCD_ITF_MEM_ATTR static cdcd_interface_t _cdcd_itf[CFG_TUD_CDC];
 
 TU_ATTR_ALWAYS_INLINE static inline uint8_t find_cdc_itf(uint8_t ep_addr) {
   for (uint8_t idx = 0; idx < CFG_TUD_CDC; idx++) {
@@ -128,6 +152,45 @@ TU_ATTR_ALWAYS_INLINE static inline uint8_t find_cdc_itf(uint8_t ep_addr) {
   return TUSB_INDEX_INVALID_8;
 }
 
+// Check if wanted char is in the last received bytes i.e in ep buffer or at the end of rx fifo
+static bool rx_wanted_char_received(cdcd_interface_t *p_cdc, uint32_t xferred_bytes) {
+#if CFG_TUD_CDC_RX_STAGED
+  // received bytes may be partly staged in ep buffer
+  if (p_cdc->rx_stream.staged) {
+    return memchr(p_cdc->rx_stream.ep_buf, p_cdc->wanted_char, xferred_bytes) != NULL;
+  }
+#endif
+
+  tu_fifo_buffer_info_t buf_info;
+  tu_fifo_get_read_info(&p_cdc->rx_stream.ff, &buf_info);
+
+  // find backward
+  uint8_t *ptr;
+  if (buf_info.wrapped.len > 0) {
+    ptr = buf_info.wrapped.ptr + buf_info.wrapped.len - 1; // last byte of wrap buffer
+  } else if (buf_info.linear.len > 0) {
+    ptr = buf_info.linear.ptr + buf_info.linear.len - 1;   // last byte of linear buffer
+  } else {
+    return false;                                          // no data
+  }
+
+  for (uint32_t i = 0; i < xferred_bytes; i++) {
+    if (p_cdc->wanted_char == (char)*ptr) {
+      return true; // only invoke once per transfer, even if multiple wanted chars are present
+    }
+
+    if (ptr == buf_info.wrapped.ptr) {
+      ptr = buf_info.linear.ptr + buf_info.linear.len - 1; // last byte of linear buffer
+    } else if (ptr == buf_info.linear.ptr) {
+      break;                                               // reached the beginning
+    } else {
+      ptr--;
+    }
+  }
+
+  return false;
+}
+
 //--------------------------------------------------------------------+
 // APPLICATION API
 //--------------------------------------------------------------------+
@@ -209,13 +272,112 @@ void tud_cdc_n_read_flush(uint8_t itf) {
   tu_edpt_stream_read_xfer(&p_cdc->rx_stream);
 }
 
+//--------------------------------------------------------------------+
+// Transmit coalescing
+//--------------------------------------------------------------------+
+TU_ATTR_ALWAYS_INLINE static inline bool tx_coalesce_enabled(const cdcd_interface_t *p_cdc) {
+  return p_cdc->tx_threshold > 0 || p_cdc->tx_idle_frames > 0 || p_cdc->tx_flush_on_newline;
+}
+
+// Pending bytes to start a transfer: at least packet size, at most what FIFO and endpoint buffer can hold
+static uint16_t tx_threshold(const cdcd_interface_t *p_cdc) {
+  const tu_edpt_stream_t *s = &p_cdc->tx_stream;
+  const uint16_t threshold = tu_max16(p_cdc->tx_threshold, s->mps);
+  return tu_min16(threshold, tu_min16(tu_fifo_depth(&s->ff), s->xfer_len));
+}
+
+// With idle timer, bytes left after a transfer completes are held until threshold is reached or timer expires
+static bool tx_hold(const cdcd_interface_t *p_cdc) {
+  return p_cdc->tx_idle_frames > 0 && !p_cdc->tx_idle_expired &&
+         tu_fifo_count(&p_cdc->tx_stream.ff) < tx_threshold(p_cdc);
+}
+
+// Data is written to FIFO: send if policy allows, otherwise restart idle timer
+static void tx_written(cdcd_interface_t *p_cdc, bool newline) {
+  if (newline || tu_fifo_count(&p_cdc->tx_stream.ff) >= tx_threshold(p_cdc)) {
+    tu_edpt_stream_write_xfer(&p_cdc->tx_stream);
+  }
+  p_cdc->tx_idle_started = false;
+}
+
+// Idle time is over, deferred from cdcd_sof_isr()
+static void tx_idle_flush(void *param) {
+  cdcd_interface_t *p_cdc = &_cdcd_itf[(uintptr_t) param];
+  p_cdc->tx_idle_started = false;
+
+  // if endpoint is busy, tx_idle_expired is kept so that pending data is sent once current transfer completes
+  if (tu_edpt_stream_write_xfer(&p_cdc->tx_stream) > 0 || tu_fifo_empty(&p_cdc->tx_stream.ff)) {
+    p_cdc->tx_idle_expired = false;
+  }
+}
+
+// SOF is only needed while an opened interface has idle timer
+static void tx_sof_update(uint8_t rhport) {
+  bool en = false;
+  for (uint8_t i = 0; i < CFG_TUD_CDC; i++) {
+    if (_cdcd_itf[i].tx_idle_frames > 0 && tu_edpt_stream_is_opened(&_cdcd_itf[i].tx_stream)) {
+      en = true;
+    }
+  }
+  usbd_sof_enable(rhport, SOF_CONSUMER_CDC, en);
+}
+
+void tud_cdc_n_write_coalesce(uint8_t itf, uint16_t threshold, uint32_t idle_us, bool flush_on_newline) {
+  TU_VERIFY(itf < CFG_TUD_CDC, );
+  cdcd_interface_t *p_cdc = &_cdcd_itf[itf];
+
+  p_cdc->tx_threshold = threshold;
+  p_cdc->tx_flush_on_newline = flush_on_newline;
+  // frame number is 11-bit
+  p_cdc->tx_idle_frames = (uint16_t) tu_min32(tu_div_ceil(idle_us, 1000), 1024);
+
+  if (tu_edpt_stream_is_opened(&p_cdc->tx_stream)) {
+    tx_sof_update(p_cdc->rhport);
+    tu_edpt_stream_write_xfer(&p_cdc->tx_stream); // pending data may not be subject to coalescing anymore
+  }
+}
+
+bool tud_cdc_n_write_auto_flush(uint8_t itf) {
+  TU_VERIFY(itf < CFG_TUD_CDC);
+  return _cdcd_itf[itf].tx_idle_frames > 0;
+}
+
 //--------------------------------------------------------------------+
 // WRITE API
 //--------------------------------------------------------------------+
 uint32_t tud_cdc_n_write(uint8_t itf, const void* buffer, uint32_t bufsize) {
   TU_VERIFY(itf < CFG_TUD_CDC, 0);
   cdcd_interface_t *p_cdc = &_cdcd_itf[itf];
-  return tu_edpt_stream_write(&p_cdc->tx_stream, buffer, bufsize);
+  if (!tx_coalesce_enabled(p_cdc)) {
+    return tu_edpt_stream_write(&p_cdc->tx_stream, buffer, bufsize);
+  }
+
+  TU_VERIFY(bufsize > 0, 0);
+  const uint16_t count = tu_fifo_write_n(&p_cdc->tx_stream.ff, buffer, (uint16_t) bufsize);
+  tx_written(p_cdc, p_cdc->tx_flush_on_newline && memchr(buffer, '\n', count) != NULL);
+  return count;
+}
+
+uint8_t* tud_cdc_n_write_reserve(uint8_t itf, uint16_t n, uint16_t* len) {
+  *len = 0;
+  TU_VERIFY(itf < CFG_TUD_CDC, NULL);
+  cdcd_interface_t *p_cdc = &_cdcd_itf[itf];
+  return tu_edpt_stream_write_reserve(&p_cdc->tx_stream, n, len);
+}
+
+uint32_t tud_cdc_n_write_commit(uint8_t itf, uint16_t n) {
+  TU_VERIFY(itf < CFG_TUD_CDC, 0);
+  cdcd_interface_t *p_cdc = &_cdcd_itf[itf];
+  if (!tx_coalesce_enabled(p_cdc)) {
+    return tu_edpt_stream_write_commit(&p_cdc->tx_stream, n);
+  }
+
+  // reserved space is not scanned for newline
+  tu_fifo_write_commit(&p_cdc->tx_stream.ff, n);
+  if (n > 0) {
+    tx_written(p_cdc, false);
+  }
+  return n;
 }
 
 uint32_t tud_cdc_n_write_flush(uint8_t itf) {
@@ -233,10 +395,29 @@ uint32_t tud_cdc_n_write_available(uint8_t itf) {
 bool tud_cdc_n_write_clear(uint8_t itf) {
   TU_VERIFY(itf < CFG_TUD_CDC);
   cdcd_interface_t *p_cdc = &_cdcd_itf[itf];
-  tu_edpt_stream_clear(&p_cdc->tx_stream);
-  return true;
+  return tu_edpt_stream_clear(&p_cdc->tx_stream);
+}
+
+#if CFG_TUD_CDC_WRITE_BUFFER
+bool tud_cdc_n_write_buffer(uint8_t itf, const void *buffer, uint32_t bufsize) {
+  TU_VERIFY(itf < CFG_TUD_CDC);
+  cdcd_interface_t *p_cdc = &_cdcd_itf[itf];
+  return tu_edpt_stream_write_buffer(&p_cdc->tx_stream, buffer, bufsize);
 }
 
+bool tud_cdc_n_write_buffer_busy(uint8_t itf) {
+  TU_VERIFY(itf < CFG_TUD_CDC);
+  cdcd_interface_t *p_cdc = &_cdcd_itf[itf];
+  return tu_edpt_stream_write_buffer_busy(&p_cdc->tx_stream);
+}
+
+uint32_t tud_cdc_n_write_buffer_sent(uint8_t itf) {
+  TU_VERIFY(itf < CFG_TUD_CDC, 0);
+  cdcd_interface_t *p_cdc = &_cdcd_itf[itf];
+  return tu_edpt_stream_write_buffer_sent(&p_cdc->tx_stream);
+}
+#endif
+
 //--------------------------------------------------------------------+
 // USBD Driver API
 //--------------------------------------------------------------------+
@@ -252,6 +433,10 @@ void cdcd_init(void) {
     p_cdc->line_coding.parity = 0;
     p_cdc->line_coding.data_bits = 8;
 
+    p_cdc->tx_threshold = CFG_TUD_CDC_TX_COALESCE_THRESHOLD;
+    p_cdc->tx_idle_frames = TU_DIV_CEIL(CFG_TUD_CDC_TX_COALESCE_IDLE_US, 1000);
+    p_cdc->tx_flush_on_newline = CFG_TUD_CDC_TX_COALESCE_NEWLINE;
+
   #if CFG_TUD_EDPT_DEDICATED_HWFIFO
     uint8_t *epout_buf = NULL;
     uint8_t *epin_buf  = NULL;
@@ -261,12 +446,18 @@ void cdcd_init(void) {
   #endif
 
     tu_edpt_stream_init(&p_cdc->rx_stream, false, false, false, p_cdc->rx_ff_buf, CFG_TUD_CDC_RX_BUFSIZE, epout_buf);
+  #if CFG_TUD_CDC_RX_STAGED
+    tu_edpt_stream_set_staged(&p_cdc->rx_stream, true); // keep receiving while application is slow to read
+  #endif
 
     // TX fifo can be configured to change to overwritable if not connected (DTR bit not set). Without DTR we do not
     // know if data is actually polled by terminal. This way the most current data is prioritized.
     // Default: is overwritable
     tu_edpt_stream_init(&p_cdc->tx_stream, false, true, CFG_TUD_CDC_TX_OVERWRITABLE_IF_NOT_CONNECTED, p_cdc->tx_ff_buf,
                         CFG_TUD_CDC_TX_BUFSIZE, epin_buf);
+  #if CFG_TUD_CDC_TX_DIRECT
+    tu_edpt_stream_set_direct(&p_cdc->tx_stream, true);
+  #endif
   }
 }
 
@@ -286,10 +477,11 @@ void cdcd_reset(uint8_t rhport) {
     cdcd_interface_t* p_cdc = &_cdcd_itf[i];
     tu_memclr(p_cdc, ITF_MEM_RESET_SIZE);
 
-    tu_fifo_set_overwritable(&p_cdc->tx_stream.ff, CFG_TUD_CDC_TX_OVERWRITABLE_IF_NOT_CONNECTED); // back to default
     tu_edpt_stream_close(&p_cdc->rx_stream);
     tu_edpt_stream_close(&p_cdc->tx_stream);
+    tu_edpt_stream_set_overwritable(&p_cdc->tx_stream, CFG_TUD_CDC_TX_OVERWRITABLE_IF_NOT_CONNECTED); // back to default
   }
+  tx_sof_update(rhport);
 }
 
 uint16_t cdcd_open(uint8_t rhport, const tusb_desc_interface_t* itf_desc, uint16_t max_len) {
@@ -347,6 +539,7 @@ uint16_t cdcd_open(uint8_t rhport, const tusb_desc_interface_t* itf_desc, uint16
   #else
           tu_edpt_stream_clear(stream_tx);
   #endif
+          tx_sof_update(rhport);
         } else {
           tu_edpt_stream_t *stream_rx = &p_cdc->rx_stream;
   #if CFG_TUD_CDC_RX_NEED_ZLP
@@ -431,7 +624,7 @@ bool cdcd_control_xfer_cb(uint8_t rhport, uint8_t stage, const tusb_control_requ
         const bool is_overwritable = false;
   #endif
 
-        tu_fifo_set_overwritable(&p_cdc->tx_stream.ff, is_overwritable);
+        tu_edpt_stream_set_overwritable(&p_cdc->tx_stream, is_overwritable);
         TU_LOG_DRV("  Set Control Line State: DTR = %d, RTS = %d\r\n", dtr, rts);
         tud_cdc_line_state_cb(itf, dtr, rts); // invoke callback
       } else {
@@ -472,36 +665,8 @@ bool cdcd_xfer_cb(uint8_t rhport, uint8_t ep_addr, xfer_result_t result, uint32_
     tu_edpt_stream_read_xfer_complete(stream_rx, xferred_bytes);
 
     // Check for wanted char and invoke wanted callback
-    if (((signed char)p_cdc->wanted_char) != -1) {
-      tu_fifo_buffer_info_t buf_info;
-      tu_fifo_get_read_info(&stream_rx->ff, &buf_info);
-
-      // find backward
-      uint8_t *ptr;
-      if (buf_info.wrapped.len > 0) {
-        ptr = buf_info.wrapped.ptr + buf_info.wrapped.len - 1; // last byte of wrap buffer
-      } else if (buf_info.linear.len > 0) {
-        ptr = buf_info.linear.ptr + buf_info.linear.len - 1;   // last byte of linear buffer
-      } else {
-        ptr = NULL;                                      // no data
-      }
-
-      if (ptr != NULL) {
-        for (uint32_t i = 0; i < xferred_bytes; i++) {
-          if (p_cdc->wanted_char == (char)*ptr) {
-            tud_cdc_rx_wanted_cb(itf, p_cdc->wanted_char);
-            break; // only invoke once per transfer, even if multiple wanted chars are present
-          }
-
-          if (ptr == buf_info.wrapped.ptr) {
-            ptr = buf_info.linear.ptr + buf_info.linear.len - 1; // last byte of linear buffer
-          } else if (ptr == buf_info.linear.ptr) {
-            break;                                         // reached the beginning
-          } else {
-            ptr--;
-          }
-        }
-      }
+    if (((signed char)p_cdc->wanted_char) != -1 && rx_wanted_char_received(p_cdc, xferred_bytes)) {
+      tud_cdc_rx_wanted_cb(itf, p_cdc->wanted_char);
     }
 
     // invoke receive callback if there is still data
@@ -515,11 +680,24 @@ bool cdcd_xfer_cb(uint8_t rhport, uint8_t ep_addr, xfer_result_t result, uint32_
   // Data sent to host, we continue to fetch from tx fifo to send.
   // Note: This will cause incorrect baudrate set in line coding. Though maybe the baudrate is not really important!
   if (ep_addr == stream_tx->ep_addr) {
+  #if CFG_TUD_CDC_WRITE_BUFFER
+    if (tu_edpt_stream_write_buffer_busy(stream_tx)) {
+      if (!tu_edpt_stream_write_buffer_xfer_complete(stream_tx, xferred_bytes)) {
+        return true; // next part of buffer is queued
+      }
+      tud_cdc_tx_buffer_complete_cb(itf, stream_tx->user_sent);
+    }
+  #endif
+
+    tu_edpt_stream_write_xfer_complete(stream_tx);
     tud_cdc_tx_complete_cb(itf); // invoke callback to possibly refill tx fifo
 
-    if (0 == tu_edpt_stream_write_xfer(stream_tx)) {
-      // If there is no data left, a ZLP should be sent if needed
-      tu_edpt_stream_write_zlp_if_needed(stream_tx, xferred_bytes);
+    if (!tx_hold(p_cdc)) {
+      p_cdc->tx_idle_expired = false;
+      if (0 == tu_edpt_stream_write_xfer(stream_tx)) {
+        // If there is no data left, a ZLP should be sent if needed
+        tu_edpt_stream_write_zlp_if_needed(stream_tx, xferred_bytes);
+      }
     }
   }
 
@@ -531,4 +709,106 @@ bool cdcd_xfer_cb(uint8_t rhport, uint8_t ep_addr, xfer_result_t result, uint32_
   return true;
 }
 
+// Count idle time of interfaces with pending data, flush is deferred to tud_task()
+void cdcd_sof_isr(uint8_t rhport, uint32_t frame_count) {
+  (void) rhport;
+
+  for (uint8_t i = 0; i < CFG_TUD_CDC; i++) {
+    cdcd_interface_t *p_cdc = &_cdcd_itf[i];
+    if (p_cdc->tx_idle_frames == 0 || p_cdc->tx_idle_expired || tu_fifo_empty(&p_cdc->tx_stream.ff)) {
+      continue;
+    }
+
+    if (!p_cdc->tx_idle_started) {
+      p_cdc->tx_idle_start_frame = (uint16_t) frame_count;
+      p_cdc->tx_idle_started = true;
+    } else if (((frame_count - p_cdc->tx_idle_start_frame) & 0x7FFu) >= p_cdc->tx_idle_frames) {
+      p_cdc->tx_idle_expired = true;
+      usbd_defer_func(tx_idle_flush, (void *) (uintptr_t) i, true);
+    }
+  }
+}
+
+#if CFG_TUD_CDC_XFER_ISR
+enum {
+  CDC_ISR_NOTIFY_RX        = 0x01u,
+  CDC_ISR_NOTIFY_RX_WANTED = 0x02u,
+  CDC_ISR_NOTIFY_TX        = 0x04u,
+};
+
+// Invoke callbacks of transfers completed in ISR, deferred to tud_task()
+static void cdcd_isr_notify_task(void *param) {
+  const uint8_t     itf   = (uint8_t)(uintptr_t)param;
+  cdcd_interface_t *p_cdc = &_cdcd_itf[itf];
+
+  usbd_spin_lock(false);
+  const uint8_t notify = p_cdc->isr_notify;
+  p_cdc->isr_notify    = 0;
+  usbd_spin_unlock(false);
+
+  if (notify & CDC_ISR_NOTIFY_RX_WANTED) {
+    tud_cdc_rx_wanted_cb(itf, p_cdc->wanted_char);
+  }
+
+  if ((notify & CDC_ISR_NOTIFY_RX) && !tu_edpt_stream_empty(&p_cdc->rx_stream)) {
+    tud_cdc_rx_cb(itf);
+  }
+
+  if (notify & CDC_ISR_NOTIFY_TX) {
+    tud_cdc_tx_complete_cb(itf);
+  }
+}
+
+// Only defer once until callbacks are invoked
+static void cdcd_isr_notify(uint8_t itf, cdcd_interface_t *p_cdc, uint8_t flags) {
+  const bool deferred = (p_cdc->isr_notify != 0);
+  p_cdc->isr_notify |= flags;
+  if (!deferred) {
+    usbd_defer_func(cdcd_isr_notify_task, (void *)(uintptr_t)itf, true);
+  }
+}
+
+bool cdcd_xfer_isr(uint8_t rhport, uint8_t ep_addr, xfer_result_t result, uint32_t xferred_bytes) {
+  (void)rhport;
+  TU_VERIFY(result == XFER_RESULT_SUCCESS); // defer error to xfer_cb()
+
+  const uint8_t itf = find_cdc_itf(ep_addr);
+  TU_VERIFY(itf < CFG_TUD_CDC);
+  cdcd_interface_t *p_cdc     = &_cdcd_itf[itf];
+  tu_edpt_stream_t *stream_rx = &p_cdc->rx_stream;
+  tu_edpt_stream_t *stream_tx = &p_cdc->tx_stream;
+
+  if (ep_addr == stream_rx->ep_addr) {
+    tu_edpt_stream_read_xfer_complete(stream_rx, xferred_bytes);
+
+    uint8_t flags = CDC_ISR_NOTIFY_RX;
+    if (((signed char)p_cdc->wanted_char) != -1 && rx_wanted_char_received(p_cdc, xferred_bytes)) {
+      flags |= CDC_ISR_NOTIFY_RX_WANTED;
+    }
+
+    // if fifo is full, next transfer is queued by tud_cdc_n_read() once there is space
+    tu_edpt_stream_read_xfer_isr(stream_rx);
+    cdcd_isr_notify(itf, p_cdc, flags);
+    return true;
+  }
+
+  if (ep_addr == stream_tx->ep_addr) {
+  #if CFG_TUD_CDC_WRITE_BUFFER
+    TU_VERIFY(!tu_edpt_stream_write_buffer_busy(stream_tx)); // user buffer is continued by xfer_cb()
+  #endif
+    tu_edpt_stream_write_xfer_complete(stream_tx);
+
+    // if fifo is empty or data is held for coalescing, next transfer is queued by tud_cdc_n_write()/flush()
+    if (!tx_hold(p_cdc)) {
+      p_cdc->tx_idle_expired = false;
+      tu_edpt_stream_write_xfer_isr(stream_tx, xferred_bytes);
+    }
+    cdcd_isr_notify(itf, p_cdc, CDC_ISR_NOTIFY_TX);
+    return true;
+  }
+
+  return false; // notification is handled by xfer_cb()
+}
+#endif
+
 #endif
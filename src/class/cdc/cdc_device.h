@@ -80,9 +80,33 @@
   #define CFG_TUD_CDC_TX_PERSISTENT 0
 #endif
 
-// If not connected, tx fifo can be overwritten
+// If not connected, tx fifo can be overwritten. Lock-free multi-producer fifo (CFG_TUSB_FIFO_MPSC) never overwrites,
+// it defaults to 0 i.e new data is dropped when tx fifo is full and not connected.
 #ifndef CFG_TUD_CDC_TX_OVERWRITABLE_IF_NOT_CONNECTED
-  #define CFG_TUD_CDC_TX_OVERWRITABLE_IF_NOT_CONNECTED 1
+  #define CFG_TUD_CDC_TX_OVERWRITABLE_IF_NOT_CONNECTED (CFG_TUSB_FIFO_MPSC ? 0 : 1)
+#endif
+
+#if CFG_TUSB_FIFO_MPSC && CFG_TUD_CDC_TX_OVERWRITABLE_IF_NOT_CONNECTED
+  #error "CFG_TUD_CDC_TX_OVERWRITABLE_IF_NOT_CONNECTED is not supported with CFG_TUSB_FIFO_MPSC"
+#endif
+
+// Continue bulk transfers in transfer complete ISR instead of deferring to tud_task() to reduce latency: received data
+// is moved to rx fifo and next transfer is queued right away. Callbacks are still invoked in tud_task() context.
+#ifndef CFG_TUD_CDC_XFER_ISR
+  #define CFG_TUD_CDC_XFER_ISR 0
+#endif
+
+// Default transmit coalescing policy, see tud_cdc_n_write_coalesce()
+#ifndef CFG_TUD_CDC_TX_COALESCE_THRESHOLD
+  #define CFG_TUD_CDC_TX_COALESCE_THRESHOLD 0
+#endif
+
+#ifndef CFG_TUD_CDC_TX_COALESCE_IDLE_US
+  #define CFG_TUD_CDC_TX_COALESCE_IDLE_US 0
+#endif
+
+#ifndef CFG_TUD_CDC_TX_COALESCE_NEWLINE
+  #define CFG_TUD_CDC_TX_COALESCE_NEWLINE 0
 #endif
 
 // Backward compatible: tud_cdc_configure_t and tud_cdc_configure() are no longer used.
@@ -147,15 +171,50 @@ TU_ATTR_ALWAYS_INLINE static inline uint32_t tud_cdc_n_write_str(uint8_t itf, ch
   return tud_cdc_n_write(itf, str, strlen(str));
 }
 
+// Reserve up to n bytes of contiguous space in TX FIFO to be filled directly (e.g by DMA) without extra copy.
+// Return pointer to reserved space and its size in len, which can be less than n when FIFO is almost full or wraps
+// around. Return NULL if there is no space. A non-NULL reservation must be completed with tud_cdc_n_write_commit()
+uint8_t* tud_cdc_n_write_reserve(uint8_t itf, uint16_t n, uint16_t* len);
+
+// Commit n bytes written to reserved space, data may remain in the FIFO for a while same as tud_cdc_n_write()
+uint32_t tud_cdc_n_write_commit(uint8_t itf, uint16_t n);
+
 // Force sending data if possible, return number of forced bytes
 uint32_t tud_cdc_n_write_flush(uint8_t itf);
 
 // Return the number of bytes (characters) available for writing to TX FIFO buffer in a single n_write operation.
 uint32_t tud_cdc_n_write_available(uint8_t itf);
 
-// Clear the TX FIFO
+// Clear the TX FIFO, return false while its data is being sent in place (CFG_TUD_CDC_TX_DIRECT)
 bool tud_cdc_n_write_clear(uint8_t itf);
 
+#if CFG_TUD_CDC_WRITE_BUFFER
+// Send buffer straight from caller's memory without copying to TX FIFO, large buffers are sent with 64KB transfers.
+// Only started if TX FIFO is empty, no transfer is in progress and buffer is word aligned, return false otherwise (use
+// tud_cdc_n_write() instead). The controller reads the buffer in place: it must be reachable by the controller's DMA
+// (RAM, not flash on ports such as nRF5x) and stay valid and unchanged until tud_cdc_tx_buffer_complete_cb() is
+// invoked, i.e. it must not be a stack buffer of a returning function. Data written to TX FIFO meanwhile is sent after
+// the buffer
+bool tud_cdc_n_write_buffer(uint8_t itf, const void *buffer, uint32_t bufsize);
+
+// Check if buffer of tud_cdc_n_write_buffer() is still being sent. Also cleared when transfer is aborted by bus reset
+bool tud_cdc_n_write_buffer_busy(uint8_t itf);
+
+// Get number of bytes of tud_cdc_n_write_buffer() sent so far, final once it is no longer busy
+uint32_t tud_cdc_n_write_buffer_sent(uint8_t itf);
+#endif
+
+// Set transmit coalescing policy. Data written to TX FIFO is sent once
+// - threshold bytes are pending (0: endpoint packet size), limited to FIFO and endpoint buffer size
+// - '\n' is written if flush_on_newline
+// - nothing has been written for idle_us (0: disabled), counted with SOF at 1 ms resolution
+// - tud_cdc_n_write_flush() is called
+// With idle timer, bytes left after a transfer completes also wait for threshold so that packets are filled up
+void tud_cdc_n_write_coalesce(uint8_t itf, uint16_t threshold, uint32_t idle_us, bool flush_on_newline);
+
+// Check if pending data is flushed by idle timer i.e calling tud_cdc_n_write_flush() is not required
+bool tud_cdc_n_write_auto_flush(uint8_t itf);
+
 #if CFG_TUD_CDC_NOTIFY
 bool tud_cdc_n_notify_msg(uint8_t itf, cdc_notify_msg_t *msg);
 
@@ -254,6 +313,14 @@ TU_ATTR_ALWAYS_INLINE static inline uint32_t tud_cdc_write_str(char const* str)
   return tud_cdc_n_write_str(0, str);
 }
 
+TU_ATTR_ALWAYS_INLINE static inline uint8_t* tud_cdc_write_reserve(uint16_t n, uint16_t* len) {
+  return tud_cdc_n_write_reserve(0, n, len);
+}
+
+TU_ATTR_ALWAYS_INLINE static inline uint32_t tud_cdc_write_commit(uint16_t n) {
+  return tud_cdc_n_write_commit(0, n);
+}
+
 TU_ATTR_ALWAYS_INLINE static inline uint32_t tud_cdc_write_flush(void) {
   return tud_cdc_n_write_flush(0);
 }
@@ -266,6 +333,25 @@ TU_ATTR_ALWAYS_INLINE static inline bool tud_cdc_write_clear(void) {
   return tud_cdc_n_write_clear(0);
 }
 
+#if CFG_TUD_CDC_WRITE_BUFFER
+TU_ATTR_ALWAYS_INLINE static inline bool tud_cdc_write_buffer(const void *buffer, uint32_t bufsize) {
+  return tud_cdc_n_write_buffer(0, buffer, bufsize);
+}
+
+TU_ATTR_ALWAYS_INLINE static inline bool tud_cdc_write_buffer_busy(void) {
+  return tud_cdc_n_write_buffer_busy(0);
+}
+
+TU_ATTR_ALWAYS_INLINE static inline uint32_t tud_cdc_write_buffer_sent(void) {
+  return tud_cdc_n_write_buffer_sent(0);
+}
+#endif
+
+TU_ATTR_ALWAYS_INLINE static inline void tud_cdc_write_coalesce(uint16_t threshold, uint32_t idle_us,
+                                                                bool flush_on_newline) {
+  tud_cdc_n_write_coalesce(0, threshold, idle_us, flush_on_newline);
+}
+
 //--------------------------------------------------------------------+
 // Application Callback API
 //--------------------------------------------------------------------+
@@ -279,6 +365,11 @@ void tud_cdc_rx_wanted_cb(uint8_t itf, char wanted_char);
 // Invoked when a TX is complete and therefore space becomes available in TX buffer
 void tud_cdc_tx_complete_cb(uint8_t itf);
 
+#if CFG_TUD_CDC_WRITE_BUFFER
+// Invoked when buffer of tud_cdc_n_write_buffer() is sent (sent_bytes < bufsize if transfer failed)
+void tud_cdc_tx_buffer_complete_cb(uint8_t itf, uint32_t sent_bytes);
+#endif
+
 // Invoked when a notification is sent to host
 void tud_cdc_notify_complete_cb(uint8_t itf);
 
@@ -303,6 +394,8 @@ void     cdcd_reset           (uint8_t rhport);
 uint16_t cdcd_open            (uint8_t rhport, tusb_desc_interface_t const * itf_desc, uint16_t max_len);
 bool     cdcd_control_xfer_cb (uint8_t rhport, uint8_t stage, tusb_control_request_t const * request);
 bool     cdcd_xfer_cb         (uint8_t rhport, uint8_t ep_addr, xfer_result_t result, uint32_t xferred_bytes);
+bool     cdcd_xfer_isr        (uint8_t rhport, uint8_t ep_addr, xfer_result_t result, uint32_t xferred_bytes);
+void     cdcd_sof_isr         (uint8_t rhport, uint32_t frame_count);
 
 #ifdef __cplusplus
  }
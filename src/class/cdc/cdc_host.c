@@ -94,6 +94,22 @@ typedef struct {
     uint8_t tx_ff_buf[CFG_TUH_CDC_TX_BUFSIZE];
     uint8_t rx_ff_buf[CFG_TUH_CDC_RX_BUFSIZE];
   } stream;
+
+  tuh_cdc_rx_stats_t rx_stats;
+
+  #if CFG_TUH_CDC_RX_EP_BUFCOUNT > 1
+  // RX endpoint buffers, only modified in usbh task. Buffers are filled in ring order and moved to FIFO starting from
+  // head, transfer in progress receives into buffer (head + count)
+  struct {
+    uint16_t len[CFG_TUH_CDC_RX_EP_BUFCOUNT]; // bytes not yet moved to FIFO
+    uint16_t ofs[CFG_TUH_CDC_RX_EP_BUFCOUNT]; // offset of these bytes in buffer
+    volatile uint32_t pending; // total bytes not yet moved to FIFO
+    uint8_t head;              // oldest filled buffer
+    uint8_t count;             // number of filled buffers
+    volatile bool service_queued; // rx_ring_service() is deferred to usbh task
+    volatile bool discard;        // drop filled buffers, requested by tuh_cdc_read_clear()
+  } rx_ring;
+  #endif
 } cdch_interface_t;
 
 typedef struct {
@@ -104,6 +120,13 @@ typedef struct {
 static cdch_interface_t cdch_data[CFG_TUH_CDC];
 CFG_TUH_MEM_SECTION static cdch_epbuf_t cdch_epbuf[CFG_TUH_CDC];
 
+#if CFG_TUH_CDC_RX_EP_BUFCOUNT > 1
+// additional RX buffers, buffer 0 is cdch_epbuf[].rx
+CFG_TUH_MEM_SECTION static struct {
+  TUH_EPBUF_DEF(buf, CFG_TUH_CDC_RX_EPSIZE);
+} cdch_epbuf_rx_extra[CFG_TUH_CDC][CFG_TUH_CDC_RX_EP_BUFCOUNT - 1];
+#endif
+
 //--------------------------------------------------------------------+
 // Serial Driver
 //--------------------------------------------------------------------+
@@ -375,6 +398,81 @@ static cdch_interface_t* get_itf_by_xfer(const tuh_xfer_t * xfer) {
   return NULL;
 }
 
+//--------------------------------------------------------------------+
+// RX endpoint buffer ring
+//--------------------------------------------------------------------+
+#if CFG_TUH_CDC_RX_EP_BUFCOUNT > 1
+static uint8_t *rx_ring_buf(cdch_interface_t *p_cdc, uint8_t i) {
+  const uint8_t idx = get_idx_by_ptr(p_cdc);
+  return (i == 0) ? cdch_epbuf[idx].rx : cdch_epbuf_rx_extra[idx][i - 1].buf;
+}
+
+// Start receiving into the buffer after filled ones if there is a free one. Return number of bytes to receive
+static uint32_t rx_ring_xfer(cdch_interface_t *p_cdc) {
+  TU_VERIFY(p_cdc->rx_ring.count < CFG_TUH_CDC_RX_EP_BUFCOUNT, 0);
+  const uint8_t i = (p_cdc->rx_ring.head + p_cdc->rx_ring.count) % CFG_TUH_CDC_RX_EP_BUFCOUNT;
+  // same buffer as transfer in progress if any, in which case no transfer is started
+  p_cdc->stream.rx.ep_buf = rx_ring_buf(p_cdc, i);
+  return tu_edpt_stream_read_xfer(&p_cdc->stream.rx);
+}
+
+// Buffer of transfer in progress is filled with len bytes of data at ofs
+static void rx_ring_xfer_complete(cdch_interface_t *p_cdc, uint16_t ofs, uint16_t len) {
+  const uint8_t i = (p_cdc->rx_ring.head + p_cdc->rx_ring.count) % CFG_TUH_CDC_RX_EP_BUFCOUNT;
+  p_cdc->rx_ring.ofs[i] = ofs;
+  p_cdc->rx_ring.len[i] = len;
+  p_cdc->rx_ring.count++;
+  p_cdc->rx_ring.pending += len;
+}
+
+// Move filled buffers to FIFO in order, until FIFO is full. Return number of bytes moved
+static uint32_t rx_ring_drain(cdch_interface_t *p_cdc) {
+  uint32_t total = 0;
+  while (p_cdc->rx_ring.count > 0) {
+    const uint8_t  i     = p_cdc->rx_ring.head;
+    const uint16_t count = tu_fifo_write_n(&p_cdc->stream.rx.ff, rx_ring_buf(p_cdc, i) + p_cdc->rx_ring.ofs[i],
+                                           p_cdc->rx_ring.len[i]);
+    p_cdc->rx_ring.ofs[i] += count;
+    p_cdc->rx_ring.len[i] -= count;
+    total += count;
+    if (p_cdc->rx_ring.len[i] > 0) {
+      break; // FIFO is full
+    }
+    p_cdc->rx_ring.head = (uint8_t)((p_cdc->rx_ring.head + 1) % CFG_TUH_CDC_RX_EP_BUFCOUNT);
+    p_cdc->rx_ring.count--;
+  }
+  p_cdc->rx_ring.pending -= total;
+  return total;
+}
+
+// Deferred to usbh task by read API: move filled buffers to FIFO and resume reception
+static void rx_ring_service(void *param) {
+  cdch_interface_t *p_cdc = (cdch_interface_t *)param;
+  p_cdc->rx_ring.service_queued = false;
+  TU_VERIFY(p_cdc->mounted,);
+
+  if (p_cdc->rx_ring.discard) {
+    // keep index of transfer in progress
+    p_cdc->rx_ring.discard = false;
+    p_cdc->rx_ring.head    = (uint8_t)((p_cdc->rx_ring.head + p_cdc->rx_ring.count) % CFG_TUH_CDC_RX_EP_BUFCOUNT);
+    p_cdc->rx_ring.count   = 0;
+    p_cdc->rx_ring.pending = 0;
+  }
+
+  if (rx_ring_drain(p_cdc) > 0) {
+    tuh_cdc_rx_cb(get_idx_by_ptr(p_cdc));
+  }
+  (void)rx_ring_xfer(p_cdc);
+}
+
+static void rx_ring_queue_service(cdch_interface_t *p_cdc) {
+  if (!p_cdc->rx_ring.service_queued) {
+    p_cdc->rx_ring.service_queued = true;
+    usbh_defer_func(rx_ring_service, p_cdc, false);
+  }
+}
+#endif
+
 static cdch_interface_t * make_new_itf(uint8_t daddr, tusb_desc_interface_t const * itf_desc) {
   for(uint8_t i=0; i<CFG_TUH_CDC; i++) {
     if (cdch_data[i].daddr == 0) {
@@ -501,13 +599,26 @@ uint32_t tuh_cdc_write_available(uint8_t idx) {
 uint32_t tuh_cdc_read (uint8_t idx, void * buffer, uint32_t bufsize) {
   cdch_interface_t * p_cdc = get_itf(idx);
   TU_VERIFY(p_cdc);
+  #if CFG_TUH_CDC_RX_EP_BUFCOUNT > 1
+  // buffers are moved to FIFO in usbh task, since reception may be in progress
+  const uint32_t count = tu_fifo_read_n(&p_cdc->stream.rx.ff, buffer, (uint16_t)tu_min32(bufsize, UINT16_MAX));
+  if (p_cdc->rx_ring.pending > 0) {
+    rx_ring_queue_service(p_cdc);
+  }
+  return count;
+  #else
   return tu_edpt_stream_read(&p_cdc->stream.rx, buffer, bufsize);
+  #endif
 }
 
 uint32_t tuh_cdc_read_available(uint8_t idx) {
   cdch_interface_t * p_cdc = get_itf(idx);
   TU_VERIFY(p_cdc);
+  #if CFG_TUH_CDC_RX_EP_BUFCOUNT > 1
+  return tu_fifo_count(&p_cdc->stream.rx.ff) + p_cdc->rx_ring.pending;
+  #else
   return tu_edpt_stream_read_available(&p_cdc->stream.rx);
+  #endif
 }
 
 bool tuh_cdc_peek(uint8_t idx, uint8_t * ch) {
@@ -521,7 +632,26 @@ bool tuh_cdc_read_clear (uint8_t idx) {
   TU_VERIFY(p_cdc);
 
   tu_edpt_stream_clear(&p_cdc->stream.rx);
+  #if CFG_TUH_CDC_RX_EP_BUFCOUNT > 1
+  p_cdc->rx_ring.discard = true;
+  rx_ring_queue_service(p_cdc);
+  #else
   (void)tu_edpt_stream_read_xfer(&p_cdc->stream.rx);
+  #endif
+  return true;
+}
+
+bool tuh_cdc_rx_stats_get(uint8_t idx, tuh_cdc_rx_stats_t *stats) {
+  cdch_interface_t * p_cdc = get_itf(idx);
+  TU_VERIFY(p_cdc && stats);
+  *stats = p_cdc->rx_stats;
+  return true;
+}
+
+bool tuh_cdc_rx_stats_reset(uint8_t idx) {
+  cdch_interface_t * p_cdc = get_itf(idx);
+  TU_VERIFY(p_cdc);
+  tu_memclr(&p_cdc->rx_stats, sizeof(tuh_cdc_rx_stats_t));
   return true;
 }
 
@@ -680,6 +810,10 @@ void cdch_close(uint8_t daddr) {
       p_cdc->mounted = false;
       tu_edpt_stream_close(&p_cdc->stream.tx);
       tu_edpt_stream_close(&p_cdc->stream.rx);
+      tu_memclr(&p_cdc->rx_stats, sizeof(tuh_cdc_rx_stats_t));
+      #if CFG_TUH_CDC_RX_EP_BUFCOUNT > 1
+      tu_memclr(&p_cdc->rx_ring, sizeof(p_cdc->rx_ring));
+      #endif
     }
   }
 }
@@ -701,24 +835,43 @@ bool cdch_xfer_cb(uint8_t daddr, uint8_t ep_addr, xfer_result_t event, uint32_t
       (void)tu_edpt_stream_write_zlp_if_needed(&p_cdc->stream.tx, xferred_bytes);
     }
   } else if (ep_addr == p_cdc->stream.rx.ep_addr) {
+    uint16_t ofs = 0; // offset of data in ep_buf, which is the buffer of completed transfer
     #if CFG_TUH_CDC_FTDI
     if (p_cdc->serial_drid == SERIAL_DRIVER_FTDI) {
-      // FTDI reserve 2 bytes for status
-      // uint8_t status[2] = {p_cdc->stream.rx.ep_buf[0], p_cdc->stream.rx.ep_buf[1]};
-      if (xferred_bytes > 2) {
-        tu_edpt_stream_read_xfer_complete_with_buf(&p_cdc->stream.rx, p_cdc->stream.rx.ep_buf + 2, xferred_bytes - 2);
-
-        tuh_cdc_rx_cb(idx); // invoke receive callback
+      // FTDI reserve 2 bytes for status: modem status, line status
+      if (xferred_bytes >= 2 && (p_cdc->stream.rx.ep_buf[1] & FTDI_RS_OE)) {
+        p_cdc->rx_stats.rx_overrun_count++;
       }
-    } else
+      ofs = (uint16_t)tu_min32(xferred_bytes, 2);
+    }
     #endif
-    {
-      tu_edpt_stream_read_xfer_complete(&p_cdc->stream.rx, xferred_bytes);
+    const uint16_t len = (uint16_t)(xferred_bytes - ofs);
+    p_cdc->rx_stats.rx_bytes += len;
+
+    #if CFG_TUH_CDC_RX_EP_BUFCOUNT > 1
+    // start next transfer before processing received data to keep polling device
+    rx_ring_xfer_complete(p_cdc, ofs, len);
+    uint32_t xfer_count = rx_ring_xfer(p_cdc);
+    (void)rx_ring_drain(p_cdc);
+    if (xfer_count == 0) {
+      xfer_count = rx_ring_xfer(p_cdc); // all buffers were filled, try again after moving them to FIFO
+    }
+    if (len > 0) {
+      tuh_cdc_rx_cb(idx); // invoke receive callback
+    }
+    #else
+    if (len > 0) {
+      tu_edpt_stream_read_xfer_complete_with_buf(&p_cdc->stream.rx, p_cdc->stream.rx.ep_buf + ofs, len);
       tuh_cdc_rx_cb(idx); // invoke receive callback
     }
 
     // prepare for next transfer if needed
-    tu_edpt_stream_read_xfer(&p_cdc->stream.rx);
+    const uint32_t xfer_count = tu_edpt_stream_read_xfer(&p_cdc->stream.rx);
+    #endif
+
+    if (xfer_count == 0 && !usbh_edpt_busy(daddr, ep_addr)) {
+      p_cdc->rx_stats.rx_full_count++; // resumed by tuh_cdc_read()
+    }
   } else if (ep_addr == p_cdc->ep_notif) {
     // TODO handle notification endpoint
   } else {
@@ -782,7 +935,11 @@ static void set_config_complete(cdch_interface_t *p_cdc, bool success) {
     p_cdc->mounted    = true;
     tuh_cdc_mount_cb(idx);
     // Prepare for incoming data
+    #if CFG_TUH_CDC_RX_EP_BUFCOUNT > 1
+    (void)rx_ring_xfer(p_cdc);
+    #else
     tu_edpt_stream_read_xfer(&p_cdc->stream.rx);
+    #endif
   } else {
     // clear the interface entry
     p_cdc->daddr            = 0;
@@ -47,6 +47,17 @@ extern "C" {
   #define CFG_TUH_CDC_RX_EPSIZE TUH_EPSIZE_BULK_MAX
 #endif
 
+// Number of RX endpoint buffers (CFG_TUH_CDC_RX_EPSIZE each). Host controllers run one transfer per endpoint at a
+// time, so with 2 or more buffers the next IN transfer is started into a free buffer as soon as one completes, before
+// received data is copied to RX FIFO and tuh_cdc_rx_cb() is invoked. Data that does not fit into RX FIFO is kept in its
+// buffer while reception continues into the remaining ones.
+#ifndef CFG_TUH_CDC_RX_EP_BUFCOUNT
+  #define CFG_TUH_CDC_RX_EP_BUFCOUNT 1
+#endif
+
+TU_VERIFY_STATIC(CFG_TUH_CDC_RX_EP_BUFCOUNT >= 1 && CFG_TUH_CDC_RX_EP_BUFCOUNT <= 8,
+                 "CFG_TUH_CDC_RX_EP_BUFCOUNT must be 1-8");
+
 // TX FIFO size
 #ifndef CFG_TUH_CDC_TX_BUFSIZE
   #define CFG_TUH_CDC_TX_BUFSIZE TUH_EPSIZE_BULK_MAX
@@ -136,6 +147,19 @@ bool tuh_cdc_peek(uint8_t idx, uint8_t *ch);
 // Clear the received FIFO
 bool tuh_cdc_read_clear(uint8_t idx);
 
+typedef struct {
+  uint32_t rx_bytes;         // received data bytes, not including FTDI status bytes
+  uint32_t rx_full_count;    // times reception is paused since RX FIFO and endpoint buffers are full. Meanwhile data
+                             // is buffered by device, which can only hold a few ms worth at high baudrates
+  uint32_t rx_overrun_count; // transfers with receive overrun reported by device (FTDI), data was lost on device
+} tuh_cdc_rx_stats_t;
+
+// Get receive statistics, counters are cleared when interface is closed
+bool tuh_cdc_rx_stats_get(uint8_t idx, tuh_cdc_rx_stats_t *stats);
+
+// Reset receive statistics
+bool tuh_cdc_rx_stats_reset(uint8_t idx);
+
 //--------------------------------------------------------------------+
 // Control Request API
 // Each Function will make a USB control transfer request to/from device
@@ -427,6 +427,9 @@ void midid_init(void) {
 
     tu_edpt_stream_init(&p_midi->ep_stream.rx, false, false, false, p_midi->ep_stream.rx_ff_buf,
                         CFG_TUD_MIDI_RX_BUFSIZE, epout_buf);
+  #if CFG_TUD_MIDI_RX_STAGED
+    tu_edpt_stream_set_staged(&p_midi->ep_stream.rx, true); // keep receiving while application is slow to read
+  #endif
 
     tu_edpt_stream_init(&p_midi->ep_stream.tx, false, true, false, p_midi->ep_stream.tx_ff_buf, CFG_TUD_MIDI_TX_BUFSIZE,
                         epin_buf);
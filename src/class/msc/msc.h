@@ -120,8 +120,17 @@ typedef enum {
   SCSI_CMD_READ_FORMAT_CAPACITY         = 0x23, ///< The command allows the Host to request a list of the possible format capacities for an installed writable media. This command also has the capability to report the writable capacity for a media when it is installed
   SCSI_CMD_READ_10                      = 0x28, ///< The READ (10) command requests that the device server read the specified logical block(s) and transfer them to the data-in buffer.
   SCSI_CMD_WRITE_10                     = 0x2A, ///< The WRITE (10) command requests that the device server transfer the specified logical block(s) from the data-out buffer and write them.
+  SCSI_CMD_SYNCHRONIZE_CACHE_10         = 0x35, ///< The SYNCHRONIZE CACHE (10) command requests that the device server write cached logical block(s) to the medium.
+  SCSI_CMD_READ_16                      = 0x88, ///< The READ (16) command is the 64-bit LBA and 32-bit block count variant of READ (10), required for device larger than 2 TiB.
+  SCSI_CMD_WRITE_16                     = 0x8A, ///< The WRITE (16) command is the 64-bit LBA and 32-bit block count variant of WRITE (10), required for device larger than 2 TiB.
+  SCSI_CMD_SERVICE_ACTION_IN_16         = 0x9E, ///< SERVICE ACTION IN (16), with service action \ref SCSI_SERVICE_ACTION_READ_CAPACITY_16 it is the READ CAPACITY (16) command.
 }scsi_cmd_type_t;
 
+/// SCSI Service Action for \ref SCSI_CMD_SERVICE_ACTION_IN_16
+enum {
+  SCSI_SERVICE_ACTION_READ_CAPACITY_16 = 0x10, ///< Used to obtain capacity of device with more than 2^32 - 1 blocks.
+};
+
 /// SCSI Sense Key
 typedef enum {
   SCSI_SENSE_NONE            = 0x00, ///< no specific Sense Key. This would be the case for a successful command
@@ -394,6 +403,45 @@ typedef struct TU_ATTR_PACKED
 TU_VERIFY_STATIC(sizeof(scsi_read10_t) == 10, "size is not correct");
 TU_VERIFY_STATIC(sizeof(scsi_write10_t) == 10, "size is not correct");
 
+/// SCSI Read Capacity 16 Command: Service Action In (16) with Read Capacity (16) service action
+typedef struct TU_ATTR_PACKED
+{
+  uint8_t  cmd_code       ; ///< SCSI OpCode for \ref SCSI_CMD_SERVICE_ACTION_IN_16
+  uint8_t  service_action ; ///< \ref SCSI_SERVICE_ACTION_READ_CAPACITY_16
+  uint32_t lba_hi         ; ///< Upper 32 bits of the Logical Block Address, obsolete
+  uint32_t lba_lo         ; ///< Lower 32 bits of the Logical Block Address, obsolete
+  uint32_t alloc_length   ; ///< Allocation length of response data
+  uint8_t  reserved       ;
+  uint8_t  control        ;
+} scsi_read_capacity16_t;
+
+TU_VERIFY_STATIC(sizeof(scsi_read_capacity16_t) == 16, "size is not correct");
+
+/// SCSI Read Capacity 16 Response Data
+typedef struct {
+  uint32_t last_lba_hi ; ///< Upper 32 bits of the last Logical Block Address of the device
+  uint32_t last_lba_lo ; ///< Lower 32 bits of the last Logical Block Address of the device
+  uint32_t block_size  ; ///< Block size in bytes
+  uint8_t  reserved[20];
+} scsi_read_capacity16_resp_t;
+
+TU_VERIFY_STATIC(sizeof(scsi_read_capacity16_resp_t) == 32, "size is not correct");
+
+/// SCSI Read 16 Command
+typedef struct TU_ATTR_PACKED
+{
+  uint8_t  cmd_code    ; ///< SCSI OpCode
+  uint8_t  reserved    ;
+  uint32_t lba_hi      ; ///< Upper 32 bits of the first Logical Block Address (LBA) accessed by this command
+  uint32_t lba_lo      ; ///< Lower 32 bits of the first Logical Block Address (LBA) accessed by this command
+  uint32_t block_count ; ///< Number of Blocks used by this command
+  uint8_t  reserved2   ;
+  uint8_t  control     ;
+} scsi_read16_t, scsi_write16_t;
+
+TU_VERIFY_STATIC(sizeof(scsi_read16_t) == 16, "size is not correct");
+TU_VERIFY_STATIC(sizeof(scsi_write16_t) == 16, "size is not correct");
+
 #ifdef __cplusplus
  }
 #endif
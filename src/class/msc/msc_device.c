@@ -51,6 +51,14 @@ TU_ATTR_WEAK uint32_t tud_msc_inquiry2_cb(uint8_t lun, scsi_inquiry_resp_t *inqu
   (void) lun; (void) inquiry_resp; (void) bufsize;
   return 0;
 }
+TU_ATTR_WEAK void* tud_msc_read10_mem_cb(uint8_t lun, uint32_t lba, uint32_t offset, uint32_t* bufsize) {
+  (void) lun; (void) lba; (void) offset; (void) bufsize;
+  return NULL;
+}
+TU_ATTR_WEAK void* tud_msc_write10_mem_cb(uint8_t lun, uint32_t lba, uint32_t offset, uint32_t* bufsize) {
+  (void) lun; (void) lba; (void) offset; (void) bufsize;
+  return NULL;
+}
 
 //--------------------------------------------------------------------+
 // MACRO CONSTANT TYPEDEF
@@ -84,6 +92,20 @@ typedef struct {
   uint8_t add_sense_qualifier;
 
   bool pending_io; // pending async IO
+  bool mem_xfer;   // READ10/WRITE10 data is transferred directly from/to application memory
+
+#if CFG_TUD_MSC_EP_BUFCOUNT > 1
+  // READ10/WRITE10 pipeline: buffers are filled in ring order and drained starting from buf_head
+  // - READ10 : storage fills buffers, which are then sent to host
+  // - WRITE10: host data is received into buffers, which are then committed to storage
+  uint32_t io_len;    // READ10: bytes read from storage so far, WRITE10: bytes received from host so far
+  uint16_t buf_len[CFG_TUD_MSC_EP_BUFCOUNT]; // data length of filled buffers
+  uint16_t buf_off;   // WRITE10: bytes of buf_head already committed to storage
+  uint8_t  buf_head;  // oldest filled buffer
+  uint8_t  buf_count; // number of filled buffers
+  bool     xfer_busy; // READ10: buf_head is being sent to host, WRITE10: receiving into buffer after the filled ones
+  bool     io_failed; // storage read/write failed, fail the op once in-flight transfer is complete
+#endif
 }mscd_interface_t;
 
 static mscd_interface_t _mscd_itf;
@@ -94,16 +116,30 @@ CFG_TUD_MEM_SECTION static struct {
 
 TU_VERIFY_STATIC(CFG_TUD_MSC_EP_BUFSIZE >= 64, "CFG_TUD_MSC_EP_BUFSIZE must be at least 64");
 
+#if CFG_TUD_MSC_EP_BUFCOUNT > 1
+// additional buffers for READ10/WRITE10 pipeline, buffer 0 is _mscd_epbuf.buf
+CFG_TUD_MEM_SECTION static struct {
+  TUD_EPBUF_DEF(buf, CFG_TUD_MSC_EP_BUFSIZE);
+} _mscd_epbuf_extra[CFG_TUD_MSC_EP_BUFCOUNT - 1];
+
+TU_ATTR_ALWAYS_INLINE static inline uint8_t* get_epbuf(uint8_t idx) {
+  return (idx == 0) ? _mscd_epbuf.buf : _mscd_epbuf_extra[idx - 1].buf;
+}
+#endif
+
 //--------------------------------------------------------------------+
 // INTERNAL OBJECT & FUNCTION DECLARATION
 //--------------------------------------------------------------------+
 static int32_t proc_builtin_scsi(uint8_t lun, uint8_t const scsi_cmd[16], uint8_t* buffer, uint32_t bufsize);
 static void proc_read10_cmd(mscd_interface_t* p_msc);
 static void proc_read_io_data(mscd_interface_t* p_msc, int32_t nbytes);
+static void proc_read10_xfer_done(mscd_interface_t* p_msc, uint32_t xferred_bytes);
 static void proc_write10_cmd(mscd_interface_t* p_msc);
 static void proc_write10_host_data(mscd_interface_t* p_msc, uint32_t xferred_bytes);
 static void proc_write_io_data(mscd_interface_t* p_msc, uint32_t xferred_bytes, int32_t nbytes);
 static bool proc_stage_status(mscd_interface_t* p_msc);
+static bool rdwr10_mem_xfer(mscd_interface_t* p_msc);
+static void rdwr10_mem_xfer_done(mscd_interface_t* p_msc, uint32_t xferred_bytes);
 
 TU_ATTR_ALWAYS_INLINE static inline bool is_data_in(uint8_t dir) {
   return tu_bit_test(dir, 7);
@@ -509,6 +545,15 @@ bool mscd_xfer_cb(uint8_t rhport, uint8_t ep_addr, xfer_result_t event, uint32_t
       p_msc->stage = MSC_STAGE_DATA;
       p_msc->total_len = p_cbw->total_bytes;
       p_msc->xferred_len = 0;
+      p_msc->mem_xfer = false;
+      #if CFG_TUD_MSC_EP_BUFCOUNT > 1
+      p_msc->io_len    = 0;
+      p_msc->buf_off   = 0;
+      p_msc->buf_head  = 0;
+      p_msc->buf_count = 0;
+      p_msc->xfer_busy = false;
+      p_msc->io_failed = false;
+      #endif
 
       // Read10 or Write10
       if ((SCSI_CMD_READ_10 == p_cbw->command[0]) || (SCSI_CMD_WRITE_10 == p_cbw->command[0])) {
@@ -518,7 +563,9 @@ bool mscd_xfer_cb(uint8_t rhport, uint8_t ep_addr, xfer_result_t event, uint32_t
           fail_scsi_op(p_msc, status);
         } else if (p_cbw->total_bytes > 0) {
           if (SCSI_CMD_READ_10 == p_cbw->command[0]) {
-            proc_read10_cmd(p_msc);
+            if (!rdwr10_mem_xfer(p_msc)) {
+              proc_read10_cmd(p_msc);
+            }
           } else {
             proc_write10_cmd(p_msc);
           }
@@ -579,18 +626,16 @@ bool mscd_xfer_cb(uint8_t rhport, uint8_t ep_addr, xfer_result_t event, uint32_t
 
     case MSC_STAGE_DATA:
       TU_LOG_DRV("  SCSI Data [Lun%u]\r\n", p_cbw->lun);
+      if (p_msc->mem_xfer) {
+        rdwr10_mem_xfer_done(p_msc, xferred_bytes);
+        break;
+      }
+
       TU_ASSERT(xferred_bytes <= CFG_TUD_MSC_EP_BUFSIZE); // sanity check to avoid buffer overflow
       // TU_LOG_MEM(CFG_TUD_MSC_LOG_LEVEL, _mscd_epbuf.buf, xferred_bytes, 2);
 
       if (SCSI_CMD_READ_10 == p_cbw->command[0]) {
-        p_msc->xferred_len += xferred_bytes;
-
-        if ( p_msc->xferred_len >= p_msc->total_len ) {
-          // Data Stage is complete
-          p_msc->stage = MSC_STAGE_STATUS;
-        }else {
-          proc_read10_cmd(p_msc);
-        }
+        proc_read10_xfer_done(p_msc, xferred_bytes);
       } else if (SCSI_CMD_WRITE_10 == p_cbw->command[0]) {
         proc_write10_host_data(p_msc, xferred_bytes);
       } else {
@@ -848,6 +893,154 @@ static int32_t proc_builtin_scsi(uint8_t lun, uint8_t const scsi_cmd[16], uint8_
   return resplen;
 }
 
+// Zero-copy READ10/WRITE10: queue transfer directly from/to application memory.
+// Return false if application does not provide memory for current position, the op is failed if the transfer
+// cannot be queued.
+static bool rdwr10_mem_xfer(mscd_interface_t* p_msc) {
+  msc_cbw_t const* p_cbw = &p_msc->cbw;
+  uint16_t const block_sz = rdwr10_get_blocksize(p_cbw); // already verified non-zero
+  TU_VERIFY(block_sz != 0);
+
+  uint32_t const lba = rdwr10_get_lba(p_cbw->command) + (p_msc->xferred_len / block_sz);
+  uint32_t const offset = p_msc->xferred_len % block_sz;
+  uint32_t const remain = p_cbw->total_bytes - p_msc->xferred_len;
+
+  // transfer length is 16-bit, keep it multiple of block size (therefore of packet size) unless it is the last one
+  uint32_t const max_len = tu_min32(remain, (UINT16_MAX / block_sz) * block_sz);
+  uint32_t len = max_len;
+
+  bool const is_read = (SCSI_CMD_READ_10 == p_cbw->command[0]);
+  uint8_t* mem = (uint8_t*) (is_read ? tud_msc_read10_mem_cb(p_cbw->lun, lba, offset, &len)
+                                     : tud_msc_write10_mem_cb(p_cbw->lun, lba, offset, &len));
+
+  p_msc->mem_xfer = (mem != NULL) && (len > 0) && (len <= max_len) && (len == remain || (len % block_sz) == 0);
+  TU_VERIFY(p_msc->mem_xfer);
+
+  if (!usbd_edpt_xfer(p_msc->rhport, is_read ? p_msc->ep_in : p_msc->ep_out, mem, (uint16_t) len, false)) {
+    TU_LOG_DRV("  mem xfer failed\r\n");
+    p_msc->mem_xfer = false;
+    fail_scsi_op(p_msc, MSC_CSW_STATUS_FAILED);
+  }
+  return true;
+}
+
+static void rdwr10_mem_xfer_done(mscd_interface_t* p_msc, uint32_t xferred_bytes) {
+  p_msc->xferred_len += xferred_bytes;
+
+  if (p_msc->xferred_len >= p_msc->total_len) {
+    // Data Stage is complete
+    p_msc->stage = MSC_STAGE_STATUS;
+  } else if (!rdwr10_mem_xfer(p_msc)) {
+    // no memory for the rest: continue with read10/write10 callbacks
+    #if CFG_TUD_MSC_EP_BUFCOUNT > 1
+    p_msc->io_len = p_msc->xferred_len;
+    #endif
+
+    if (SCSI_CMD_READ_10 == p_msc->cbw.command[0]) {
+      proc_read10_cmd(p_msc);
+    } else {
+      proc_write10_cmd(p_msc);
+    }
+  }
+}
+
+#if CFG_TUD_MSC_EP_BUFCOUNT > 1
+// READ10 pipeline: process result of a storage read, return true if a buffer is filled
+static bool read10_pipe_io_done(mscd_interface_t* p_msc, int32_t nbytes) {
+  if (nbytes > 0) {
+    const uint8_t idx = (p_msc->buf_head + p_msc->buf_count) % CFG_TUD_MSC_EP_BUFCOUNT;
+    p_msc->buf_len[idx] = (uint16_t) nbytes;
+    p_msc->io_len += (uint32_t) nbytes;
+    p_msc->buf_count++;
+    return true;
+  }
+
+  switch (nbytes) {
+    case TUD_MSC_RET_ERROR:
+      TU_LOG_DRV("  IO read() failed\r\n");
+      p_msc->io_failed = true;
+      break;
+
+    case TUD_MSC_RET_BUSY:
+      // not ready yet: retry when in-flight transfer completes, or fake a transfer complete if there is none
+      if (!p_msc->xfer_busy) {
+        dcd_event_xfer_complete(p_msc->rhport, p_msc->ep_in, 0, XFER_RESULT_SUCCESS, false);
+      }
+      break;
+
+    default: break; // nothing to do
+  }
+  return false;
+}
+
+// READ10 pipeline: send oldest filled buffer to host and read next chunk into a free buffer
+static void proc_read10_cmd(mscd_interface_t* p_msc) {
+  msc_cbw_t const* p_cbw = &p_msc->cbw;
+  uint16_t const block_sz = rdwr10_get_blocksize(p_cbw); // already verified non-zero
+  TU_VERIFY(block_sz != 0, );
+
+  while (1) {
+    if (!p_msc->xfer_busy && p_msc->buf_count > 0) {
+      p_msc->xfer_busy = true;
+      TU_ASSERT(usbd_edpt_xfer(p_msc->rhport, p_msc->ep_in, get_epbuf(p_msc->buf_head),
+                               p_msc->buf_len[p_msc->buf_head], false),);
+    }
+
+    if (p_msc->io_failed) {
+      if (!p_msc->xfer_busy) {
+        set_sense_medium_not_present(p_cbw->lun);
+        fail_scsi_op(p_msc, MSC_CSW_STATUS_FAILED);
+      }
+      return;
+    }
+
+    if (p_msc->pending_io || p_msc->buf_count >= CFG_TUD_MSC_EP_BUFCOUNT || p_msc->io_len >= p_cbw->total_bytes) {
+      return;
+    }
+
+    // Adjust lba & offset with bytes read so far
+    uint32_t const lba = rdwr10_get_lba(p_cbw->command) + (p_msc->io_len / block_sz);
+    uint32_t const offset = p_msc->io_len % block_sz;
+    const uint8_t idx = (p_msc->buf_head + p_msc->buf_count) % CFG_TUD_MSC_EP_BUFCOUNT;
+    const uint32_t bufsize = tu_min32(CFG_TUD_MSC_EP_BUFSIZE, p_cbw->total_bytes - p_msc->io_len);
+
+    p_msc->pending_io = true;
+    const int32_t nbytes = tud_msc_read10_cb(p_cbw->lun, lba, offset, get_epbuf(idx), bufsize);
+    if (nbytes == TUD_MSC_RET_ASYNC) {
+      return; // continue in proc_read_io_data()
+    }
+    p_msc->pending_io = false;
+
+    if (!read10_pipe_io_done(p_msc, nbytes) && !p_msc->io_failed) {
+      return;
+    }
+  }
+}
+
+static void proc_read_io_data(mscd_interface_t* p_msc, int32_t nbytes) {
+  (void) read10_pipe_io_done(p_msc, nbytes);
+  proc_read10_cmd(p_msc);
+}
+
+static void proc_read10_xfer_done(mscd_interface_t* p_msc, uint32_t xferred_bytes) {
+  // transfer complete without xfer_busy is the fake one to retry busy storage
+  if (p_msc->xfer_busy) {
+    p_msc->xfer_busy = false;
+    p_msc->xferred_len += xferred_bytes;
+    p_msc->buf_head = (p_msc->buf_head + 1) % CFG_TUD_MSC_EP_BUFCOUNT;
+    p_msc->buf_count--;
+  }
+
+  if (p_msc->xferred_len >= p_msc->total_len) {
+    // Data Stage is complete
+    p_msc->stage = MSC_STAGE_STATUS;
+  } else {
+    proc_read10_cmd(p_msc);
+  }
+}
+
+#else
+
 static void proc_read10_cmd(mscd_interface_t* p_msc) {
   msc_cbw_t const* p_cbw = &p_msc->cbw;
   uint16_t const block_sz = rdwr10_get_blocksize(p_cbw); // already verified non-zero
@@ -891,6 +1084,109 @@ static void proc_read_io_data(mscd_interface_t* p_msc, int32_t nbytes) {
   }
 }
 
+static void proc_read10_xfer_done(mscd_interface_t* p_msc, uint32_t xferred_bytes) {
+  p_msc->xferred_len += xferred_bytes;
+
+  if (p_msc->xferred_len >= p_msc->total_len) {
+    // Data Stage is complete
+    p_msc->stage = MSC_STAGE_STATUS;
+  } else {
+    proc_read10_cmd(p_msc);
+  }
+}
+#endif
+
+#if CFG_TUD_MSC_EP_BUFCOUNT > 1
+// WRITE10 pipeline: fail the op after a storage write error, the endpoint must not be stalled while an OUT
+// transfer is still in-flight: it is then failed when that transfer completes
+static void write10_pipe_fail(mscd_interface_t* p_msc) {
+  if (!p_msc->xfer_busy) {
+    set_sense_medium_not_present(p_msc->cbw.lun);
+    fail_scsi_op(p_msc, MSC_CSW_STATUS_FAILED);
+  }
+}
+
+// WRITE10 pipeline: receive next chunk from host into a free buffer
+static void write10_pipe_receive(mscd_interface_t* p_msc) {
+  msc_cbw_t const* p_cbw = &p_msc->cbw;
+  if (p_msc->io_failed || p_msc->xfer_busy || p_msc->buf_count >= CFG_TUD_MSC_EP_BUFCOUNT ||
+      p_msc->io_len >= p_cbw->total_bytes) {
+    return;
+  }
+
+  const uint8_t idx = (p_msc->buf_head + p_msc->buf_count) % CFG_TUD_MSC_EP_BUFCOUNT;
+  const uint16_t nbytes = (uint16_t) tu_min32(CFG_TUD_MSC_EP_BUFSIZE, p_cbw->total_bytes - p_msc->io_len);
+  p_msc->xfer_busy = true;
+  TU_ASSERT(usbd_edpt_xfer(p_msc->rhport, p_msc->ep_out, get_epbuf(idx), nbytes, false),);
+}
+
+// WRITE10 pipeline: process result of a storage write, return true if buf_head is fully committed
+static bool write10_pipe_io_done(mscd_interface_t* p_msc, int32_t nbytes) {
+  if (nbytes < 0) {
+    if (nbytes == TUD_MSC_RET_ERROR) {
+      // IO error -> fail this scsi op once in-flight transfer is complete, residue only counts committed bytes
+      TU_LOG_DRV("  IO write() failed\r\n");
+      p_msc->io_failed = true;
+      write10_pipe_fail(p_msc);
+    }
+    return false;
+  }
+
+  const uint8_t idx = p_msc->buf_head;
+  const uint32_t left = (uint32_t) (p_msc->buf_len[idx] - p_msc->buf_off);
+  const uint32_t consumed = tu_min32((uint32_t) nbytes, left);
+  p_msc->xferred_len += consumed;
+
+  if (consumed < left) {
+    // Application consume less than what we got including TUD_MSC_RET_BUSY (0): retry when in-flight transfer
+    // completes, or fake a transfer complete if there is none
+    p_msc->buf_off = (uint16_t) (p_msc->buf_off + consumed);
+    if (!p_msc->xfer_busy) {
+      dcd_event_xfer_complete(p_msc->rhport, p_msc->ep_out, 0, XFER_RESULT_SUCCESS, false);
+    }
+    return false;
+  }
+
+  p_msc->buf_off = 0;
+  p_msc->buf_head = (p_msc->buf_head + 1) % CFG_TUD_MSC_EP_BUFCOUNT;
+  p_msc->buf_count--;
+
+  if (p_msc->xferred_len >= p_msc->total_len) {
+    // Data Stage is complete
+    p_msc->stage = MSC_STAGE_STATUS;
+    return false;
+  }
+
+  write10_pipe_receive(p_msc); // a buffer is freed
+  return true;
+}
+
+// WRITE10 pipeline: commit received buffers to storage
+static void write10_pipe_commit(mscd_interface_t* p_msc) {
+  msc_cbw_t const* p_cbw = &p_msc->cbw;
+  uint16_t const block_sz = rdwr10_get_blocksize(p_cbw); // already verified non-zero
+  TU_VERIFY(block_sz != 0, );
+
+  while (!p_msc->pending_io && p_msc->buf_count > 0) {
+    // Adjust lba & offset with committed bytes
+    uint32_t const lba = rdwr10_get_lba(p_cbw->command) + (p_msc->xferred_len / block_sz);
+    uint32_t const offset = p_msc->xferred_len % block_sz;
+    const uint8_t idx = p_msc->buf_head;
+
+    p_msc->pending_io = true;
+    const int32_t nbytes = tud_msc_write10_cb(p_cbw->lun, lba, offset, get_epbuf(idx) + p_msc->buf_off,
+                                              (uint32_t) (p_msc->buf_len[idx] - p_msc->buf_off));
+    if (nbytes == TUD_MSC_RET_ASYNC) {
+      return; // continue in proc_write_io_data()
+    }
+    p_msc->pending_io = false;
+
+    if (!write10_pipe_io_done(p_msc, nbytes)) {
+      return;
+    }
+  }
+}
+
 static void proc_write10_cmd(mscd_interface_t* p_msc) {
   msc_cbw_t const* p_cbw = &p_msc->cbw;
   const bool writable = tud_msc_is_writable_cb(p_cbw->lun);
@@ -903,6 +1199,62 @@ static void proc_write10_cmd(mscd_interface_t* p_msc) {
     return;
   }
 
+  // zero-copy if application provides memory, only tried at start of command
+  if (p_msc->xferred_len == 0 && rdwr10_mem_xfer(p_msc)) {
+    return;
+  }
+
+  write10_pipe_receive(p_msc);
+}
+
+// process new data arrived from WRITE10: keep receiving into next buffer while committing this one
+static void proc_write10_host_data(mscd_interface_t* p_msc, uint32_t xferred_bytes) {
+  // transfer complete without xfer_busy is the fake one to retry busy storage
+  if (p_msc->xfer_busy) {
+    const uint8_t idx = (p_msc->buf_head + p_msc->buf_count) % CFG_TUD_MSC_EP_BUFCOUNT;
+    p_msc->xfer_busy = false;
+
+    if (p_msc->io_failed) {
+      // storage write failed while this transfer was in-flight: drop its data
+      write10_pipe_fail(p_msc);
+      return;
+    }
+
+    p_msc->buf_len[idx] = (uint16_t) xferred_bytes;
+    p_msc->io_len += xferred_bytes;
+    p_msc->buf_count++;
+    write10_pipe_receive(p_msc);
+  }
+
+  write10_pipe_commit(p_msc);
+}
+
+static void proc_write_io_data(mscd_interface_t* p_msc, uint32_t xferred_bytes, int32_t nbytes) {
+  (void) xferred_bytes;
+  if (write10_pipe_io_done(p_msc, nbytes)) {
+    write10_pipe_commit(p_msc);
+  }
+}
+
+#else
+
+static void proc_write10_cmd(mscd_interface_t* p_msc) {
+  msc_cbw_t const* p_cbw = &p_msc->cbw;
+  const bool writable = tud_msc_is_writable_cb(p_cbw->lun);
+
+  if (!writable) {
+    // Not writable, complete this SCSI op with error
+    // Sense = Write protected
+    (void) tud_msc_set_sense(p_cbw->lun, SCSI_SENSE_DATA_PROTECT, 0x27, 0x00);
+    fail_scsi_op(p_msc, MSC_CSW_STATUS_FAILED);
+    return;
+  }
+
+  // zero-copy if application provides memory, only tried at start of command
+  if (p_msc->xferred_len == 0 && rdwr10_mem_xfer(p_msc)) {
+    return;
+  }
+
   // remaining bytes capped at class buffer
   uint16_t nbytes = (uint16_t)tu_min32(CFG_TUD_MSC_EP_BUFSIZE, p_cbw->total_bytes - p_msc->xferred_len);
   // Write10 callback will be called later when usb transfer complete
@@ -946,6 +1298,7 @@ static void proc_write_io_data(mscd_interface_t* p_msc, uint32_t xferred_bytes,
       const uint32_t left_over = xferred_bytes - (uint32_t)nbytes;
       if (nbytes > 0) {
         memmove(_mscd_epbuf.buf, _mscd_epbuf.buf + nbytes, left_over);
+        p_msc->xferred_len += (uint32_t) nbytes; // left over is written at the next offset
       }
 
       // fake a transfer complete with adjusted parameters --> callback will be invoked with adjusted parameters
@@ -964,5 +1317,6 @@ static void proc_write_io_data(mscd_interface_t* p_msc, uint32_t xferred_bytes,
     }
   }
 }
+#endif
 
 #endif
@@ -48,6 +48,15 @@
   #error CFG_TUD_MSC_EP_BUFSIZE must be defined, value of a block size should work well, the more the better
 #endif
 
+// Number of CFG_TUD_MSC_EP_BUFSIZE buffers. With 2 or more, READ10 and WRITE10 are pipelined:
+// - READ10 : next tud_msc_read10_cb() (or async read) is issued into a free buffer while previous chunk is being
+//            transferred to host
+// - WRITE10: next chunk is received from host into a free buffer while tud_msc_write10_cb() (or async write)
+//            commits the previous one
+#ifndef CFG_TUD_MSC_EP_BUFCOUNT
+  #define CFG_TUD_MSC_EP_BUFCOUNT 1
+#endif
+
 // Return value of callback functions
 enum {
   TUD_MSC_RET_BUSY = 0,   // Busy, e.g disk I/O is not ready
@@ -56,6 +65,7 @@ enum {
 };
 
 TU_VERIFY_STATIC(CFG_TUD_MSC_EP_BUFSIZE < UINT16_MAX, "Size is not correct");
+TU_VERIFY_STATIC(CFG_TUD_MSC_EP_BUFCOUNT >= 1 && CFG_TUD_MSC_EP_BUFCOUNT <= 8, "CFG_TUD_MSC_EP_BUFCOUNT must be 1-8");
 
 //--------------------------------------------------------------------+
 // Application API
@@ -86,10 +96,25 @@ bool tud_msc_async_io_done(int32_t bytes_io, bool in_isr);
     - TUD_MSC_RET_ASYNC
         Data I/O will be done asynchronously in a background task. Application should return immediately.
         tud_msc_async_io_done() must be called once IO/ is done to signal completion.
+  - With CFG_TUD_MSC_EP_BUFCOUNT > 1, read10 callback can be invoked while previous data is still being transferred
+    to host, and write10 callback while next data is being received. Each call may pass a different buffer.
+    There is at most one read/write in progress at a time.
 */
 int32_t tud_msc_read10_cb (uint8_t lun, uint32_t lba, uint32_t offset, void* buffer, uint32_t bufsize);
 int32_t tud_msc_write10_cb (uint8_t lun, uint32_t lba, uint32_t offset, uint8_t* buffer, uint32_t bufsize);
 
+/*
+  Optional zero-copy variant of read10/write10 callbacks for memory-mapped media e.g RAM disk or XIP flash.
+  - Return pointer to contents at lba * BLOCK_SIZE + offset which is transferred directly to (READ10) or from
+    (WRITE10) host, or NULL to use tud_msc_read10_cb()/tud_msc_write10_cb() for the rest of command.
+  - *bufsize is the requested length, which is not limited by CFG_TUD_MSC_EP_BUFSIZE. Application can reduce it
+    to a multiple of BLOCK_SIZE if memory is not contiguous, callback is invoked again for remaining data.
+  - Memory must be accessible by USB controller (DMA and alignment requirements of the port) and stay valid until
+    transfer is complete.
+*/
+void* tud_msc_read10_mem_cb(uint8_t lun, uint32_t lba, uint32_t offset, uint32_t* bufsize);
+void* tud_msc_write10_mem_cb(uint8_t lun, uint32_t lba, uint32_t offset, uint32_t* bufsize);
+
 // Invoked when received SCSI_CMD_INQUIRY, v1, application should use v2 if possible
 // Application fill vendor id, product id and revision with string up to 8, 16, 4 characters respectively
 void tud_msc_inquiry_cb(uint8_t lun, uint8_t vendor_id[8], uint8_t product_id[16], uint8_t product_rev[4]);
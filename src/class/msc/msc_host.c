@@ -43,6 +43,10 @@
 //--------------------------------------------------------------------+
 // MACRO CONSTANT TYPEDEF
 //--------------------------------------------------------------------+
+// Max bytes per endpoint transfer in data stage since transfer length is 16-bit, multiple of any bulk packet size.
+// Larger data stage is split into multiple transfers.
+#define MSCH_XFER_MAX  0xF000u
+
 enum {
   MSC_STAGE_IDLE = 0,
   MSC_STAGE_CMD,
@@ -50,6 +54,15 @@ enum {
   MSC_STAGE_STATUS,
 };
 
+#if CFG_TUH_MSC_QUEUE_DEPTH
+typedef struct {
+  msc_cbw_t cbw;
+  void* buffer;
+  tuh_msc_complete_cb_t complete_cb;
+  uintptr_t complete_arg;
+} msch_request_t;
+#endif
+
 typedef struct {
   uint8_t itf_num;
   uint8_t ep_in;
@@ -62,13 +75,21 @@ typedef struct {
   // SCSI command data
   uint8_t stage;
   void* buffer;
+  uint32_t xferred_len; // data stage bytes transferred so far
   tuh_msc_complete_cb_t complete_cb;
   uintptr_t complete_arg;
 
   struct {
     uint32_t block_size;
-    uint32_t block_count;
+    uint64_t block_count;
   } capacity[CFG_TUH_MSC_MAXLUN];
+
+  #if CFG_TUH_MSC_QUEUE_DEPTH
+  // commands waiting for current one to complete
+  msch_request_t queue[CFG_TUH_MSC_QUEUE_DEPTH];
+  uint8_t queue_rd;
+  uint8_t queue_count;
+  #endif
 } msch_interface_t;
 
 typedef struct {
@@ -107,6 +128,12 @@ uint8_t tuh_msc_get_maxlun(uint8_t dev_addr) {
 }
 
 uint32_t tuh_msc_get_block_count(uint8_t dev_addr, uint8_t lun) {
+  msch_interface_t* p_msc = get_itf(dev_addr);
+  const uint64_t block_count = p_msc->capacity[lun].block_count;
+  return (block_count > UINT32_MAX) ? UINT32_MAX : (uint32_t) block_count;
+}
+
+uint64_t tuh_msc_get_block_count64(uint8_t dev_addr, uint8_t lun) {
   msch_interface_t* p_msc = get_itf(dev_addr);
   return p_msc->capacity[lun].block_count;
 }
@@ -129,6 +156,16 @@ bool tuh_msc_ready(uint8_t dev_addr) {
   return !epin_busy && !epout_busy;
 }
 
+uint8_t tuh_msc_queue_count(uint8_t dev_addr) {
+  #if CFG_TUH_MSC_QUEUE_DEPTH
+  msch_interface_t* p_msc = get_itf(dev_addr);
+  return p_msc->queue_count;
+  #else
+  (void) dev_addr;
+  return 0;
+  #endif
+}
+
 //--------------------------------------------------------------------+
 // PUBLIC API: SCSI COMMAND
 //--------------------------------------------------------------------+
@@ -139,10 +176,9 @@ static inline void cbw_init(msc_cbw_t* cbw, uint8_t lun) {
   cbw->lun       = lun;
 }
 
-bool tuh_msc_scsi_command(uint8_t daddr, msc_cbw_t const* cbw, void* data,
-                          tuh_msc_complete_cb_t complete_cb, uintptr_t arg) {
+static bool scsi_command_start(uint8_t daddr, msc_cbw_t const* cbw, void* data,
+                               tuh_msc_complete_cb_t complete_cb, uintptr_t arg) {
   msch_interface_t* p_msc = get_itf(daddr);
-  TU_VERIFY(p_msc->configured);
 
   // claim endpoint
   TU_VERIFY(usbh_edpt_claim(daddr, p_msc->ep_out));
@@ -152,9 +188,11 @@ bool tuh_msc_scsi_command(uint8_t daddr, msc_cbw_t const* cbw, void* data,
   p_msc->buffer = data;
   p_msc->complete_cb = complete_cb;
   p_msc->complete_arg = arg;
+  p_msc->xferred_len = 0;
   p_msc->stage = MSC_STAGE_CMD;
 
   if (!usbh_edpt_xfer(daddr, p_msc->ep_out, (uint8_t*) &epbuf->cbw, sizeof(msc_cbw_t))) {
+    p_msc->stage = MSC_STAGE_IDLE;
     (void) usbh_edpt_release(daddr, p_msc->ep_out);
     return false;
   }
@@ -162,6 +200,67 @@ bool tuh_msc_scsi_command(uint8_t daddr, msc_cbw_t const* cbw, void* data,
   return true;
 }
 
+// Complete a command that is not (or no longer) executed by device with failed status
+static void scsi_command_fail(uint8_t daddr, msc_cbw_t const* cbw, uint32_t residue, void* buffer,
+                              tuh_msc_complete_cb_t complete_cb, uintptr_t arg) {
+  if (complete_cb != NULL) {
+    msc_csw_t const csw = {
+        .signature    = MSC_CSW_SIGNATURE,
+        .tag          = cbw->tag,
+        .data_residue = residue,
+        .status       = MSC_CSW_STATUS_FAILED
+    };
+    tuh_msc_complete_data_t const cb_data = {
+        .cbw = cbw,
+        .csw = &csw,
+        .scsi_data = buffer,
+        .user_arg = arg
+    };
+    (void) complete_cb(daddr, &cb_data);
+  }
+}
+
+#if CFG_TUH_MSC_QUEUE_DEPTH
+// Start queued commands, called when previous command is complete. A command that fails to start is completed
+// right away with failed status so that its submitter is not left waiting.
+static void scsi_queue_process(uint8_t daddr) {
+  msch_interface_t* p_msc = get_itf(daddr);
+
+  while (p_msc->stage == MSC_STAGE_IDLE && p_msc->queue_count > 0) {
+    msch_request_t const req = p_msc->queue[p_msc->queue_rd];
+    p_msc->queue_rd = (uint8_t) ((p_msc->queue_rd + 1) % CFG_TUH_MSC_QUEUE_DEPTH);
+    p_msc->queue_count--;
+
+    if (!scsi_command_start(daddr, &req.cbw, req.buffer, req.complete_cb, req.complete_arg)) {
+      scsi_command_fail(daddr, &req.cbw, req.cbw.total_bytes, req.buffer, req.complete_cb, req.complete_arg);
+    }
+  }
+}
+#endif
+
+bool tuh_msc_scsi_command(uint8_t daddr, msc_cbw_t const* cbw, void* data,
+                          tuh_msc_complete_cb_t complete_cb, uintptr_t arg) {
+  msch_interface_t* p_msc = get_itf(daddr);
+  TU_VERIFY(p_msc->configured);
+
+  #if CFG_TUH_MSC_QUEUE_DEPTH
+  if (p_msc->stage != MSC_STAGE_IDLE || p_msc->queue_count > 0) {
+    // busy: queue command, it is started once all previous ones are complete
+    TU_VERIFY(p_msc->queue_count < CFG_TUH_MSC_QUEUE_DEPTH);
+    const uint8_t idx = (uint8_t) ((p_msc->queue_rd + p_msc->queue_count) % CFG_TUH_MSC_QUEUE_DEPTH);
+    msch_request_t* req = &p_msc->queue[idx];
+    req->cbw          = *cbw;
+    req->buffer       = data;
+    req->complete_cb  = complete_cb;
+    req->complete_arg = arg;
+    p_msc->queue_count++;
+    return true;
+  }
+  #endif
+
+  return scsi_command_start(daddr, cbw, data, complete_cb, arg);
+}
+
 bool tuh_msc_read_capacity(uint8_t dev_addr, uint8_t lun, scsi_read_capacity10_resp_t* response,
                            tuh_msc_complete_cb_t complete_cb, uintptr_t arg) {
   msch_interface_t* p_msc = get_itf(dev_addr);
@@ -178,6 +277,28 @@ bool tuh_msc_read_capacity(uint8_t dev_addr, uint8_t lun, scsi_read_capacity10_r
   return tuh_msc_scsi_command(dev_addr, &cbw, response, complete_cb, arg);
 }
 
+bool tuh_msc_read_capacity16(uint8_t dev_addr, uint8_t lun, scsi_read_capacity16_resp_t* response,
+                             tuh_msc_complete_cb_t complete_cb, uintptr_t arg) {
+  msch_interface_t* p_msc = get_itf(dev_addr);
+  TU_VERIFY(p_msc->configured);
+
+  msc_cbw_t cbw;
+  cbw_init(&cbw, lun);
+
+  cbw.total_bytes = sizeof(scsi_read_capacity16_resp_t);
+  cbw.dir         = TUSB_DIR_IN_MASK;
+  cbw.cmd_len     = sizeof(scsi_read_capacity16_t);
+
+  scsi_read_capacity16_t const cmd_read_capacity16 = {
+      .cmd_code       = SCSI_CMD_SERVICE_ACTION_IN_16,
+      .service_action = SCSI_SERVICE_ACTION_READ_CAPACITY_16,
+      .alloc_length   = tu_htonl(sizeof(scsi_read_capacity16_resp_t))
+  };
+  memcpy(cbw.command, &cmd_read_capacity16, cbw.cmd_len); //-V1086
+
+  return tuh_msc_scsi_command(dev_addr, &cbw, response, complete_cb, arg);
+}
+
 bool tuh_msc_inquiry(uint8_t dev_addr, uint8_t lun, scsi_inquiry_resp_t* response,
                      tuh_msc_complete_cb_t complete_cb, uintptr_t arg) {
   msch_interface_t* p_msc = get_itf(dev_addr);
@@ -277,6 +398,58 @@ bool tuh_msc_write10(uint8_t dev_addr, uint8_t lun, void const* buffer, uint32_t
   return tuh_msc_scsi_command(dev_addr, &cbw, (void*) (uintptr_t) buffer, complete_cb, arg);
 }
 
+bool tuh_msc_read16(uint8_t dev_addr, uint8_t lun, void* buffer, uint64_t lba, uint32_t block_count,
+                    tuh_msc_complete_cb_t complete_cb, uintptr_t arg) {
+  msch_interface_t* p_msc = get_itf(dev_addr);
+  TU_VERIFY(p_msc->mounted);
+
+  const uint64_t total_bytes = (uint64_t) block_count * p_msc->capacity[lun].block_size;
+  TU_VERIFY(total_bytes <= UINT32_MAX);
+
+  msc_cbw_t cbw;
+  cbw_init(&cbw, lun);
+
+  cbw.total_bytes = (uint32_t) total_bytes;
+  cbw.dir         = TUSB_DIR_IN_MASK;
+  cbw.cmd_len     = sizeof(scsi_read16_t);
+
+  scsi_read16_t const cmd_read16 = {
+      .cmd_code    = SCSI_CMD_READ_16,
+      .lba_hi      = tu_htonl((uint32_t) (lba >> 32)),
+      .lba_lo      = tu_htonl((uint32_t) lba),
+      .block_count = tu_htonl(block_count)
+  };
+  memcpy(cbw.command, &cmd_read16, cbw.cmd_len); //-V1086
+
+  return tuh_msc_scsi_command(dev_addr, &cbw, buffer, complete_cb, arg);
+}
+
+bool tuh_msc_write16(uint8_t dev_addr, uint8_t lun, void const* buffer, uint64_t lba, uint32_t block_count,
+                     tuh_msc_complete_cb_t complete_cb, uintptr_t arg) {
+  msch_interface_t* p_msc = get_itf(dev_addr);
+  TU_VERIFY(p_msc->mounted);
+
+  const uint64_t total_bytes = (uint64_t) block_count * p_msc->capacity[lun].block_size;
+  TU_VERIFY(total_bytes <= UINT32_MAX);
+
+  msc_cbw_t cbw;
+  cbw_init(&cbw, lun);
+
+  cbw.total_bytes = (uint32_t) total_bytes;
+  cbw.dir         = TUSB_DIR_OUT;
+  cbw.cmd_len     = sizeof(scsi_write16_t);
+
+  scsi_write16_t const cmd_write16 = {
+      .cmd_code    = SCSI_CMD_WRITE_16,
+      .lba_hi      = tu_htonl((uint32_t) (lba >> 32)),
+      .lba_lo      = tu_htonl((uint32_t) lba),
+      .block_count = tu_htonl(block_count)
+  };
+  memcpy(cbw.command, &cmd_write16, cbw.cmd_len); //-V1086
+
+  return tuh_msc_scsi_command(dev_addr, &cbw, (void*) (uintptr_t) buffer, complete_cb, arg);
+}
+
 #if 0
 // MSC interface Reset (not used now)
 bool tuh_msc_reset(uint8_t dev_addr) {
@@ -316,6 +489,26 @@ void msch_close(uint8_t dev_addr) {
 
   TU_LOG_DRV("  MSCh close addr = %d\r\n", dev_addr);
 
+  // no new command can be submitted from complete callbacks below
+  p_msc->configured = false;
+
+  // complete in-flight and queued commands with failed status so that their submitters are not left waiting
+  if (p_msc->stage != MSC_STAGE_IDLE) {
+    msc_cbw_t const* cbw = &get_epbuf(dev_addr)->cbw;
+    p_msc->stage = MSC_STAGE_IDLE;
+    scsi_command_fail(dev_addr, cbw, cbw->total_bytes - p_msc->xferred_len, p_msc->buffer, p_msc->complete_cb,
+                      p_msc->complete_arg);
+  }
+
+  #if CFG_TUH_MSC_QUEUE_DEPTH
+  while (p_msc->queue_count > 0) {
+    msch_request_t const* req = &p_msc->queue[p_msc->queue_rd];
+    p_msc->queue_rd = (uint8_t) ((p_msc->queue_rd + 1) % CFG_TUH_MSC_QUEUE_DEPTH);
+    p_msc->queue_count--;
+    scsi_command_fail(dev_addr, &req->cbw, req->cbw.total_bytes, req->buffer, req->complete_cb, req->complete_arg);
+  }
+  #endif
+
   // invoke Application Callback
   if (p_msc->mounted) {
     tuh_msc_umount_cb(dev_addr);
@@ -324,6 +517,13 @@ void msch_close(uint8_t dev_addr) {
   tu_memclr(p_msc, sizeof(msch_interface_t));
 }
 
+// Queue next chunk of data stage. Data larger than a single endpoint transfer is split into multiple ones
+static bool data_stage_xfer(uint8_t dev_addr, msch_interface_t* p_msc, msc_cbw_t const* cbw) {
+  uint8_t const ep_data = (cbw->dir & TUSB_DIR_IN_MASK) ? p_msc->ep_in : p_msc->ep_out;
+  uint16_t const len = (uint16_t) tu_min32(cbw->total_bytes - p_msc->xferred_len, MSCH_XFER_MAX);
+  return usbh_edpt_xfer(dev_addr, ep_data, (uint8_t*) p_msc->buffer + p_msc->xferred_len, len);
+}
+
 bool msch_xfer_cb(uint8_t dev_addr, uint8_t ep_addr, xfer_result_t event, uint32_t xferred_bytes) {
   msch_interface_t* p_msc = get_itf(dev_addr);
   msch_epbuf_t* epbuf = get_epbuf(dev_addr);
@@ -334,16 +534,26 @@ bool msch_xfer_cb(uint8_t dev_addr, uint8_t ep_addr, xfer_result_t event, uint32
     case MSC_STAGE_CMD:
       // Must be Command Block
       TU_ASSERT(ep_addr == p_msc->ep_out && event == XFER_RESULT_SUCCESS && xferred_bytes == sizeof(msc_cbw_t));
+      p_msc->xferred_len = 0;
       if (cbw->total_bytes && p_msc->buffer) {
         // Data stage if any
         p_msc->stage = MSC_STAGE_DATA;
-        uint8_t const ep_data = (cbw->dir & TUSB_DIR_IN_MASK) ? p_msc->ep_in : p_msc->ep_out;
-        TU_ASSERT(usbh_edpt_xfer(dev_addr, ep_data, p_msc->buffer, (uint16_t) cbw->total_bytes));
+        TU_ASSERT(data_stage_xfer(dev_addr, p_msc, cbw));
         break;
       }
       TU_ATTR_FALLTHROUGH; // fallthrough to data stage
 
     case MSC_STAGE_DATA:
+      if (p_msc->stage == MSC_STAGE_DATA) {
+        // continue with next chunk unless device ends data stage early (short packet or error)
+        uint32_t const requested = tu_min32(cbw->total_bytes - p_msc->xferred_len, MSCH_XFER_MAX);
+        p_msc->xferred_len += xferred_bytes;
+        if (event == XFER_RESULT_SUCCESS && xferred_bytes == requested && p_msc->xferred_len < cbw->total_bytes) {
+          TU_ASSERT(data_stage_xfer(dev_addr, p_msc, cbw));
+          break;
+        }
+      }
+
       // Status stage
       p_msc->stage = MSC_STAGE_STATUS;
       TU_ASSERT(usbh_edpt_xfer(dev_addr, p_msc->ep_in, (uint8_t*) csw, (uint16_t) sizeof(msc_csw_t)));
@@ -361,6 +571,11 @@ bool msch_xfer_cb(uint8_t dev_addr, uint8_t ep_addr, xfer_result_t event, uint32
         };
         (void) p_msc->complete_cb(dev_addr, &cb_data);
       }
+
+      #if CFG_TUH_MSC_QUEUE_DEPTH
+      // send next CBW right away without waiting for application
+      scsi_queue_process(dev_addr);
+      #endif
       break;
 
     default:
@@ -378,6 +593,7 @@ static void config_get_maxlun_complete(tuh_xfer_t* xfer);
 static bool config_test_unit_ready_complete(uint8_t dev_addr, tuh_msc_complete_data_t const* cb_data);
 static bool config_request_sense_complete(uint8_t dev_addr, tuh_msc_complete_data_t const* cb_data);
 static bool config_read_capacity_complete(uint8_t dev_addr, tuh_msc_complete_data_t const* cb_data);
+static bool config_read_capacity16_complete(uint8_t dev_addr, tuh_msc_complete_data_t const* cb_data);
 
 uint16_t msch_open(uint8_t rhport, uint8_t dev_addr, const tusb_desc_interface_t *desc_itf, uint16_t max_len) {
   (void) rhport;
@@ -501,7 +717,38 @@ static bool config_read_capacity_complete(uint8_t dev_addr, tuh_msc_complete_dat
 
   // Capacity response field: Block size and Last LBA are both Big-Endian
   scsi_read_capacity10_resp_t* resp = (scsi_read_capacity10_resp_t*) (uintptr_t) enum_buf;
-  p_msc->capacity[cbw->lun].block_count = (uint32_t) (tu_ntohl(resp->last_lba) + 1u);
+  const uint32_t last_lba = tu_ntohl(resp->last_lba);
+  p_msc->capacity[cbw->lun].block_count = (uint64_t) last_lba + 1u;
+  p_msc->capacity[cbw->lun].block_size  = tu_ntohl(resp->block_size);
+
+  if (last_lba == UINT32_MAX) {
+    // device is too large for Read Capacity 10 e.g more than 2 TiB with 512-byte block
+    TU_LOG_DRV("SCSI Read Capacity 16\r\n");
+    TU_ASSERT(tuh_msc_read_capacity16(dev_addr, cbw->lun, (scsi_read_capacity16_resp_t*) (uintptr_t) enum_buf,
+                                      config_read_capacity16_complete, 0));
+    return true;
+  }
+
+  // Mark enumeration is complete
+  p_msc->mounted = true;
+  tuh_msc_mount_cb(dev_addr);
+
+  // notify usbh that driver enumeration is complete
+  usbh_driver_set_config_complete(dev_addr, p_msc->itf_num);
+
+  return true;
+}
+
+static bool config_read_capacity16_complete(uint8_t dev_addr, tuh_msc_complete_data_t const* cb_data) {
+  msc_cbw_t const* cbw = cb_data->cbw;
+  msc_csw_t const* csw = cb_data->csw;
+  TU_ASSERT(csw->status == 0);
+  msch_interface_t* p_msc = get_itf(dev_addr);
+  uint8_t* enum_buf = usbh_get_enum_buf();
+
+  scsi_read_capacity16_resp_t* resp = (scsi_read_capacity16_resp_t*) (uintptr_t) enum_buf;
+  const uint64_t last_lba = ((uint64_t) tu_ntohl(resp->last_lba_hi) << 32) | tu_ntohl(resp->last_lba_lo);
+  p_msc->capacity[cbw->lun].block_count = last_lba + 1u;
   p_msc->capacity[cbw->lun].block_size  = tu_ntohl(resp->block_size);
 
   // Mark enumeration is complete
@@ -41,6 +41,13 @@ extern "C" {
   #define CFG_TUH_MSC_MAXLUN 4
 #endif
 
+// Number of SCSI commands that can be queued while another one is in progress (shared by all LUNs of an interface).
+// Queued command's CBW is sent as soon as previous one's CSW is received. 0 to disable: submitting a command while
+// busy fails.
+#ifndef CFG_TUH_MSC_QUEUE_DEPTH
+  #define CFG_TUH_MSC_QUEUE_DEPTH 0
+#endif
+
 typedef struct {
   const msc_cbw_t *cbw;       // SCSI command
   const msc_csw_t *csw;       // SCSI status
@@ -61,18 +68,24 @@ bool tuh_msc_mounted(uint8_t dev_addr);
 // Check if the interface is currently ready or busy transferring data
 bool tuh_msc_ready(uint8_t dev_addr);
 
+// Get number of SCSI commands in queue, not including the one in progress
+uint8_t tuh_msc_queue_count(uint8_t dev_addr);
+
 // Get Max Lun
 uint8_t tuh_msc_get_maxlun(uint8_t dev_addr);
 
-// Get number of block
+// Get number of block, saturated at UINT32_MAX for device with more than 2^32 - 1 blocks
 uint32_t tuh_msc_get_block_count(uint8_t dev_addr, uint8_t lun);
 
+// Get number of block, for device larger than 2 TiB (512-byte block)
+uint64_t tuh_msc_get_block_count64(uint8_t dev_addr, uint8_t lun);
+
 // Get block size in bytes
 uint32_t tuh_msc_get_block_size(uint8_t dev_addr, uint8_t lun);
 
 // Perform a full SCSI command (cbw, data, csw) in non-blocking manner.
 // Complete callback is invoked when SCSI op is complete.
-// return true if success, false if there is already pending operation.
+// return true if success, false if there is already pending operation (and queue is full if CFG_TUH_MSC_QUEUE_DEPTH > 0)
 // NOTE: buffer must be accessible by USB/DMA controller, aligned correctly and multiple of cache line if enabled
 bool tuh_msc_scsi_command(uint8_t daddr, const msc_cbw_t *cbw, void *data, tuh_msc_complete_cb_t complete_cb,
                           uintptr_t arg);
@@ -105,6 +118,19 @@ bool tuh_msc_read10(uint8_t dev_addr, uint8_t lun, void *buffer, uint32_t lba, u
 bool tuh_msc_write10(uint8_t dev_addr, uint8_t lun, const void *buffer, uint32_t lba, uint16_t block_count,
                      tuh_msc_complete_cb_t complete_cb, uintptr_t arg);
 
+// Perform SCSI Read 16 command with 64-bit LBA and 32-bit block count, total bytes must not exceed UINT32_MAX.
+// Required for device larger than 2 TiB, which reports its capacity with Read Capacity 16.
+// Complete callback is invoked when SCSI op is complete.
+// NOTE: buffer must be accessible by USB/DMA controller, aligned correctly and multiple of cache line if enabled
+bool tuh_msc_read16(uint8_t dev_addr, uint8_t lun, void *buffer, uint64_t lba, uint32_t block_count,
+                    tuh_msc_complete_cb_t complete_cb, uintptr_t arg);
+
+// Perform SCSI Write 16 command with 64-bit LBA and 32-bit block count, total bytes must not exceed UINT32_MAX.
+// Complete callback is invoked when SCSI op is complete.
+// NOTE: buffer must be accessible by USB/DMA controller, aligned correctly and multiple of cache line if enabled
+bool tuh_msc_write16(uint8_t dev_addr, uint8_t lun, const void *buffer, uint64_t lba, uint32_t block_count,
+                     tuh_msc_complete_cb_t complete_cb, uintptr_t arg);
+
 // Perform SCSI Read Capacity 10 command
 // Complete callback is invoked when SCSI op is complete.
 // Note: during enumeration, host stack already carried out this request. Application can retrieve capacity by
@@ -112,6 +138,11 @@ bool tuh_msc_write10(uint8_t dev_addr, uint8_t lun, const void *buffer, uint32_t
 bool tuh_msc_read_capacity(uint8_t dev_addr, uint8_t lun, scsi_read_capacity10_resp_t *response,
                            tuh_msc_complete_cb_t complete_cb, uintptr_t arg);
 
+// Perform SCSI Read Capacity 16 command, carried out during enumeration if Read Capacity 10 reports the maximum LBA
+// Complete callback is invoked when SCSI op is complete.
+bool tuh_msc_read_capacity16(uint8_t dev_addr, uint8_t lun, scsi_read_capacity16_resp_t *response,
+                             tuh_msc_complete_cb_t complete_cb, uintptr_t arg);
+
 //------------- Application Callback -------------//
 
 // Invoked when a device with MassStorage interface is mounted
@@ -41,6 +41,12 @@
 #define NETD_PACKET_SIZE  (CFG_TUD_NET_PACKET_PREFIX_LEN + CFG_TUD_NET_MTU + CFG_TUD_NET_PACKET_PREFIX_LEN)
 #define NETD_CONTROL_SIZE 120
 
+#define NETD_TX_FRAMES CFG_TUD_ECM_RNDIS_TX_FRAMES
+#define NETD_RX_FRAMES CFG_TUD_ECM_RNDIS_RX_FRAMES
+
+TU_VERIFY_STATIC(NETD_TX_FRAMES > 0 && NETD_TX_FRAMES < 256, "CFG_TUD_ECM_RNDIS_TX_FRAMES must be 1-255");
+TU_VERIFY_STATIC(NETD_RX_FRAMES > 0 && NETD_RX_FRAMES < 256, "CFG_TUD_ECM_RNDIS_RX_FRAMES must be 1-255");
+
 //--------------------------------------------------------------------+
 // MACRO CONSTANT TYPEDEF
 //--------------------------------------------------------------------+
@@ -66,9 +72,25 @@ typedef struct ecm_notify_struct {
   uint32_t downlink, uplink;
 } ecm_notify_t;
 
+// Frame queue: ring of frame buffers, rd_idx is the oldest frame (being transferred or held by application)
+typedef struct {
+  uint16_t len[TU_MAX(NETD_TX_FRAMES, NETD_RX_FRAMES)];
+  uint8_t wr_idx;     // next buffer to fill
+  uint8_t rd_idx;     // oldest filled buffer
+  uint8_t count;      // number of filled buffers
+  bool xfer_busy;     // bulk transfer in progress
+  bool frame_held;    // rx only: oldest frame is passed to application, waiting for tud_network_recv_renew()
+  bool delivering;    // rx only: frames are being passed to application (avoid recursive invocations)
+} netd_frame_queue_t;
+
 typedef struct {
-  TUD_EPBUF_DEF(rx, NETD_PACKET_SIZE);
-  TUD_EPBUF_DEF(tx, NETD_PACKET_SIZE);
+  struct {
+    TUD_EPBUF_DEF(buf, NETD_PACKET_SIZE);
+  } rx[NETD_RX_FRAMES];
+
+  struct {
+    TUD_EPBUF_DEF(buf, NETD_PACKET_SIZE);
+  } tx[NETD_TX_FRAMES];
 
   TUD_EPBUF_DEF(notify, sizeof(ecm_notify_t));
   TUD_EPBUF_DEF(ctrl, NETD_CONTROL_SIZE);
@@ -79,7 +101,8 @@ typedef struct {
 //--------------------------------------------------------------------+
 static netd_interface_t _netd_itf;
 CFG_TUD_MEM_SECTION static netd_epbuf_t _netd_epbuf;
-static bool can_xmit;
+static netd_frame_queue_t _netd_txq;
+static netd_frame_queue_t _netd_rxq;
 static bool ecm_link_is_up = true;  // Store link state for ECM mode
 
 //--------------------------------------------------------------------+
@@ -89,13 +112,84 @@ TU_ATTR_WEAK void tud_network_set_packet_filter_cb(uint16_t packet_filter) {
   (void) packet_filter;
 }
 
+//--------------------------------------------------------------------+
+// Frame queues
+//--------------------------------------------------------------------+
+static void tx_start_if_possible(void) {
+  if (_netd_txq.xfer_busy || _netd_txq.count == 0) {
+    return;
+  }
+
+  _netd_txq.xfer_busy = true;
+  const uint8_t idx = _netd_txq.rd_idx;
+  if (!usbd_edpt_xfer(0, _netd_itf.ep_in, _netd_epbuf.tx[idx].buf, _netd_txq.len[idx], false)) {
+    _netd_txq.xfer_busy = false;
+  }
+}
+
+// pre-build RNDIS header of all transmit buffers, only lengths are updated per frame
+static void tx_init_rndis_headers(void) {
+  for (uint8_t i = 0; i < NETD_TX_FRAMES; i++) {
+    rndis_data_packet_t *hdr = (rndis_data_packet_t *) ((void*) _netd_epbuf.tx[i].buf);
+    memset(hdr, 0, sizeof(rndis_data_packet_t));
+    hdr->MessageType = REMOTE_NDIS_PACKET_MSG;
+    hdr->DataOffset = sizeof(rndis_data_packet_t) - offsetof(rndis_data_packet_t, DataOffset);
+  }
+}
+
+static void rx_start_if_possible(void) {
+  if (_netd_rxq.xfer_busy || _netd_rxq.count >= NETD_RX_FRAMES || _netd_itf.ep_out == 0) {
+    return;
+  }
+
+  _netd_rxq.xfer_busy = true;
+  if (!usbd_edpt_xfer(0, _netd_itf.ep_out, _netd_epbuf.rx[_netd_rxq.wr_idx].buf, NETD_PACKET_SIZE, false)) {
+    _netd_rxq.xfer_busy = false;
+  }
+}
+
+// release the oldest received frame
+static void rx_release_frame(void) {
+  _netd_rxq.frame_held = false;
+  _netd_rxq.rd_idx = (uint8_t) ((_netd_rxq.rd_idx + 1) % NETD_RX_FRAMES);
+  _netd_rxq.count--;
+}
+
+static bool handle_incoming_packet(uint8_t* pnt, uint32_t len);
+
+// pass received frames to application one at a time
+static void rx_deliver(void) {
+  if (_netd_rxq.delivering) {
+    // tud_network_recv_renew() is called within tud_network_recv_cb(), loop below picks next frame
+    return;
+  }
+
+  _netd_rxq.delivering = true;
+  while (!_netd_rxq.frame_held && _netd_rxq.count > 0) {
+    const uint8_t idx = _netd_rxq.rd_idx;
+    _netd_rxq.frame_held = true;
+    if (!handle_incoming_packet(_netd_epbuf.rx[idx].buf, _netd_rxq.len[idx])) {
+      /* if a buffer was never handled by user code, we must renew on the user's behalf */
+      rx_release_frame();
+    }
+  }
+  _netd_rxq.delivering = false;
+}
+
 void tud_network_recv_renew(void) {
-  usbd_edpt_xfer(0, _netd_itf.ep_out, _netd_epbuf.rx, NETD_PACKET_SIZE, false);
+  if (_netd_rxq.frame_held) {
+    rx_release_frame();
+  }
+  rx_deliver();
+  rx_start_if_possible();
+}
+
+uint8_t tud_network_xmit_queue_count(void) {
+  return _netd_txq.count;
 }
 
-static void do_in_xfer(uint8_t *buf, uint16_t len) {
-  can_xmit = false;
-  usbd_edpt_xfer(0, _netd_itf.ep_in, buf, len, false);
+uint8_t tud_network_recv_queue_count(void) {
+  return _netd_rxq.count;
 }
 
 void netd_report(uint8_t *buf, uint16_t len) {
@@ -116,6 +210,8 @@ void netd_report(uint8_t *buf, uint16_t len) {
 //--------------------------------------------------------------------+
 void netd_init(void) {
   tu_memclr(&_netd_itf, sizeof(_netd_itf));
+  tu_memclr(&_netd_txq, sizeof(_netd_txq));
+  tu_memclr(&_netd_rxq, sizeof(_netd_rxq));
 }
 
 bool netd_deinit(void) {
@@ -195,8 +291,7 @@ uint16_t netd_open(uint8_t rhport, tusb_desc_interface_t const * itf_desc, uint1
     // Open endpoint pair for RNDIS
     TU_ASSERT(usbd_open_edpt_pair(rhport, p_desc, 2, TUSB_XFER_BULK, &_netd_itf.ep_out, &_netd_itf.ep_in), 0);
 
-    // we are ready to transmit a packet
-    can_xmit = true;
+    tx_init_rndis_headers();
 
     // prepare for incoming packets
     tud_network_recv_renew();
@@ -272,7 +367,6 @@ bool netd_control_xfer_cb (uint8_t rhport, uint8_t stage, tusb_control_request_t
 
                 // TODO should be merge with RNDIS's after endpoint opened
                 // Also should have opposite callback for application to disable network !!
-                can_xmit = true; // we are ready to transmit a packet
                 tud_network_recv_renew(); // prepare for incoming packets
               }
             } else {
@@ -333,8 +427,8 @@ bool netd_control_xfer_cb (uint8_t rhport, uint8_t stage, tusb_control_request_t
   return true;
 }
 
-static void handle_incoming_packet(uint32_t len) {
-  uint8_t* pnt = _netd_epbuf.rx;
+static bool handle_incoming_packet(uint8_t* pnt, uint32_t len) {
+  uint8_t* const buf = pnt;
   uint32_t size = 0;
 
   if (_netd_itf.ecm_mode) {
@@ -344,17 +438,14 @@ static void handle_incoming_packet(uint32_t len) {
     if (len >= sizeof(rndis_data_packet_t)) {
       if ((r->MessageType == REMOTE_NDIS_PACKET_MSG) && (r->MessageLength <= len)) {
         if ((r->DataOffset + offsetof(rndis_data_packet_t, DataOffset) + r->DataLength) <= len) {
-          pnt = &_netd_epbuf.rx[r->DataOffset + offsetof(rndis_data_packet_t, DataOffset)];
+          pnt = &buf[r->DataOffset + offsetof(rndis_data_packet_t, DataOffset)];
           size = r->DataLength;
         }
       }
     }
   }
 
-  if (!tud_network_recv_cb(pnt, (uint16_t)size)) {
-    /* if a buffer was never handled by user code, we must renew on the user's behalf */
-    tud_network_recv_renew();
-  }
+  return tud_network_recv_cb(pnt, (uint16_t)size);
 }
 
 bool netd_xfer_cb(uint8_t rhport, uint8_t ep_addr, xfer_result_t result, uint32_t xferred_bytes) {
@@ -363,17 +454,28 @@ bool netd_xfer_cb(uint8_t rhport, uint8_t ep_addr, xfer_result_t result, uint32_
 
   /* new packet received */
   if (ep_addr == _netd_itf.ep_out) {
-    handle_incoming_packet(xferred_bytes);
+    _netd_rxq.len[_netd_rxq.wr_idx] = (uint16_t) xferred_bytes;
+    _netd_rxq.wr_idx = (uint8_t) ((_netd_rxq.wr_idx + 1) % NETD_RX_FRAMES);
+    _netd_rxq.count++;
+    _netd_rxq.xfer_busy = false;
+
+    // receive next frame while application is processing this one
+    rx_start_if_possible();
+    rx_deliver();
+    rx_start_if_possible();
   }
 
   /* data transmission finished */
   if (ep_addr == _netd_itf.ep_in) {
     /* TinyUSB requires the class driver to implement ZLP (since ZLP usage is class-specific) */
     if (xferred_bytes > 0 && 0 == (xferred_bytes & (_netd_itf.ep_size-1))) {
-      do_in_xfer(NULL, 0); /* a ZLP is needed */
+      usbd_edpt_xfer(0, _netd_itf.ep_in, NULL, 0, false); /* a ZLP is needed */
     } else {
-      /* we're finally finished */
-      can_xmit = true;
+      /* frame is finished, send next queued one back-to-back */
+      _netd_txq.rd_idx = (uint8_t) ((_netd_txq.rd_idx + 1) % NETD_TX_FRAMES);
+      _netd_txq.count--;
+      _netd_txq.xfer_busy = false;
+      tx_start_if_possible();
     }
   }
 
@@ -387,29 +489,32 @@ bool netd_xfer_cb(uint8_t rhport, uint8_t ep_addr, xfer_result_t result, uint32_
 
 bool tud_network_can_xmit(uint16_t size) {
   (void)size;
-  return can_xmit;
+  return _netd_itf.ep_in != 0 && _netd_txq.count < NETD_TX_FRAMES;
 }
 
 void tud_network_xmit(void *ref, uint16_t arg) {
-  if (!can_xmit) {
+  if (!tud_network_can_xmit(0)) {
     return;
   }
 
-  uint16_t len = (_netd_itf.ecm_mode) ? 0 : CFG_TUD_NET_PACKET_PREFIX_LEN;
-  uint8_t* data = _netd_epbuf.tx + len;
+  const uint8_t idx = _netd_txq.wr_idx;
+  uint8_t* buf = _netd_epbuf.tx[idx].buf;
 
-  len += tud_network_xmit_cb(data, ref, arg);
+  uint16_t len = (_netd_itf.ecm_mode) ? 0 : CFG_TUD_NET_PACKET_PREFIX_LEN;
+  len += tud_network_xmit_cb(buf + len, ref, arg);
 
   if (!_netd_itf.ecm_mode) {
-    rndis_data_packet_t *hdr = (rndis_data_packet_t *) ((void*) _netd_epbuf.tx);
-    memset(hdr, 0, sizeof(rndis_data_packet_t));
-    hdr->MessageType = REMOTE_NDIS_PACKET_MSG;
+    // header is pre-built, only update lengths
+    rndis_data_packet_t *hdr = (rndis_data_packet_t *) ((void*) buf);
     hdr->MessageLength = len;
-    hdr->DataOffset = sizeof(rndis_data_packet_t) - offsetof(rndis_data_packet_t, DataOffset);
     hdr->DataLength = len - sizeof(rndis_data_packet_t);
   }
 
-  do_in_xfer(_netd_epbuf.tx, len);
+  _netd_txq.len[idx] = len;
+  _netd_txq.wr_idx = (uint8_t) ((idx + 1) % NETD_TX_FRAMES);
+  _netd_txq.count++;
+
+  tx_start_if_possible();
 }
 
 // Set the network link state (up/down) and notify the host
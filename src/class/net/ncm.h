@@ -78,6 +78,22 @@
   #define CFG_TUD_NCM_OUT_MAX_DATAGRAMS_PER_NTB 6
 #endif
 
+// Transmit aggregation defaults, can be changed with tud_network_xmit_aggregation().
+// While IN endpoint is idle, a partially filled NTB is held up to AGGREGATION_US microseconds (counted with SOF,
+// rounded up to frames) so that following datagrams are packed into the same transfer. It is sent earlier once
+// it holds AGGREGATION_DATAGRAMS datagrams or AGGREGATION_BYTES bytes. 0 us (default) sends NTB without delay.
+#ifndef CFG_TUD_NCM_IN_AGGREGATION_US
+  #define CFG_TUD_NCM_IN_AGGREGATION_US 0
+#endif
+
+#ifndef CFG_TUD_NCM_IN_AGGREGATION_DATAGRAMS
+  #define CFG_TUD_NCM_IN_AGGREGATION_DATAGRAMS CFG_TUD_NCM_IN_MAX_DATAGRAMS_PER_NTB
+#endif
+
+#ifndef CFG_TUD_NCM_IN_AGGREGATION_BYTES
+  #define CFG_TUD_NCM_IN_AGGREGATION_BYTES CFG_TUD_NCM_IN_NTB_MAX_SIZE
+#endif
+
 // Table 6.2 Class-Specific Request Codes for Network Control Model subclass
 typedef enum
 {
@@ -96,6 +96,7 @@ typedef struct {
   recv_ntb_t *recv_tinyusb_ntb;                         // buffer for the running transfer TinyUSB -> driver
   recv_ntb_t *recv_glue_ntb;                            // buffer for the running transfer driver -> glue logic
   uint16_t recv_glue_ntb_datagram_ndx;                  // index into \a recv_glue_ntb_datagram
+  bool recv_glue_retained;                              // current datagram is retained by glue logic (zero-copy)
 
   // xmit handling
   xmit_ntb_t *xmit_free_ntb[XMIT_NTB_N];                // free list of xmit NTBs
@@ -109,6 +110,10 @@ typedef struct {
   xmit_ntb_t *xmit_glue_ntb;                            // buffer for the running transfer glue logic -> driver
   uint16_t xmit_sequence;                               // NTB sequence counter
   uint16_t xmit_glue_ntb_datagram_ndx;                  // index into \a xmit_glue_ntb_datagram
+  uint16_t xmit_agg_start_frame;                        // frame number when holding of glue NTB started
+  volatile bool xmit_agg_holding;                       // glue NTB is held for aggregation, SOF is enabled
+  volatile bool xmit_agg_started;                       // \a xmit_agg_start_frame is recorded by first SOF
+  volatile bool xmit_agg_expired;                       // hold time is over, glue NTB must be sent
 
   // notification handling
   enum {
@@ -145,6 +150,25 @@ typedef struct {
 static ncm_interface_t ncm_interface;
 CFG_TUD_MEM_SECTION static ncm_epbuf_t ncm_epbuf;
 
+// transmit aggregation policy, kept across bus reset
+static struct {
+  uint16_t max_datagrams;
+  uint16_t max_bytes;
+  uint16_t frames; // hold time in frames, 0 -> no aggregation
+} xmit_agg_policy = {
+  .max_datagrams = CFG_TUD_NCM_IN_AGGREGATION_DATAGRAMS,
+  .max_bytes     = CFG_TUD_NCM_IN_AGGREGATION_BYTES,
+  .frames        = TU_DIV_CEIL(CFG_TUD_NCM_IN_AGGREGATION_US, 1000)
+};
+
+// number of datagrams retained by glue logic per recv NTB, kept across bus reset because the network stack
+// may still reference them
+static uint16_t recv_ntb_refs[RECV_NTB_N];
+
+#if CFG_TUSB_STATS
+static tud_network_xmit_stats_t xmit_stats;
+#endif
+
 //--------------------------------------------------------------------+
 // Weak stubs: invoked if no strong implementation is available
 //--------------------------------------------------------------------+
@@ -370,6 +394,54 @@ static bool xmit_insert_required_zlp(uint8_t rhport, uint32_t xferred_bytes) {
   return true;
 } // xmit_insert_required_zlp
 
+/**
+ * Stop holding the glue NTB for aggregation
+ */
+static void xmit_agg_stop(uint8_t rhport) {
+  if (ncm_interface.xmit_agg_holding) {
+    ncm_interface.xmit_agg_holding = false;
+    usbd_sof_enable(rhport, SOF_CONSUMER_NET, false);
+  }
+  ncm_interface.xmit_agg_expired = false;
+} // xmit_agg_stop
+
+/**
+ * Check if the partially filled glue NTB should be held back so that more datagrams can be aggregated into it.
+ * Hold time is counted by netd_sof_isr(), SOF is enabled while holding.
+ */
+static bool xmit_agg_hold(uint8_t rhport) {
+  uint16_t const max_datagrams = tu_min16(xmit_agg_policy.max_datagrams, ncm_interface.xmit_max_datagrams);
+
+  if (xmit_agg_policy.frames == 0 || ncm_interface.xmit_agg_expired ||
+      ncm_interface.xmit_glue_ntb_datagram_ndx >= max_datagrams ||
+      ncm_interface.xmit_glue_ntb->nth.wBlockLength >= xmit_agg_policy.max_bytes) {
+    return false;
+  }
+
+  if (!ncm_interface.xmit_agg_holding) {
+    ncm_interface.xmit_agg_started = false;
+    ncm_interface.xmit_agg_holding = true;
+    usbd_sof_enable(rhport, SOF_CONSUMER_NET, true);
+  }
+  return true;
+} // xmit_agg_hold
+
+#if CFG_TUSB_STATS
+static void xmit_stats_add(const xmit_ntb_t *ntb) {
+  uint32_t count = 0;
+  while (count < CFG_TUD_NCM_IN_MAX_DATAGRAMS_PER_NTB && ntb->ndp_datagram[count].wDatagramLength != 0) {
+    count++;
+  }
+
+  xmit_stats.ntb_count++;
+  xmit_stats.datagram_count += count;
+  xmit_stats.byte_count += ntb->nth.wBlockLength;
+  if (count > 0) {
+    xmit_stats.datagram_histogram[tu_min32(count, TUD_NCM_STATS_DATAGRAM_BUCKETS) - 1]++;
+  }
+}
+#endif
+
 /**
  * Start transmission if it there is a waiting packet and if can be done from interface side.
  */
@@ -395,6 +467,16 @@ static void xmit_start_if_possible(uint8_t rhport) {
       // -> really nothing is waiting
       return;
     }
+    if (xmit_agg_hold(rhport)) {
+      TU_LOG_DRV("  !xmit_start_if_possible 4 (aggregating)\n");
+      return;
+    }
+    #if CFG_TUSB_STATS
+    if (ncm_interface.xmit_agg_expired) {
+      xmit_stats.timeout_count++;
+    }
+    #endif
+    xmit_agg_stop(rhport);
     ncm_interface.xmit_tinyusb_ntb = ncm_interface.xmit_glue_ntb;
     ncm_interface.xmit_glue_ntb = NULL;
   }
@@ -410,10 +492,25 @@ static void xmit_start_if_possible(uint8_t rhport) {
     TU_LOG_DRV(">> %d %d\n", ncm_interface.xmit_tinyusb_ntb->nth.wBlockLength, ncm_interface.xmit_glue_ntb_datagram_ndx);
   }
 
+  #if CFG_TUSB_STATS
+  xmit_stats_add(ncm_interface.xmit_tinyusb_ntb);
+  #endif
+
   // Kick off an endpoint transfer
   usbd_edpt_xfer(0, ncm_interface.ep_in, ncm_interface.xmit_tinyusb_ntb->data, ncm_interface.xmit_tinyusb_ntb->nth.wBlockLength, false);
 } // xmit_start_if_possible
 
+/**
+ * Hold time of glue NTB is over, deferred from netd_sof_isr()
+ */
+static void xmit_agg_timeout(void *param) {
+  (void) param;
+
+  if (ncm_interface.xmit_agg_expired) {
+    xmit_start_if_possible(ncm_interface.rhport);
+  }
+} // xmit_agg_timeout
+
 /**
  * check if a new datagram fits into the current NTB
  */
@@ -440,6 +537,7 @@ static bool xmit_setup_next_glue_ntb(void) {
 
   if (ncm_interface.xmit_glue_ntb != NULL) {
     // put NTB into waiting list (the new datagram did not fit in)
+    xmit_agg_stop(ncm_interface.rhport);
     xmit_put_ntb_into_ready_list(ncm_interface.xmit_glue_ntb);
   }
 
@@ -550,6 +648,30 @@ static void recv_put_ntb_into_ready_list(recv_ntb_t *ready_ntb) {
 #endif
 } // recv_put_ntb_into_ready_list
 
+/**
+ * Index of \a ntb in the recv NTB pool
+ */
+static uint8_t recv_ntb_index(const recv_ntb_t *ntb) {
+  for (uint8_t i = 0; i < RECV_NTB_N; ++i) {
+    if (ntb == &ncm_epbuf.recv[i].ntb) {
+      return i;
+    }
+  }
+  return RECV_NTB_N;
+} // recv_ntb_index
+
+/**
+ * Return an NTB which has been passed to the glue logic into the free list,
+ * unless there are still datagrams retained by the glue logic.
+ */
+static void recv_put_glue_ntb_into_free_list(recv_ntb_t *glue_ntb) {
+  if (recv_ntb_refs[recv_ntb_index(glue_ntb)] == 0) {
+    recv_put_ntb_into_free_list(glue_ntb);
+  } else {
+    TU_LOG_DRV("  NTB %p still retained\n", glue_ntb);
+  }
+} // recv_put_glue_ntb_into_free_list
+
 /**
  * If possible, start a new reception TinyUSB -> driver.
  */
@@ -669,8 +791,10 @@ static bool recv_validate_datagram(const recv_ntb_t *ntb, uint32_t len) {
 
 /**
  * Transfer the next (pending) datagram to the glue logic and return receive buffer if empty.
+ * \return true if the datagram has been retained by the glue logic, i.e. the next one can be transferred
+ *         without waiting for tud_network_recv_renew()
  */
-static void recv_transfer_datagram_to_glue_logic(void) {
+static bool recv_transfer_datagram_to_glue_logic(void) {
   TU_LOG_DRV("recv_transfer_datagram_to_glue_logic()\n");
 
   if (ncm_interface.recv_glue_ntb == NULL) {
@@ -691,7 +815,11 @@ static void recv_transfer_datagram_to_glue_logic(void) {
       uint16_t datagramLength = ndp16_datagram[ncm_interface.recv_glue_ntb_datagram_ndx].wDatagramLength;
 
       TU_LOG_DRV("  recv[%d] - %d %d\n", ncm_interface.recv_glue_ntb_datagram_ndx, datagramIndex, datagramLength);
+      ncm_interface.recv_glue_retained = false;
       if (tud_network_recv_cb(ncm_interface.recv_glue_ntb->data + datagramIndex, datagramLength)) {
+        const bool retained = ncm_interface.recv_glue_retained;
+        ncm_interface.recv_glue_retained = false;
+
         // send datagram successfully to glue logic
         TU_LOG_DRV("    OK\n");
         datagramIndex = ndp16_datagram[ncm_interface.recv_glue_ntb_datagram_ndx + 1].wDatagramIndex;
@@ -702,14 +830,39 @@ static void recv_transfer_datagram_to_glue_logic(void) {
           ++ncm_interface.recv_glue_ntb_datagram_ndx;
         } else {
           // end of datagrams reached
-          recv_put_ntb_into_free_list(ncm_interface.recv_glue_ntb);
+          recv_put_glue_ntb_into_free_list(ncm_interface.recv_glue_ntb);
           ncm_interface.recv_glue_ntb = NULL;
         }
+        return retained;
+      }
+      // not accepted: a retained reference is dropped
+      if (ncm_interface.recv_glue_retained) {
+        ncm_interface.recv_glue_retained = false;
+        recv_ntb_refs[recv_ntb_index(ncm_interface.recv_glue_ntb)]--;
       }
     }
   }
+  return false;
 } // recv_transfer_datagram_to_glue_logic
 
+/**
+ * Drop a reference obtained by tud_network_recv_retain(), executed in TinyUSB task context.
+ */
+static void recv_release_deferred(void *param) {
+  recv_ntb_t *ntb = (recv_ntb_t *) param;
+  TU_LOG_DRV("recv_release_deferred(%p)\n", ntb);
+
+  const uint8_t ndx = recv_ntb_index(ntb);
+  TU_VERIFY(ndx < RECV_NTB_N && recv_ntb_refs[ndx] > 0, );
+
+  recv_ntb_refs[ndx]--;
+  if (recv_ntb_refs[ndx] == 0 && ntb != ncm_interface.recv_glue_ntb) {
+    // last datagram released and all datagrams are passed to glue logic: NTB can be reused
+    recv_put_ntb_into_free_list(ntb);
+    recv_try_to_start_new_reception(ncm_interface.rhport);
+  }
+} // recv_release_deferred
+
 //-----------------------------------------------------------------------------
 //
 // all the tud_network_*() stuff (glue logic -> driver)
@@ -788,12 +941,40 @@ void tud_network_recv_renew(void) {
     // tud_network_recv_renew_process_again will become true, and the loop will run again
     // Otherwise the loop will not run again
     ncm_interface.tud_network_recv_renew_active = true;
-    recv_transfer_datagram_to_glue_logic();
+    if (recv_transfer_datagram_to_glue_logic()) {
+      // datagram has been retained (zero-copy), glue logic is ready for the next one
+      ncm_interface.tud_network_recv_renew_process_again = true;
+    }
     ncm_interface.tud_network_recv_renew_active = false;
   }
   recv_try_to_start_new_reception(ncm_interface.rhport);
 } // tud_network_recv_renew
 
+/**
+ * Keep the datagram currently passed to tud_network_recv_cb() valid after the callback returns.
+ * \return reference for tud_network_recv_release(), NULL if not called from tud_network_recv_cb()
+ */
+void *tud_network_recv_retain(void) {
+  TU_LOG_DRV("tud_network_recv_retain()\n");
+
+  recv_ntb_t *ntb = ncm_interface.recv_glue_ntb;
+  TU_VERIFY(ntb != NULL && ncm_interface.tud_network_recv_renew_active && !ncm_interface.recv_glue_retained, NULL);
+
+  ncm_interface.recv_glue_retained = true;
+  recv_ntb_refs[recv_ntb_index(ntb)]++;
+  return ntb;
+} // tud_network_recv_retain
+
+/**
+ * Release a datagram retained by tud_network_recv_retain().
+ * Processing is deferred to TinyUSB task, so this can be called from any task.
+ */
+void tud_network_recv_release(void *ref) {
+  TU_LOG_DRV("tud_network_recv_release(%p)\n", ref);
+
+  usbd_defer_func(recv_release_deferred, ref, false);
+} // tud_network_recv_release
+
 /**
  * Same as tud_network_recv_renew() but knows \a rhport
  */
@@ -830,6 +1011,33 @@ void tud_network_link_state(uint8_t rhport, bool is_up) {
   notification_xmit(rhport, false);
 }
 
+/**
+ * Set the transmit aggregation policy
+ */
+void tud_network_xmit_aggregation(uint16_t max_datagrams, uint16_t max_bytes, uint32_t delay_us) {
+  TU_LOG_DRV("tud_network_xmit_aggregation(%d, %d, %lu)\n", max_datagrams, max_bytes, delay_us);
+
+  xmit_agg_policy.max_datagrams = max_datagrams;
+  xmit_agg_policy.max_bytes = max_bytes;
+  // frame number is 11-bit
+  xmit_agg_policy.frames = (uint16_t) tu_min32(tu_div_ceil(delay_us, 1000), 1024);
+
+  // held NTB may not be subject to aggregation anymore
+  if (ncm_interface.xmit_agg_holding) {
+    xmit_start_if_possible(ncm_interface.rhport);
+  }
+} // tud_network_xmit_aggregation
+
+#if CFG_TUSB_STATS
+const tud_network_xmit_stats_t *tud_network_xmit_stats(void) {
+  return &xmit_stats;
+}
+
+void tud_network_xmit_stats_reset(void) {
+  tu_memclr(&xmit_stats, sizeof(xmit_stats));
+}
+#endif
+
 //-----------------------------------------------------------------------------
 //
 // all the netd_*() stuff (interface TinyUSB -> driver)
@@ -850,7 +1058,10 @@ void netd_init(void) {
     ncm_interface.xmit_free_ntb[i] = &ncm_epbuf.xmit[i].ntb;
   }
   for (int i = 0; i < RECV_NTB_N; ++i) {
-    ncm_interface.recv_free_ntb[i] = &ncm_epbuf.recv[i].ntb;
+    // NTBs with retained datagrams are returned to free list when released
+    if (recv_ntb_refs[i] == 0) {
+      ncm_interface.recv_free_ntb[i] = &ncm_epbuf.recv[i].ntb;
+    }
   }
   // Default link state - can be configured via CFG_TUD_NCM_DEFAULT_LINK_UP
   #ifdef CFG_TUD_NCM_DEFAULT_LINK_UP
@@ -872,7 +1083,9 @@ bool netd_deinit(void) {
  * In this driver this is the same as netd_init()
  */
 void netd_reset(uint8_t rhport) {
-  (void) rhport;
+  if (ncm_interface.xmit_agg_holding) {
+    usbd_sof_enable(rhport, SOF_CONSUMER_NET, false);
+  }
 
   netd_init();
 } // netd_reset
@@ -972,6 +1185,26 @@ bool netd_xfer_cb(uint8_t rhport, uint8_t ep_addr, xfer_result_t result, uint32_
   return true;
 } // netd_xfer_cb
 
+/**
+ * Count hold time of the glue NTB, invoked in ISR context while SOF is enabled.
+ * First SOF only records the start frame, so that hold time is rounded up.
+ */
+void netd_sof_isr(uint8_t rhport, uint32_t frame_count) {
+  (void) rhport;
+
+  if (!ncm_interface.xmit_agg_holding || ncm_interface.xmit_agg_expired) {
+    return;
+  }
+
+  if (!ncm_interface.xmit_agg_started) {
+    ncm_interface.xmit_agg_start_frame = (uint16_t) frame_count;
+    ncm_interface.xmit_agg_started = true;
+  } else if (((frame_count - ncm_interface.xmit_agg_start_frame) & 0x7FFu) >= xmit_agg_policy.frames) {
+    ncm_interface.xmit_agg_expired = true;
+    usbd_defer_func(xmit_agg_timeout, NULL, true);
+  }
+} // netd_sof_isr
+
 /**
  * Respond to TinyUSB control requests.
  * At startup transmission of notification packets are done here.
@@ -40,6 +40,16 @@
 #define CFG_TUD_NET_MTU           1514
 #endif
 
+// Number of frame buffers of ECM/RNDIS driver. Transmit frames are queued and sent back-to-back, received frames
+// are buffered while application is processing the previous one. Each buffer takes about MTU + 88 bytes
+#ifndef CFG_TUD_ECM_RNDIS_TX_FRAMES
+#define CFG_TUD_ECM_RNDIS_TX_FRAMES 1
+#endif
+
+#ifndef CFG_TUD_ECM_RNDIS_RX_FRAMES
+#define CFG_TUD_ECM_RNDIS_RX_FRAMES 1
+#endif
+
 
 // Table 4.3 Data Class Interface Protocol Codes
 typedef enum
@@ -97,6 +107,12 @@ uint16_t tud_network_xmit_cb(uint8_t *dst, void *ref, uint16_t arg);
 // client must provide this: initialize any network state back to the beginning
 void tud_network_init_cb(void);
 
+// Number of frames queued for transmission, including the one being transferred
+uint8_t tud_network_xmit_queue_count(void);
+
+// Number of received frames not yet released by tud_network_recv_renew(), including the one passed to application
+uint8_t tud_network_recv_queue_count(void);
+
 // client must provide this: 48-bit MAC address
 // TODO removed later since it is not part of tinyusb stack
 extern uint8_t tud_network_mac_address[6];
@@ -109,6 +125,38 @@ void tud_network_set_packet_filter_cb(uint16_t packet_filter);
 // Set the network link state (up/down) and notify the host
 void tud_network_link_state(uint8_t rhport, bool is_up);
 
+// Zero-copy receive: call within tud_network_recv_cb() to keep using the datagram buffer after returning true e.g
+// as lwIP pbuf_custom. The next datagram is then passed without waiting for tud_network_recv_renew(). Receive NTB is
+// reused once all its retained datagrams are released, CFG_TUD_NCM_OUT_NTB_N >= 2 keeps reception running meanwhile.
+// Return reference to pass to tud_network_recv_release(), NULL if not called from tud_network_recv_cb()
+void* tud_network_recv_retain(void);
+
+// Release datagram retained by tud_network_recv_retain(), can be called from any task but not from ISR
+void tud_network_recv_release(void* ref);
+
+// Set transmit aggregation policy: partially filled NTB is held up to delay_us (0 to disable) while IN endpoint is
+// idle, unless it already has max_datagrams datagrams or max_bytes bytes. Limits negotiated with host still apply.
+void tud_network_xmit_aggregation(uint16_t max_datagrams, uint16_t max_bytes, uint32_t delay_us);
+
+#if CFG_TUSB_STATS
+// Histogram of datagrams per transmitted NTB: bucket n counts NTBs with n+1 datagrams, last one counts the bigger
+#define TUD_NCM_STATS_DATAGRAM_BUCKETS 8
+
+typedef struct {
+  uint32_t ntb_count;      // transmitted NTBs
+  uint32_t datagram_count; // transmitted datagrams
+  uint32_t byte_count;     // transmitted bytes including NTB headers
+  uint32_t timeout_count;  // NTBs sent because aggregation delay expired
+  uint32_t datagram_histogram[TUD_NCM_STATS_DATAGRAM_BUCKETS];
+} tud_network_xmit_stats_t;
+
+// Get transmit statistics
+const tud_network_xmit_stats_t* tud_network_xmit_stats(void);
+
+// Reset transmit statistics
+void tud_network_xmit_stats_reset(void);
+#endif
+
 //--------------------------------------------------------------------+
 // INTERNAL USBD-CLASS DRIVER API
 //--------------------------------------------------------------------+
@@ -119,6 +167,7 @@ uint16_t netd_open            (uint8_t rhport, tusb_desc_interface_t const * itf
 bool     netd_control_xfer_cb (uint8_t rhport, uint8_t stage, tusb_control_request_t const * request);
 bool     netd_xfer_cb         (uint8_t rhport, uint8_t ep_addr, xfer_result_t result, uint32_t xferred_bytes);
 void     netd_report          (uint8_t *buf, uint16_t len);
+void     netd_sof_isr         (uint8_t rhport, uint32_t frame_count);
 
 #ifdef __cplusplus
  }
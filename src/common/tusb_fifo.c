@@ -70,6 +70,10 @@ bool tu_fifo_config(tu_fifo_t *f, void *buffer, uint16_t depth, bool overwritabl
   f->overwritable = overwritable;
   f->rd_idx       = 0u;
   f->wr_idx       = 0u;
+#if CFG_TUSB_FIFO_MPSC
+  f->mpsc     = !overwritable;
+  f->wr_state = 0u;
+#endif
 
   ff_unlock(f->mutex_wr);
   ff_unlock(f->mutex_rd);
@@ -84,6 +88,9 @@ void tu_fifo_clear(tu_fifo_t *f) {
 
   f->rd_idx = 0;
   f->wr_idx = 0;
+#if CFG_TUSB_FIFO_MPSC
+  f->wr_state = 0;
+#endif
 
   ff_unlock(f->mutex_wr);
   ff_unlock(f->mutex_rd);
@@ -94,6 +101,11 @@ void tu_fifo_set_overwritable(tu_fifo_t *f, bool overwritable) {
   if (f->overwritable == overwritable) {
     return;
   }
+#if CFG_TUSB_FIFO_MPSC
+  if (f->mpsc) {
+    return; // lock-free writers do not support overwriting
+  }
+#endif
 
   ff_lock(f->mutex_wr);
   ff_lock(f->mutex_rd);
@@ -152,6 +164,27 @@ TU_ATTR_ALWAYS_INLINE static inline void stride_write(volatile void *hwfifo, con
 void tu_hwfifo_write(volatile void *hwfifo, const uint8_t *src, uint16_t len, const tu_hwfifo_access_t *access_mode) {
   // Write full available 16/32 bit words to dest
   const uint8_t data_stride = (access_mode != NULL) ? access_mode->data_stride : CFG_TUSB_FIFO_HWFIFO_DATA_STRIDE;
+
+    #if CFG_TUSB_FIFO_HWFIFO_DATA_STRIDE == 4
+  // Word aligned source: native 32-bit load (unaligned read is byte-wise on strict alignment MCUs), unrolled
+  // to reduce loop overhead for the common 64/512 bytes packet
+  if (((uintptr_t)src & 3u) == 0) {
+    const uint32_t *src32 = (const uint32_t *)(uintptr_t)src;
+    for (; len >= 16; len -= 16) {
+      *((volatile uint32_t *)hwfifo) = src32[0];
+      HWFIFO_ADDR_NEXT(hwfifo, );
+      *((volatile uint32_t *)hwfifo) = src32[1];
+      HWFIFO_ADDR_NEXT(hwfifo, );
+      *((volatile uint32_t *)hwfifo) = src32[2];
+      HWFIFO_ADDR_NEXT(hwfifo, );
+      *((volatile uint32_t *)hwfifo) = src32[3];
+      HWFIFO_ADDR_NEXT(hwfifo, );
+      src32 += 4;
+    }
+    src = (const uint8_t *)src32;
+  }
+    #endif
+
   while (len >= data_stride) {
     stride_write(hwfifo, src, data_stride);
     src += data_stride;
@@ -222,6 +255,26 @@ TU_ATTR_ALWAYS_INLINE static inline void stride_read(const volatile void *hwfifo
 void tu_hwfifo_read(const volatile void *hwfifo, uint8_t *dest, uint16_t len, const tu_hwfifo_access_t *access_mode) {
   // Reading full available 16/32-bit hwfifo and write to fifo
   const uint8_t data_stride = (access_mode != NULL) ? access_mode->data_stride : CFG_TUSB_FIFO_HWFIFO_DATA_STRIDE;
+
+    #if CFG_TUSB_FIFO_HWFIFO_DATA_STRIDE == 4
+  // Word aligned destination: native 32-bit store, unrolled same as tu_hwfifo_write()
+  if (((uintptr_t)dest & 3u) == 0) {
+    uint32_t *dest32 = (uint32_t *)(uintptr_t)dest;
+    for (; len >= 16; len -= 16) {
+      dest32[0] = *((const volatile uint32_t *)hwfifo);
+      HWFIFO_ADDR_NEXT(hwfifo, const);
+      dest32[1] = *((const volatile uint32_t *)hwfifo);
+      HWFIFO_ADDR_NEXT(hwfifo, const);
+      dest32[2] = *((const volatile uint32_t *)hwfifo);
+      HWFIFO_ADDR_NEXT(hwfifo, const);
+      dest32[3] = *((const volatile uint32_t *)hwfifo);
+      HWFIFO_ADDR_NEXT(hwfifo, const);
+      dest32 += 4;
+    }
+    dest = (uint8_t *)dest32;
+  }
+    #endif
+
   while (len >= data_stride) {
     stride_read(hwfifo, dest, data_stride);
     dest += data_stride;
@@ -378,6 +431,52 @@ static void hwff_pull_n(const tu_fifo_t *f, void *app_buf, uint16_t n, uint16_t
 // Pull & Push
 // copy data to/from fifo without updating read/write pointers
 //--------------------------------------------------------------------+
+#if CFG_TUSB_FIFO_WORD_COPY
+// Copy 32-bit words with 4x unrolled loop if both buffers share the same word alignment, otherwise use memcpy()
+static void ff_memcpy(void *dst, const void *src, uint16_t n) {
+  uint8_t       *dst8 = (uint8_t *)dst;
+  const uint8_t *src8 = (const uint8_t *)src;
+
+  if (n < 16 || (((uintptr_t)dst8 ^ (uintptr_t)src8) & 3u) != 0) {
+    memcpy(dst8, src8, n);
+    return;
+  }
+
+  // leading bytes up to word boundary
+  while ((uintptr_t)dst8 & 3u) {
+    *dst8++ = *src8++;
+    n--;
+  }
+
+  uint32_t       *dst32 = (uint32_t *)(uintptr_t)dst8;
+  const uint32_t *src32 = (const uint32_t *)(uintptr_t)src8;
+  for (; n >= 16; n -= 16) {
+    const uint32_t w0 = src32[0];
+    const uint32_t w1 = src32[1];
+    const uint32_t w2 = src32[2];
+    const uint32_t w3 = src32[3];
+    dst32[0] = w0;
+    dst32[1] = w1;
+    dst32[2] = w2;
+    dst32[3] = w3;
+    src32 += 4;
+    dst32 += 4;
+  }
+  for (; n >= 4; n -= 4) {
+    *dst32++ = *src32++;
+  }
+
+  // trailing bytes
+  dst8 = (uint8_t *)dst32;
+  src8 = (const uint8_t *)src32;
+  while (n--) {
+    *dst8++ = *src8++;
+  }
+}
+#else
+  #define ff_memcpy memcpy
+#endif
+
 // send n items to fifo WITHOUT updating write pointer
 static void ff_push_n(const tu_fifo_t *f, const void *app_buf, uint16_t n, uint16_t wr_ptr) {
   uint16_t lin_bytes  = f->depth - wr_ptr;
@@ -386,11 +485,11 @@ static void ff_push_n(const tu_fifo_t *f, const void *app_buf, uint16_t n, uint1
 
   if (n <= lin_bytes) {
     // Linear only case
-    memcpy(ff_buf, app_buf, n);
+    ff_memcpy(ff_buf, app_buf, n);
   } else {
     // Wrap around case
-    memcpy(ff_buf, app_buf, lin_bytes);                                    // linear part
-    memcpy(f->buffer, ((const uint8_t *)app_buf) + lin_bytes, wrap_bytes); // wrapped part
+    ff_memcpy(ff_buf, app_buf, lin_bytes);                                    // linear part
+    ff_memcpy(f->buffer, ((const uint8_t *)app_buf) + lin_bytes, wrap_bytes); // wrapped part
   }
 }
 
@@ -403,11 +502,11 @@ static void ff_pull_n(const tu_fifo_t *f, void *app_buf, uint16_t n, uint16_t rd
   // single byte access
   if (n <= lin_bytes) {
     // Linear only
-    memcpy(app_buf, ff_buf, n);
+    ff_memcpy(app_buf, ff_buf, n);
   } else {
     // Wrap around
-    memcpy(app_buf, ff_buf, lin_bytes);                            // linear part
-    memcpy((uint8_t *)app_buf + lin_bytes, f->buffer, wrap_bytes); // wrapped part
+    ff_memcpy(app_buf, ff_buf, lin_bytes);                            // linear part
+    ff_memcpy((uint8_t *)app_buf + lin_bytes, f->buffer, wrap_bytes); // wrapped part
   }
 }
 
@@ -453,6 +552,116 @@ static uint16_t correct_read_index(tu_fifo_t *f, uint16_t wr_idx) {
   return rd_idx;
 }
 
+#if CFG_TUSB_FIFO_MPSC
+//--------------------------------------------------------------------+
+// Multiple Producers
+// Writers reserve space by advancing the reserved index in wr_state with compare-and-swap, copy their data then
+// leave. The last writer to leave publishes the reserved index to wr_idx, therefore reader only sees completely
+// written data and a writer never waits for another one (safe to use in ISR).
+// A zero-copy reservation (write_reserve) may be committed with less than reserved, it sets MPSC_RESERVED so that no
+// other writer reserves after it, the unused space at the end is then given back on commit.
+//--------------------------------------------------------------------+
+  #define MPSC_RESERVED              0x80000000u
+  #define MPSC_STATE(_idx, _writers) ((((uint32_t)(_writers)) << 16) | (uint32_t)(_idx))
+  #define MPSC_IDX(_state)           ((uint16_t)((_state) & 0xffffu))
+  #define MPSC_WRITERS(_state)       ((uint16_t)(((_state) >> 16) & 0x7fffu))
+
+// Reserve up to n items (zero-copy is limited to linear part). Return reserved count and its starting index
+static uint16_t mpsc_reserve(tu_fifo_t *f, uint16_t n, bool zero_copy, uint16_t *start_idx) {
+  uint32_t state = __atomic_load_n(&f->wr_state, __ATOMIC_RELAXED);
+  uint32_t new_state;
+  uint16_t count;
+
+  do {
+    if (state & MPSC_RESERVED) {
+      return 0; // zero-copy reservation outstanding
+    }
+
+    const uint16_t wr_idx = MPSC_IDX(state);
+    const uint16_t rd_idx = __atomic_load_n(&f->rd_idx, __ATOMIC_ACQUIRE);
+
+    count = tu_min16(n, tu_ff_remaining_local(f->depth, wr_idx, rd_idx));
+    if (zero_copy) {
+      count = tu_min16(count, f->depth - idx2ptr(f->depth, wr_idx));
+    }
+    if (count == 0) {
+      return 0;
+    }
+
+    *start_idx = wr_idx;
+    new_state  = MPSC_STATE(advance_index(f->depth, wr_idx, count), MPSC_WRITERS(state) + 1u);
+    if (zero_copy) {
+      new_state |= MPSC_RESERVED;
+    }
+  } while (!__atomic_compare_exchange_n(&f->wr_state, &state, new_state, true, __ATOMIC_ACQUIRE, __ATOMIC_RELAXED));
+
+  return count;
+}
+
+// The last writer to leave publishes reserved index to reader
+static void mpsc_publish(tu_fifo_t *f) {
+  while (1) {
+    const uint32_t state = __atomic_load_n(&f->wr_state, __ATOMIC_ACQUIRE);
+    if (MPSC_WRITERS(state) != 0) {
+      return; // a writer is still in progress, it will publish our data as well
+    }
+
+    uint16_t wr_idx = f->wr_idx;
+    if (wr_idx == MPSC_IDX(state)) {
+      return;
+    }
+
+    // state is re-checked so that an older index never replaces a newer one published by a later writer
+    if (__atomic_load_n(&f->wr_state, __ATOMIC_ACQUIRE) == state &&
+        __atomic_compare_exchange_n(&f->wr_idx, &wr_idx, MPSC_IDX(state), false, __ATOMIC_RELEASE,
+                                    __ATOMIC_RELAXED)) {
+      return;
+    }
+  }
+}
+
+// Leave after data is copied into reserved space
+static void mpsc_release(tu_fifo_t *f) {
+  __atomic_fetch_sub(&f->wr_state, MPSC_STATE(0, 1), __ATOMIC_RELEASE);
+  mpsc_publish(f);
+}
+
+// Leave after n items are written to zero-copy reservation. Since no writer could reserve after it, the reserved index
+// is still the end of this reservation and is moved back to the end of committed data.
+static void mpsc_commit(tu_fifo_t *f, uint16_t n) {
+  const uint16_t end_idx = advance_index(f->depth, f->reserve_idx, n);
+  uint32_t state = __atomic_load_n(&f->wr_state, __ATOMIC_RELAXED);
+  uint32_t new_state;
+
+  do {
+    new_state = MPSC_STATE(end_idx, MPSC_WRITERS(state) - 1u);
+  } while (!__atomic_compare_exchange_n(&f->wr_state, &state, new_state, true, __ATOMIC_RELEASE, __ATOMIC_RELAXED));
+
+  mpsc_publish(f);
+}
+
+static uint16_t mpsc_write_n(tu_fifo_t *f, const void *data, uint16_t n, const tu_hwfifo_access_t *access_mode) {
+  uint16_t wr_idx;
+  n = mpsc_reserve(f, n, false, &wr_idx);
+
+  if (n) {
+    const uint16_t wr_ptr = idx2ptr(f->depth, wr_idx);
+  #if CFG_TUSB_FIFO_HWFIFO_API
+    if (access_mode != NULL) {
+      hwff_push_n(f, data, n, wr_ptr, access_mode);
+    } else
+  #endif
+    {
+      (void)access_mode;
+      ff_push_n(f, data, n, wr_ptr);
+    }
+    mpsc_release(f);
+  }
+
+  return n;
+}
+#endif
+
 //--------------------------------------------------------------------+
 // n-API
 //--------------------------------------------------------------------+
@@ -521,6 +730,12 @@ uint16_t tu_fifo_write_n_access_mode(tu_fifo_t *f, const void *data, uint16_t n,
     return 0;
   }
 
+#if CFG_TUSB_FIFO_MPSC
+  if (f->mpsc) {
+    return mpsc_write_n(f, data, n, access_mode);
+  }
+#endif
+
   ff_lock(f->mutex_wr);
 
   uint16_t wr_idx = f->wr_idx;
@@ -654,6 +869,12 @@ bool tu_fifo_peek(tu_fifo_t *f, void *p_buffer) {
 
 // Write one element into the buffer
 bool tu_fifo_write(tu_fifo_t *f, const void *data) {
+#if CFG_TUSB_FIFO_MPSC
+  if (f->mpsc) {
+    return mpsc_write_n(f, data, 1, NULL) == 1;
+  }
+#endif
+
   bool ret;
   ff_lock(f->mutex_wr);
 
@@ -673,6 +894,49 @@ bool tu_fifo_write(tu_fifo_t *f, const void *data) {
   return ret;
 }
 
+uint8_t *tu_fifo_write_reserve(tu_fifo_t *f, uint16_t n, uint16_t *len) {
+#if CFG_TUSB_FIFO_MPSC
+  if (f->mpsc) {
+    uint16_t start_idx;
+    *len = mpsc_reserve(f, n, true, &start_idx);
+    if (*len == 0) {
+      return NULL;
+    }
+    f->reserve_idx = start_idx; // only accessed by the reservation owner
+    return f->buffer + idx2ptr(f->depth, start_idx);
+  }
+#endif
+
+  ff_lock(f->mutex_wr);
+
+  const uint16_t wr_idx = f->wr_idx;
+  const uint16_t rd_idx = f->rd_idx;
+  const uint16_t wr_ptr = idx2ptr(f->depth, wr_idx);
+
+  // limit to free space then to linear part before wrapping
+  uint16_t count = tu_min16(n, tu_ff_remaining_local(f->depth, wr_idx, rd_idx));
+  count          = tu_min16(count, f->depth - wr_ptr);
+
+  *len = count;
+  if (count == 0) {
+    ff_unlock(f->mutex_wr);
+    return NULL;
+  }
+
+  return f->buffer + wr_ptr;
+}
+
+void tu_fifo_write_commit(tu_fifo_t *f, uint16_t n) {
+#if CFG_TUSB_FIFO_MPSC
+  if (f->mpsc) {
+    mpsc_commit(f, n);
+    return;
+  }
+#endif
+  f->wr_idx = advance_index(f->depth, f->wr_idx, n);
+  ff_unlock(f->mutex_wr);
+}
+
 //--------------------------------------------------------------------+
 // Index API
 //--------------------------------------------------------------------+
@@ -695,6 +959,9 @@ bool tu_fifo_write(tu_fifo_t *f, const void *data) {
 /******************************************************************************/
 void tu_fifo_advance_write_pointer(tu_fifo_t *f, uint16_t n) {
   f->wr_idx = advance_index(f->depth, f->wr_idx, n);
+#if CFG_TUSB_FIFO_MPSC
+  f->wr_state = f->wr_idx; // DMA is the only writer
+#endif
 }
 
 // Correct the read index in case tu_fifo_overflow() returned true!
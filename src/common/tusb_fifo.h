@@ -51,6 +51,23 @@ extern "C" {
   #define CFG_TUSB_FIFO_HWFIFO_ADDR_STRIDE 0
 #endif
 
+// Copy engine used to move data between fifo and linear buffer:
+// - 0: memcpy() from C library, best choice when it is speed-optimized (glibc, newlib)
+// - 1: 32-bit word copy with unrolled loop, useful when memcpy() is byte-wise such as newlib-nano built for size
+#ifndef CFG_TUSB_FIFO_WORD_COPY
+  #define CFG_TUSB_FIFO_WORD_COPY 0
+#endif
+
+// Lock-free multiple producers (MPSC) write: writers reserve space with compare-and-swap instead of locking the write
+// mutex, therefore several tasks and ISRs can write to the same fifo concurrently. Reader side is unchanged.
+// Requires 16-bit and 32-bit atomic compare-and-swap (GCC __atomic builtins) on the write index and write state e.g
+// Cortex-M3 and up, ESP32, RISC-V with A extension (16-bit is emulated by compiler with 32-bit LR/SC).
+// Only applies to fifos configured as not overwritable, overwritable fifos keep using the locked write. The mode of a
+// fifo is fixed by tu_fifo_config(): tu_fifo_set_overwritable() can not change a lock-free fifo to overwritable.
+#ifndef CFG_TUSB_FIFO_MPSC
+  #define CFG_TUSB_FIFO_MPSC 0
+#endif
+
 // Due to the use of unmasked pointers, this FIFO does not suffer from losing
 // one item slice. Furthermore, write and read operations are completely
 // decoupled as write and read functions do not modify a common state. Henceforth,
@@ -120,11 +137,21 @@ typedef struct {
   uint8_t *buffer;              // buffer pointer
   uint16_t depth;               // max items
   bool     overwritable;        // overwritable when full
+#if CFG_TUSB_FIFO_MPSC
+  bool     mpsc;                // lock-free multiple producers write, set by config() if not overwritable
+#else
   // 1 byte padding here
+#endif
 
   volatile uint16_t wr_idx;     // write index
   volatile uint16_t rd_idx;     // read index
 
+#if CFG_TUSB_FIFO_MPSC
+  volatile uint32_t wr_state;   // [15:0] reserved write index, [30:16] number of writers in progress,
+                                // [31] zero-copy reservation outstanding
+  uint16_t reserve_idx;         // start index of the outstanding zero-copy reservation
+#endif
+
 #if OSAL_MUTEX_REQUIRED
   osal_mutex_t mutex_wr;
   osal_mutex_t mutex_rd;
@@ -225,6 +252,17 @@ TU_ATTR_ALWAYS_INLINE static inline uint16_t tu_fifo_write_n(tu_fifo_t *f, const
   return tu_fifo_write_n_access_mode(f, data, n, NULL);
 }
 
+// Reserve up to n items of contiguous free space to be filled in place (e.g by DMA or a producer) without extra copy.
+// Return pointer to reserved space and its size in len, which can be less than n if fifo is almost full or free space
+// wraps around (commit then reserve again for the rest). Return NULL if fifo is full. Write mutex is held from a
+// non-NULL reservation until tu_fifo_write_commit() is called. Overwritable fifo does not overwrite when reserving.
+uint8_t *tu_fifo_write_reserve(tu_fifo_t *f, uint16_t n, uint16_t *len);
+
+// Commit n items (up to reserved length, can be 0) written to reserved space and release write mutex.
+// Note: with CFG_TUSB_FIFO_MPSC only one zero-copy reservation can be outstanding, other writers find the fifo full
+// until it is committed. This keeps the reservation at the end so that unused space can be given back.
+void tu_fifo_write_commit(tu_fifo_t *f, uint16_t n);
+
 //--------------------------------------------------------------------+
 // Hardware FIFO API
 // Special hardware FIFO/Buffer to hold USB data, usually requires certain access method these can be configured with
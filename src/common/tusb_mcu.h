@@ -700,6 +700,12 @@
 
 #endif
 
+// Simulated USB controller (no hardware), see portable/sim
+#if (defined(CFG_TUD_SIM) && CFG_TUD_SIM) || (defined(CFG_TUH_SIM) && CFG_TUH_SIM)
+  #define TUP_DCD_ENDPOINT_MAX 16
+  #define TUP_RHPORT_HIGHSPEED 1
+#endif
+
 // External USB controller
 #if defined(CFG_TUH_MAX3421) && CFG_TUH_MAX3421
   #ifndef CFG_TUH_MAX3421_ENDPOINT_TOTAL
@@ -55,11 +55,32 @@ typedef struct {
   uint8_t  hwid;    // device: rhport, host: daddr
   bool     is_host; // 1: host, 0: device
   uint8_t ep_addr;
-  // 1 byte padding
+#if CFG_TUSB_EDPT_STREAM_TX_DIRECT
+  bool     direct;  // tx: send FIFO data in place instead of copying to ep_buf, see tu_edpt_stream_set_direct()
+#endif
+#if CFG_TUSB_EDPT_STREAM_RX_STAGED
+  bool     staged;  // rx: keep receiving into ep_buf when FIFO is full, see tu_edpt_stream_set_staged()
+#endif
 
   uint16_t mps;
   uint16_t xfer_len;
+#if CFG_TUSB_EDPT_STREAM_RX_STAGED
+  uint16_t staged_len; // rx: received bytes kept in ep_buf since FIFO was full, moved to FIFO when read
+  uint16_t staged_ofs; // rx: offset of staged bytes in ep_buf
+#endif
+#if CFG_TUSB_EDPT_STREAM_TX_DIRECT
+  uint16_t direct_len; // tx: FIFO bytes being sent in place, released when transfer completes
+  bool     overwritable_deferred; // tx: FIFO becomes overwritable once bytes sent in place are released
+#endif
   uint8_t  *ep_buf; // set to NULL to use xfer_fifo when CFG_TUD_EDPT_DEDICATED_HWFIFO = 1
+
+#if CFG_TUSB_EDPT_STREAM_WRITE_BUFFER
+  // tx: caller's buffer sent without FIFO, see tu_edpt_stream_write_buffer()
+  const uint8_t *user_buf;
+  uint32_t user_len;
+  uint32_t user_sent;
+#endif
+
   tu_fifo_t ff;
 
   // mutex: read if rx, otherwise write
@@ -126,14 +147,44 @@ TU_ATTR_ALWAYS_INLINE static inline bool tu_edpt_stream_is_opened(const tu_edpt_
 
 TU_ATTR_ALWAYS_INLINE static inline void tu_edpt_stream_close(tu_edpt_stream_t* s) {
   s->ep_addr = 0;
+
+  // transfer is aborted, FIFO bytes sent in place are kept as unsent
+#if CFG_TUSB_EDPT_STREAM_WRITE_BUFFER
+  s->user_buf = NULL;
+#endif
+#if CFG_TUSB_EDPT_STREAM_TX_DIRECT
+  s->direct_len = 0;
+  if (s->overwritable_deferred) {
+    s->overwritable_deferred = false;
+    tu_fifo_set_overwritable(&s->ff, true);
+  }
+#endif
+}
+
+// Number of received bytes staged in ep_buf, see tu_edpt_stream_set_staged()
+TU_ATTR_ALWAYS_INLINE static inline uint16_t tu_edpt_stream_staged_count(const tu_edpt_stream_t *s) {
+#if CFG_TUSB_EDPT_STREAM_RX_STAGED
+  return s->staged_len;
+#else
+  (void) s;
+  return 0;
+#endif
 }
 
-TU_ATTR_ALWAYS_INLINE static inline void tu_edpt_stream_clear(tu_edpt_stream_t *s) {
+// Clear FIFO, refused while its bytes are being sent in place: controller still reads them
+TU_ATTR_ALWAYS_INLINE static inline bool tu_edpt_stream_clear(tu_edpt_stream_t *s) {
+#if CFG_TUSB_EDPT_STREAM_TX_DIRECT
+  TU_VERIFY(s->direct_len == 0);
+#endif
   tu_fifo_clear(&s->ff);
+#if CFG_TUSB_EDPT_STREAM_RX_STAGED
+  s->staged_len = 0;
+#endif
+  return true;
 }
 
 TU_ATTR_ALWAYS_INLINE static inline bool tu_edpt_stream_empty(tu_edpt_stream_t *s) {
-  return tu_fifo_empty(&s->ff);
+  return tu_fifo_empty(&s->ff) && tu_edpt_stream_staged_count(s) == 0;
 }
 
 //--------------------------------------------------------------------+
@@ -143,6 +194,16 @@ TU_ATTR_ALWAYS_INLINE static inline bool tu_edpt_stream_empty(tu_edpt_stream_t *
 // Write to stream
 uint32_t tu_edpt_stream_write(tu_edpt_stream_t *s, const void *buffer, uint32_t bufsize);
 
+// Reserve contiguous space in FIFO to be filled in place, see tu_fifo_write_reserve().
+// A non-NULL reservation must be completed with tu_edpt_stream_write_commit()
+TU_ATTR_ALWAYS_INLINE static inline uint8_t *tu_edpt_stream_write_reserve(tu_edpt_stream_t *s, uint16_t n,
+                                                                          uint16_t *len) {
+  return tu_fifo_write_reserve(&s->ff, n, len);
+}
+
+// Commit n bytes written to reserved space, transfer is started same as tu_edpt_stream_write(). Return n
+uint32_t tu_edpt_stream_write_commit(tu_edpt_stream_t *s, uint16_t n);
+
 // Start an usb transfer if endpoint is not busy. Return number of queued bytes
 uint32_t tu_edpt_stream_write_xfer(tu_edpt_stream_t *s);
 
@@ -153,6 +214,66 @@ bool tu_edpt_stream_write_zlp_if_needed(tu_edpt_stream_t *s, uint32_t last_xferr
 // Note: if no fifo, return endpoint size if not busy, 0 otherwise
 uint32_t tu_edpt_stream_write_available(tu_edpt_stream_t *s);
 
+#if CFG_TUSB_EDPT_STREAM_TX_DIRECT
+// Send data directly from FIFO memory (ep_buf stream only): when contiguous data is at least xfer_len and its address
+// is word aligned, it is transferred in place so that one transfer can carry up to the whole FIFO. Otherwise data is
+// copied to ep_buf as usual. FIFO buffer must be accessible by the controller (DMA) and must not be overwritable.
+TU_ATTR_ALWAYS_INLINE static inline void tu_edpt_stream_set_direct(tu_edpt_stream_t *s, bool enabled) {
+  s->direct = enabled && (s->ep_buf != NULL);
+}
+#endif
+
+// Complete write transfer by releasing FIFO data sent in place. Must be called in the transfer complete callback
+// before starting next transfer
+TU_ATTR_ALWAYS_INLINE static inline void tu_edpt_stream_write_xfer_complete(tu_edpt_stream_t *s) {
+#if CFG_TUSB_EDPT_STREAM_TX_DIRECT
+  if (s->direct_len > 0) {
+    tu_fifo_advance_read_pointer(&s->ff, s->direct_len);
+    s->direct_len = 0;
+  }
+
+  if (s->overwritable_deferred) {
+    s->overwritable_deferred = false;
+    tu_fifo_set_overwritable(&s->ff, true);
+  }
+#else
+  (void) s;
+#endif
+}
+
+// Set FIFO overwritable mode. Overwriting is only enabled once FIFO bytes being sent in place are released by
+// tu_edpt_stream_write_xfer_complete() or tu_edpt_stream_close(), new data would corrupt them otherwise
+TU_ATTR_ALWAYS_INLINE static inline void tu_edpt_stream_set_overwritable(tu_edpt_stream_t *s, bool overwritable) {
+#if CFG_TUSB_EDPT_STREAM_TX_DIRECT
+  s->overwritable_deferred = overwritable && (s->direct_len > 0);
+  if (s->overwritable_deferred) {
+    return;
+  }
+#endif
+  tu_fifo_set_overwritable(&s->ff, overwritable);
+}
+
+#if CFG_TUSB_EDPT_STREAM_WRITE_BUFFER
+// Send caller's buffer without copying to FIFO, split into transfers of at most 64KB. Only started if FIFO is empty,
+// endpoint is idle and buffer is word aligned, return false otherwise (use tu_edpt_stream_write() instead).
+// Controller reads buffer in place: it must be reachable by its DMA (RAM, not flash on some ports) and stay valid and
+// unchanged until tu_edpt_stream_write_buffer_busy() is false.
+bool tu_edpt_stream_write_buffer(tu_edpt_stream_t *s, const void *buffer, uint32_t bufsize);
+
+TU_ATTR_ALWAYS_INLINE static inline bool tu_edpt_stream_write_buffer_busy(const tu_edpt_stream_t *s) {
+  return s->user_buf != NULL;
+}
+
+// Number of bytes of user buffer sent so far, final once tu_edpt_stream_write_buffer_busy() is false
+TU_ATTR_ALWAYS_INLINE static inline uint32_t tu_edpt_stream_write_buffer_sent(const tu_edpt_stream_t *s) {
+  return s->user_sent;
+}
+
+// Continue sending user buffer, must be called in the transfer complete callback while user buffer is busy.
+// Return true once the whole buffer is sent or transfer failed, bytes sent are in user_sent
+bool tu_edpt_stream_write_buffer_xfer_complete(tu_edpt_stream_t *s, uint32_t xferred_bytes);
+#endif
+
 //--------------------------------------------------------------------+
 // Stream Read
 //--------------------------------------------------------------------+
@@ -160,32 +281,74 @@ uint32_t tu_edpt_stream_write_available(tu_edpt_stream_t *s);
 // Read from stream
 uint32_t tu_edpt_stream_read(tu_edpt_stream_t *s, void *buffer, uint32_t bufsize);
 
-// Start an usb transfer if endpoint is not busy
+// Start an usb transfer if endpoint is not busy and FIFO has space for at least one packet. With staged receive,
+// transfer is started even if FIFO is (nearly) full, see tu_edpt_stream_set_staged()
 uint32_t tu_edpt_stream_read_xfer(tu_edpt_stream_t *s);
 
-// Complete read transfer by writing EP -> FIFO. Must be called in the transfer complete callback
+#if CFG_TUSB_EDPT_STREAM_RX_STAGED
+// Staged receive (ep_buf stream only): always receive a whole ep_buf, bytes that do not fit into FIFO are kept
+// (staged) in ep_buf and moved to FIFO when read. Next transfer waits until all staged bytes are moved.
+TU_ATTR_ALWAYS_INLINE static inline void tu_edpt_stream_set_staged(tu_edpt_stream_t *s, bool enabled) {
+  s->staged = enabled && (s->ep_buf != NULL);
+}
+#endif
+
+// Complete read transfer with provided buffer, which can be part of ep_buf (e.g to skip header).
+// With staged receive, bytes of ep_buf that do not fit into FIFO are staged
 TU_ATTR_ALWAYS_INLINE static inline
-void tu_edpt_stream_read_xfer_complete(tu_edpt_stream_t* s, uint32_t xferred_bytes) {
-  if (s->ep_buf != NULL) {
-    tu_fifo_write_n(&s->ff, s->ep_buf, (uint16_t)xferred_bytes);
+void tu_edpt_stream_read_xfer_complete_with_buf(tu_edpt_stream_t *s, const void *buf, uint32_t xferred_bytes) {
+  const uint16_t count = tu_fifo_write_n(&s->ff, buf, (uint16_t)xferred_bytes);
+#if CFG_TUSB_EDPT_STREAM_RX_STAGED
+  if (count < xferred_bytes && s->staged) {
+    s->staged_ofs = (uint16_t) ((const uint8_t *) buf - s->ep_buf + count);
+    s->staged_len = (uint16_t) (xferred_bytes - count);
   }
+#else
+  (void) count;
+#endif
 }
 
-// Complete read transfer with provided buffer
+// Complete read transfer by writing EP -> FIFO. Must be called in the transfer complete callback
 TU_ATTR_ALWAYS_INLINE static inline
-void tu_edpt_stream_read_xfer_complete_with_buf(tu_edpt_stream_t *s, const void *buf, uint32_t xferred_bytes) {
-  tu_fifo_write_n(&s->ff, buf, (uint16_t)xferred_bytes);
+void tu_edpt_stream_read_xfer_complete(tu_edpt_stream_t* s, uint32_t xferred_bytes) {
+  if (s->ep_buf != NULL) {
+    tu_edpt_stream_read_xfer_complete_with_buf(s, s->ep_buf, xferred_bytes);
+  }
 }
 
-// Get the number of bytes available for reading
+// Get the number of bytes available for reading, including staged bytes
 TU_ATTR_ALWAYS_INLINE static inline uint32_t tu_edpt_stream_read_available(const tu_edpt_stream_t *s) {
-  return (uint32_t) tu_fifo_count(&s->ff);
+  return (uint32_t) tu_fifo_count(&s->ff) + tu_edpt_stream_staged_count(s);
 }
 
 TU_ATTR_ALWAYS_INLINE static inline bool tu_edpt_stream_peek(tu_edpt_stream_t *s, uint8_t *ch) {
-  return tu_fifo_peek(&s->ff, ch);
+  if (tu_fifo_peek(&s->ff, ch)) {
+    return true;
+  }
+
+#if CFG_TUSB_EDPT_STREAM_RX_STAGED
+  // FIFO is empty, next byte may still be staged in ep_buf
+  if (s->staged_len > 0) {
+    *ch = s->ep_buf[s->staged_ofs];
+    return true;
+  }
+#endif
+
+  return false;
 }
 
+//--------------------------------------------------------------------+
+// Stream Transfer in ISR (device only)
+// Continue transfer from class driver xfer_isr(), usbd keeps the endpoint claimed meanwhile
+//--------------------------------------------------------------------+
+
+// Send data in FIFO, or a ZLP if needed. Return number of queued bytes
+uint32_t tu_edpt_stream_write_xfer_isr(tu_edpt_stream_t *s, uint32_t last_xferred_bytes);
+
+// Prepare for incoming data if FIFO has enough space (no staged bytes with staged receive). Return number of bytes to
+// receive
+uint32_t tu_edpt_stream_read_xfer_isr(tu_edpt_stream_t *s);
+
 #ifdef __cplusplus
  }
 #endif
@@ -0,0 +1,110 @@
+/*
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2026 Ha Thach (tinyusb.org)
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ *
+ * This file is part of the TinyUSB stack.
+ */
+
+#include "tusb_option.h"
+
+#if (CFG_TUH_ENABLED || CFG_TUD_ENABLED) && CFG_TUSB_TRACE_DEPTH
+
+#include "tusb.h"
+
+// tu_fifo depth is limited to 0x8000 since its indices are unmasked i.e in range of 2*depth
+TU_VERIFY_STATIC(CFG_TUSB_TRACE_DEPTH * sizeof(tu_trace_entry_t) <= 0x8000, "CFG_TUSB_TRACE_DEPTH is too large");
+
+//--------------------------------------------------------------------+
+// MACRO CONSTANT TYPEDEF
+//--------------------------------------------------------------------+
+
+// Overwritable byte fifo: depth is a multiple of entry size and entries are always written whole, therefore
+// overwriting keeps the read index at entry boundary.
+static TU_FIFO_DEF(_trace_ff, CFG_TUSB_TRACE_DEPTH * sizeof(tu_trace_entry_t), true);
+
+#if OSAL_MUTEX_REQUIRED
+// device and host task can run in different threads. Fifo has no mutex of its own, all accesses are serialized by this
+// one so that an entry is never read while being overwritten.
+static osal_mutex_def_t _trace_mutexdef;
+static osal_mutex_t _trace_mutex;
+#endif
+
+TU_ATTR_ALWAYS_INLINE static inline void trace_lock(void) {
+#if OSAL_MUTEX_REQUIRED
+  if (_trace_mutex != NULL) {
+    (void) osal_mutex_lock(_trace_mutex, OSAL_TIMEOUT_WAIT_FOREVER);
+  }
+#endif
+}
+
+TU_ATTR_ALWAYS_INLINE static inline void trace_unlock(void) {
+#if OSAL_MUTEX_REQUIRED
+  if (_trace_mutex != NULL) {
+    (void) osal_mutex_unlock(_trace_mutex);
+  }
+#endif
+}
+
+//--------------------------------------------------------------------+
+// Public API
+//--------------------------------------------------------------------+
+void tu_trace_init(void) {
+#if OSAL_MUTEX_REQUIRED
+  if (_trace_mutex == NULL) {
+    _trace_mutex = osal_mutex_create(&_trace_mutexdef);
+  }
+#endif
+}
+
+void tu_trace_record(uint8_t id, uint8_t addr, uint8_t ep_addr, uint8_t result, uint32_t len) {
+  const tu_trace_entry_t entry = {
+    .time_ms = tusb_time_millis_api(),
+    .id      = id,
+    .addr    = addr,
+    .ep_addr = ep_addr,
+    .result  = result,
+    .len     = len
+  };
+  trace_lock();
+  (void) tu_fifo_write_n(&_trace_ff, &entry, sizeof(entry));
+  trace_unlock();
+}
+
+uint16_t tu_trace_read(tu_trace_entry_t* entries, uint16_t count) {
+  count = tu_min16(count, CFG_TUSB_TRACE_DEPTH);
+  trace_lock();
+  const uint16_t nbytes = tu_fifo_read_n(&_trace_ff, entries, (uint16_t) (count * sizeof(tu_trace_entry_t)));
+  trace_unlock();
+  return (uint16_t) (nbytes / sizeof(tu_trace_entry_t));
+}
+
+uint16_t tu_trace_count(void) {
+  return (uint16_t) (tu_fifo_count(&_trace_ff) / sizeof(tu_trace_entry_t));
+}
+
+void tu_trace_clear(void) {
+  trace_lock();
+  tu_fifo_clear(&_trace_ff);
+  trace_unlock();
+}
+
+#endif
@@ -0,0 +1,125 @@
+/*
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2026 Ha Thach (tinyusb.org)
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ *
+ * This file is part of the TinyUSB stack.
+ */
+
+#ifndef TUSB_STATS_H_
+#define TUSB_STATS_H_
+
+#include "common/tusb_common.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+//--------------------------------------------------------------------+
+// Runtime Statistics (CFG_TUSB_STATS)
+// Counters are collected by device and host stack, see tud_stats_edpt() and tuh_stats_edpt()
+//--------------------------------------------------------------------+
+
+typedef struct {
+  uint32_t xfer_count;  // completed transfers
+  uint32_t byte_count;  // transferred bytes
+  uint32_t stall_count; // device: endpoint stalled by stack or class driver, host: transfers completed with STALL
+  uint32_t error_count; // transfers completed with error or timeout
+} tu_stats_edpt_t;
+
+// Latency histogram: bucket n counts transfers that took less than 2^n ms, the last bucket counts all the slower ones
+#define TU_STATS_LATENCY_BUCKETS 8
+
+typedef struct {
+  uint32_t count;
+  uint32_t max_ms;
+  uint32_t histogram[TU_STATS_LATENCY_BUCKETS];
+} tu_stats_latency_t;
+
+TU_ATTR_ALWAYS_INLINE static inline void tu_stats_edpt_add(tu_stats_edpt_t* stats, xfer_result_t result, uint32_t len) {
+  stats->xfer_count++;
+  stats->byte_count += len;
+  if (result == XFER_RESULT_STALLED) {
+    stats->stall_count++;
+  } else if (result != XFER_RESULT_SUCCESS) {
+    stats->error_count++;
+  }
+}
+
+TU_ATTR_ALWAYS_INLINE static inline void tu_stats_latency_add(tu_stats_latency_t* lat, uint32_t ms) {
+  uint8_t bucket = 0;
+  while (bucket < TU_STATS_LATENCY_BUCKETS - 1 && ms >= (1UL << bucket)) {
+    bucket++;
+  }
+  lat->histogram[bucket]++;
+  lat->count++;
+  if (ms > lat->max_ms) {
+    lat->max_ms = ms;
+  }
+}
+
+//--------------------------------------------------------------------+
+// Event Trace (CFG_TUSB_TRACE_DEPTH)
+// Binary ring buffer of timestamped events processed by tud_task() and tuh_task(). Oldest entries are overwritten
+// when full. Entries are packed little-endian 12-byte records that can be sent as-is to a PC tool e.g over CDC:
+//
+//   tu_trace_entry_t entries[8];
+//   uint16_t count = tu_trace_read(entries, 8);
+//   tud_cdc_write(entries, count * sizeof(tu_trace_entry_t));
+//--------------------------------------------------------------------+
+
+enum {
+  TU_TRACE_HOST = 0x80, // or-ed into id for host events
+};
+
+typedef struct TU_ATTR_PACKED {
+  uint32_t time_ms; // tusb_time_millis_api() when event is processed
+  uint8_t  id;      // device: dcd_eventid_t, host: TU_TRACE_HOST | hcd_eventid_t
+  uint8_t  addr;    // device: rhport, host: device address (hub address for attach/remove)
+  uint8_t  ep_addr; // endpoint for transfer complete, hub port for host attach/remove
+  uint8_t  result;  // xfer_result_t for transfer complete, bRequest for setup received
+  uint32_t len;     // transferred bytes, wLength for setup received, frame count for SOF
+} tu_trace_entry_t;
+
+TU_VERIFY_STATIC(sizeof(tu_trace_entry_t) == 12, "size is not correct");
+
+#if CFG_TUSB_TRACE_DEPTH
+// Init trace buffer, invoked by tud_init() and tuh_init()
+void tu_trace_init(void);
+
+// Append an entry, should only be called from task context
+void tu_trace_record(uint8_t id, uint8_t addr, uint8_t ep_addr, uint8_t result, uint32_t len);
+
+// Read and remove up to count oldest entries, return number of entries read
+uint16_t tu_trace_read(tu_trace_entry_t* entries, uint16_t count);
+
+// Number of entries in buffer
+uint16_t tu_trace_count(void);
+
+// Discard all entries
+void tu_trace_clear(void);
+#endif
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -179,8 +179,12 @@ static const usbd_class_driver_t _usbd_driver[] = {
         .open             = cdcd_open,
         .control_xfer_cb  = cdcd_control_xfer_cb,
         .xfer_cb          = cdcd_xfer_cb,
+      #if CFG_TUD_CDC_XFER_ISR
+        .xfer_isr         = cdcd_xfer_isr,
+      #else
         .xfer_isr         = NULL,
-        .sof              = NULL
+      #endif
+        .sof              = cdcd_sof_isr
     },
     #endif
 
@@ -263,7 +267,11 @@ static const usbd_class_driver_t _usbd_driver[] = {
         .open             = vendord_open,
         .control_xfer_cb  = tud_vendor_control_xfer_cb,
         .xfer_cb          = vendord_xfer_cb,
+      #if CFG_TUD_VENDOR_XFER_ISR && CFG_TUD_VENDOR_TXRX_BUFFERED
+        .xfer_isr         = vendord_xfer_isr,
+      #else
         .xfer_isr         = NULL,
+      #endif
         .sof              = NULL
     },
     #endif
@@ -320,7 +328,11 @@ static const usbd_class_driver_t _usbd_driver[] = {
         .control_xfer_cb  = netd_control_xfer_cb,
         .xfer_cb          = netd_xfer_cb,
         .xfer_isr         = NULL,
+        #if CFG_TUD_NCM
+        .sof              = netd_sof_isr,
+        #else
         .sof              = NULL,
+        #endif
     },
     #endif
 
@@ -413,16 +425,145 @@ static osal_queue_t _usbd_q;
   #define _usbd_mutex   NULL
 #endif
 
+#if CFG_TUD_TASK_STATS
+// queued and received counters, their difference is the number of pending events
+static struct {
+  volatile uint32_t queued;
+  volatile uint32_t received;
+  uint32_t dispatched;
+  uint16_t hwm;
+} _usbd_qstats;
+#endif
+
+#if CFG_TUSB_STATS
+static struct {
+  tu_stats_edpt_t    edpt[CFG_TUD_ENDPPOINT_MAX][2];
+  tu_stats_latency_t control;
+  uint32_t           setup_ms; // time when current SETUP is processed
+} _usbd_stats;
+#endif
+
+#if CFG_TUD_TASK_MERGE_SOF
+// event received from queue but not merged into the previous one, processed in the next run
+static dcd_event_t _usbd_next_event;
+static bool        _usbd_has_next_event;
+#endif
+
 TU_ATTR_ALWAYS_INLINE static inline bool queue_event(dcd_event_t const * event, bool in_isr) {
-  TU_ASSERT(osal_queue_send(_usbd_q, event, in_isr));
+#if CFG_TUD_TASK_STATS
+  // count before sending since task may receive the event before osal_queue_send() returns
+  usbd_spin_lock(in_isr);
+  _usbd_qstats.queued++;
+  usbd_spin_unlock(in_isr);
+#endif
+
+  const bool sent = osal_queue_send(_usbd_q, event, in_isr);
+
+#if CFG_TUD_TASK_STATS
+  usbd_spin_lock(in_isr);
+  if (sent) {
+    const uint16_t pending = (uint16_t) (_usbd_qstats.queued - _usbd_qstats.received);
+    if (pending > _usbd_qstats.hwm) {
+      _usbd_qstats.hwm = pending;
+    }
+  } else {
+    _usbd_qstats.queued--;
+  }
+  usbd_spin_unlock(in_isr);
+#endif
+
+  TU_ASSERT(sent);
+
   tud_event_hook_cb(event->rhport, event->event_id, in_isr);
   return true;
 }
 
+TU_ATTR_ALWAYS_INLINE static inline bool receive_event(dcd_event_t* event, uint32_t timeout_ms) {
+  TU_VERIFY(osal_queue_receive(_usbd_q, event, timeout_ms));
+#if CFG_TUD_TASK_STATS
+  usbd_spin_lock(false);
+  _usbd_qstats.received++;
+  usbd_spin_unlock(false);
+#endif
+  return true;
+}
+
+#if CFG_TUD_TASK_MERGE_SOF
+// Merge next event into current one if both are SOF, only the latest frame count matters
+static bool merge_event(dcd_event_t* event, dcd_event_t const* next) {
+  TU_VERIFY(event->rhport == next->rhport && event->event_id == DCD_EVENT_SOF && next->event_id == DCD_EVENT_SOF);
+  *event = *next;
+  return true;
+}
+#endif
+
+// Get next event to process, consecutive SOF events are merged if enabled
+static bool get_event(dcd_event_t* event, uint32_t timeout_ms) {
+#if CFG_TUD_TASK_MERGE_SOF
+  if (_usbd_has_next_event) {
+    *event = _usbd_next_event;
+    _usbd_has_next_event = false;
+  } else
+#endif
+  {
+    TU_VERIFY(receive_event(event, timeout_ms));
+  }
+
+#if CFG_TUD_TASK_MERGE_SOF
+  while (receive_event(&_usbd_next_event, 0)) {
+    if (!merge_event(event, &_usbd_next_event)) {
+      _usbd_has_next_event = true;
+      break;
+    }
+  }
+#endif
+
+#if CFG_TUD_TASK_STATS
+  _usbd_qstats.dispatched++;
+#endif
+
+  return true;
+}
+
+#if CFG_TUSB_TRACE_DEPTH
+static void trace_event(dcd_event_t const* event) {
+  uint8_t ep_addr = 0;
+  uint8_t result = 0;
+  uint32_t len = 0;
+
+  switch (event->event_id) {
+    case DCD_EVENT_BUS_RESET:
+      result = (uint8_t) event->bus_reset.speed;
+      break;
+
+    case DCD_EVENT_SETUP_RECEIVED:
+      result = event->setup_received.bRequest;
+      len = event->setup_received.wLength;
+      break;
+
+    case DCD_EVENT_XFER_COMPLETE:
+      ep_addr = event->xfer_complete.ep_addr;
+      result = event->xfer_complete.result;
+      len = event->xfer_complete.len;
+      break;
+
+    case DCD_EVENT_SOF:
+      len = event->sof.frame_count;
+      break;
+
+    default:
+      break;
+  }
+
+  tu_trace_record(event->event_id, event->rhport, ep_addr, result, len);
+}
+#endif
+
 //--------------------------------------------------------------------+
 // Prototypes
 //--------------------------------------------------------------------+
 static bool usbd_control_xfer_cb(uint8_t rhport, uint8_t ep_addr, xfer_result_t result, uint32_t xferred_bytes);
+static void usbd_control_stall(uint8_t rhport);
 static bool process_setup_received(uint8_t rhport, tusb_control_request_t const * p_request);
 static bool process_set_config(uint8_t rhport, uint8_t cfg_num);
 static bool process_get_descriptor(uint8_t rhport, tusb_control_request_t const * p_request);
@@ -553,6 +694,18 @@ bool tud_rhport_init(uint8_t rhport, const tusb_rhport_init_t* rh_init) {
 
   tu_varclr(&_usbd_dev);
   _usbd_queued_setup = 0;
+#if CFG_TUD_TASK_MERGE_SOF
+  _usbd_has_next_event = false;
+#endif
+#if CFG_TUD_TASK_STATS
+  tu_varclr(&_usbd_qstats);
+#endif
+#if CFG_TUSB_STATS
+  tu_varclr(&_usbd_stats);
+#endif
+#if CFG_TUSB_TRACE_DEPTH
+  tu_trace_init();
+#endif
 
   osal_spin_init(&_usbd_spin);
 
@@ -649,9 +802,52 @@ static void usbd_reset(uint8_t rhport) {
 
 bool tud_task_event_ready(void) {
   TU_VERIFY(tud_inited()); // Skip if stack is not initialized
+#if CFG_TUD_TASK_MERGE_SOF
+  if (_usbd_has_next_event) {
+    return true;
+  }
+#endif
   return !osal_queue_empty(_usbd_q);
 }
 
+#if CFG_TUD_TASK_STATS
+void tud_task_stats_get(tud_task_stats_t* stats) {
+  stats->event_count    = _usbd_qstats.received;
+  stats->dispatch_count = _usbd_qstats.dispatched;
+  stats->queue_hwm      = _usbd_qstats.hwm;
+  stats->queue_size     = CFG_TUD_TASK_QUEUE_SZ;
+}
+
+void tud_task_stats_reset(void) {
+  usbd_spin_lock(false);
+  _usbd_qstats.queued     = _usbd_qstats.queued - _usbd_qstats.received; // keep pending events
+  _usbd_qstats.received   = 0;
+  _usbd_qstats.hwm        = (uint16_t) _usbd_qstats.queued;
+  _usbd_qstats.dispatched = 0;
+  usbd_spin_unlock(false);
+}
+#endif
+
+#if CFG_TUSB_STATS
+const tu_stats_edpt_t* tud_stats_edpt(uint8_t ep_addr) {
+  const uint8_t epnum = tu_edpt_number(ep_addr);
+  TU_VERIFY(epnum < CFG_TUD_ENDPPOINT_MAX, NULL);
+  return &_usbd_stats.edpt[epnum][tu_edpt_dir(ep_addr)];
+}
+
+const tu_stats_latency_t* tud_stats_control_latency(void) {
+  return &_usbd_stats.control;
+}
+
+void tud_stats_reset(void) {
+  tu_memclr(_usbd_stats.edpt, sizeof(_usbd_stats.edpt));
+  tu_varclr(&_usbd_stats.control);
+#if CFG_TUD_TASK_STATS
+  tud_task_stats_reset();
+#endif
+}
+#endif
+
 //--------------------------------------------------------------------+
 // USBD Task
 //--------------------------------------------------------------------+
@@ -686,10 +882,14 @@ void tud_task_ext(uint32_t timeout_ms, bool in_isr) {
     }
 #endif
     dcd_event_t event;
-    if (!osal_queue_receive(_usbd_q, &event, timeout_ms)) {
+    if (!get_event(&event, timeout_ms)) {
       return;
     }
 
+#if CFG_TUSB_TRACE_DEPTH
+    trace_event(&event);
+#endif
+
 #if CFG_TUSB_DEBUG >= CFG_TUD_LOG_LEVEL
     if (event.event_id == DCD_EVENT_SETUP_RECEIVED) {
       TU_LOG_USBD("\r\n"); // extra line for setup
@@ -729,12 +929,15 @@ void tud_task_ext(uint32_t timeout_ms, bool in_isr) {
         _usbd_dev.ep_status[0][TUSB_DIR_OUT] = 0;
         _usbd_dev.ep_status[0][TUSB_DIR_IN] = 0;
 
+#if CFG_TUSB_STATS
+        _usbd_stats.setup_ms = tusb_time_millis_api();
+#endif
+
         // Process control request
         if (!process_setup_received(event.rhport, &event.setup_received)) {
           TU_LOG_USBD("  Stall EP0\r\n");
           // Failed -> stall both control endpoint IN and OUT
-          dcd_edpt_stall(event.rhport, TU_EP0_OUT);
-          dcd_edpt_stall(event.rhport, TU_EP0_IN);
+          usbd_control_stall(event.rhport);
         }
         break;
 
@@ -810,6 +1013,16 @@ void tud_task_ext(uint32_t timeout_ms, bool in_isr) {
 // Control Endpoint
 //--------------------------------------------------------------------+
 
+// Stall both IN and OUT control endpoint
+static void usbd_control_stall(uint8_t rhport) {
+  dcd_edpt_stall(rhport, TU_EP0_OUT);
+  dcd_edpt_stall(rhport, TU_EP0_IN);
+#if CFG_TUSB_STATS
+  _usbd_stats.edpt[0][TUSB_DIR_OUT].stall_count++;
+  _usbd_stats.edpt[0][TUSB_DIR_IN].stall_count++;
+#endif
+}
+
 // Weak hook: invoked when the control transfer's status stage completes
 TU_ATTR_WEAK void dcd_edpt0_status_complete(uint8_t rhport, const tusb_control_request_t* request) {
   (void) rhport;
@@ -890,6 +1103,10 @@ static bool usbd_control_xfer_cb(uint8_t rhport, uint8_t ep_addr, xfer_result_t
     // invoke optional dcd hook if available
     dcd_edpt0_status_complete(rhport, &ctrl_xfer->request);
 
+#if CFG_TUSB_STATS
+    tu_stats_latency_add(&_usbd_stats.control, tusb_time_millis_api() - _usbd_stats.setup_ms);
+#endif
+
     if (NULL != ctrl_xfer->complete_cb) {
       ctrl_xfer->complete_cb(rhport, CONTROL_STAGE_ACK, &ctrl_xfer->request);
     }
@@ -923,8 +1140,7 @@ static bool usbd_control_xfer_cb(uint8_t rhport, uint8_t ep_addr, xfer_result_t
       TU_ASSERT(status_stage_xact(rhport, ep_status));
     } else {
       // Stall both IN and OUT control endpoint
-      dcd_edpt_stall(rhport, TU_EP0_OUT);
-      dcd_edpt_stall(rhport, TU_EP0_IN);
+      usbd_control_stall(rhport);
     }
   } else {
     // More data to transfer
@@ -1435,20 +1651,30 @@ TU_ATTR_FAST_FUNC void dcd_event_handler(dcd_event_t const* event, bool in_isr)
       uint8_t const epnum = tu_edpt_number(ep_addr);
       uint8_t const ep_dir = tu_edpt_dir(ep_addr);
 
+#if CFG_TUSB_STATS
+      if (epnum < CFG_TUD_ENDPPOINT_MAX) {
+        tu_stats_edpt_add(&_usbd_stats.edpt[epnum][ep_dir], (xfer_result_t) event->xfer_complete.result,
+                          event->xfer_complete.len);
+      }
+#endif
+
       send = true;
       if(epnum > 0) {
         usbd_class_driver_t const* driver = get_driver(_usbd_dev.ep2drv[epnum][ep_dir]);
 
         if (driver && driver->xfer_isr) {
-          // Clear busy + claimed
-          _usbd_dev.ep_status[epnum][ep_dir] &= (uint8_t) ~(TU_EDPT_STATE_BUSY | TU_EDPT_STATE_CLAIMED);
+          // Clear busy but keep claimed: no task can claim the endpoint (and queue a transfer) while xfer_isr()
+          // consumes the endpoint buffer, xfer_isr() can queue the next transfer without claiming.
+          _usbd_dev.ep_status[epnum][ep_dir] &= (uint8_t) ~TU_EDPT_STATE_BUSY;
 
           send = !driver->xfer_isr(event->rhport, ep_addr, (xfer_result_t) event->xfer_complete.result, event->xfer_complete.len);
 
-          // xfer_isr() is deferred to xfer_cb(), revert busy/claimed status
           if (send) {
-            // set busy + claimed
-            _usbd_dev.ep_status[epnum][ep_dir] |= (TU_EDPT_STATE_BUSY | TU_EDPT_STATE_CLAIMED);
+            // xfer_isr() is deferred to xfer_cb(), revert busy status
+            _usbd_dev.ep_status[epnum][ep_dir] |= TU_EDPT_STATE_BUSY;
+          } else if (!(_usbd_dev.ep_status[epnum][ep_dir] & TU_EDPT_STATE_BUSY)) {
+            // no transfer is queued by xfer_isr(), release endpoint for task
+            _usbd_dev.ep_status[epnum][ep_dir] &= (uint8_t) ~TU_EDPT_STATE_CLAIMED;
           }
         }
       }
@@ -1642,6 +1868,9 @@ void usbd_edpt_stall(uint8_t rhport, uint8_t ep_addr) {
   TU_LOG_USBD("    Stall EP %02X\r\n", ep_addr);
   dcd_edpt_stall(rhport, ep_addr);
   _usbd_dev.ep_status[epnum][dir] |= (TU_EDPT_STATE_STALLED | TU_EDPT_STATE_BUSY);
+#if CFG_TUSB_STATS
+  _usbd_stats.edpt[epnum][dir].stall_count++;
+#endif
 }
 
 void usbd_edpt_clear_stall(uint8_t rhport, uint8_t ep_addr) {
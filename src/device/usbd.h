@@ -28,6 +28,7 @@
 #define TUSB_USBD_H_
 
 #include "common/tusb_common.h"
+#include "common/tusb_stats.h"
 
 #ifdef __cplusplus
 extern "C" {
@@ -99,6 +100,32 @@ void tud_task (void) {
 // Check if there is pending events need processing by tud_task()
 bool tud_task_event_ready(void);
 
+#if CFG_TUD_TASK_STATS
+typedef struct {
+  uint32_t event_count;    // events received from queue
+  uint32_t dispatch_count; // events processed after merging SOF, event_count/dispatch_count is the merge ratio
+  uint16_t queue_hwm;      // high-water mark of pending events in queue
+  uint16_t queue_size;     // CFG_TUD_TASK_QUEUE_SZ
+} tud_task_stats_t;
+
+// Get event queue statistics
+void tud_task_stats_get(tud_task_stats_t* stats);
+
+// Reset event queue statistics
+void tud_task_stats_reset(void);
+#endif
+
+#if CFG_TUSB_STATS
+// Get transfer statistics of an endpoint, NULL if endpoint number is out of range
+const tu_stats_edpt_t* tud_stats_edpt(uint8_t ep_addr);
+
+// Get latency histogram of control transfers, measured from SETUP processed to status stage completed
+const tu_stats_latency_t* tud_stats_control_latency(void);
+
+// Reset endpoint, control and event queue statistics
+void tud_stats_reset(void);
+#endif
+
 #ifndef TUSB_DCD_H_
 extern void dcd_int_handler(uint8_t rhport);
 #endif
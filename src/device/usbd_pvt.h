@@ -43,6 +43,8 @@
 typedef enum {
   SOF_CONSUMER_USER = 0,
   SOF_CONSUMER_AUDIO,
+  SOF_CONSUMER_NET,
+  SOF_CONSUMER_CDC,
 } sof_consumer_t;
 
 //--------------------------------------------------------------------+
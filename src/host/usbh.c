@@ -142,6 +142,10 @@ typedef struct {
 
   volatile uint8_t ep_status[CFG_TUH_ENDPOINT_MAX][2];
 
+#if CFG_TUSB_STATS
+  tu_stats_edpt_t ep_stats[CFG_TUH_ENDPOINT_MAX][2];
+#endif
+
 #if CFG_TUH_API_EDPT_XFER
   // TODO array can be CFG_TUH_ENDPOINT_MAX-1
   struct {
@@ -175,6 +179,19 @@ static OSAL_SPINLOCK_DEF(_usbh_spin, usbh_int_set);
 OSAL_QUEUE_DEF(usbh_int_set, _usbh_qdef, CFG_TUH_TASK_QUEUE_SZ, hcd_event_t);
 static osal_queue_t _usbh_q;
 
+#if CFG_TUH_TASK_STATS
+// queued and received counters, their difference is the number of pending events
+static struct {
+  volatile uint32_t queued;
+  volatile uint32_t received;
+  uint16_t hwm;
+} _usbh_qstats;
+#endif
+
+#if CFG_TUSB_STATS
+static tu_stats_latency_t _usbh_ctrl_latency;
+#endif
+
   #if CFG_TUH_HUB
 // Deferred attachment queue, only needed when using hub
 OSAL_QUEUE_DEF(usbh_int_set, _usbh_daqdef, CFG_TUH_HUB, hcd_event_t);
@@ -193,6 +210,9 @@ typedef struct {
   uint8_t daddr;
   volatile uint16_t actual_len;
   uint8_t failed_count;
+#if CFG_TUSB_STATS
+  uint32_t start_ms; // time when transfer is submitted, for latency
+#endif
 } usbh_ctrl_xfer_info_t;
 
 typedef struct {
@@ -347,11 +367,72 @@ TU_ATTR_ALWAYS_INLINE static inline bool is_hub_addr(uint8_t daddr) {
 }
 
 TU_ATTR_ALWAYS_INLINE static inline bool queue_event(hcd_event_t const * event, bool in_isr) {
-  TU_ASSERT(osal_queue_send(_usbh_q, event, in_isr));
+#if CFG_TUH_TASK_STATS
+  // count before sending since task may receive the event before osal_queue_send() returns
+  osal_spin_lock(&_usbh_spin, in_isr);
+  _usbh_qstats.queued++;
+  osal_spin_unlock(&_usbh_spin, in_isr);
+#endif
+
+  const bool sent = osal_queue_send(_usbh_q, event, in_isr);
+
+#if CFG_TUH_TASK_STATS
+  osal_spin_lock(&_usbh_spin, in_isr);
+  if (sent) {
+    const uint16_t pending = (uint16_t) (_usbh_qstats.queued - _usbh_qstats.received);
+    if (pending > _usbh_qstats.hwm) {
+      _usbh_qstats.hwm = pending;
+    }
+  } else {
+    _usbh_qstats.queued--;
+  }
+  osal_spin_unlock(&_usbh_spin, in_isr);
+#endif
+
+  TU_ASSERT(sent);
+
   tuh_event_hook_cb(event->rhport, event->event_id, in_isr);
   return true;
 }
 
+TU_ATTR_ALWAYS_INLINE static inline bool receive_event(hcd_event_t* event, uint32_t timeout_ms) {
+  TU_VERIFY(osal_queue_receive(_usbh_q, event, timeout_ms));
+#if CFG_TUH_TASK_STATS
+  osal_spin_lock(&_usbh_spin, false);
+  _usbh_qstats.received++;
+  osal_spin_unlock(&_usbh_spin, false);
+#endif
+  return true;
+}
+
+#if CFG_TUSB_TRACE_DEPTH
+static void trace_event(hcd_event_t const* event) {
+  uint8_t addr = event->dev_addr;
+  uint8_t ep_addr = 0;
+  uint8_t result = 0;
+  uint32_t len = 0;
+
+  switch (event->event_id) {
+    case HCD_EVENT_DEVICE_ATTACH:
+    case HCD_EVENT_DEVICE_REMOVE:
+      addr = event->connection.hub_addr;
+      ep_addr = event->connection.hub_port;
+      break;
+
+    case HCD_EVENT_XFER_COMPLETE:
+      ep_addr = event->xfer_complete.ep_addr;
+      result = event->xfer_complete.result;
+      len = event->xfer_complete.len;
+      break;
+
+    default:
+      break;
+  }
+
+  tu_trace_record(TU_TRACE_HOST | event->event_id, addr, ep_addr, result, len);
+}
+#endif
+
 TU_ATTR_ALWAYS_INLINE static inline void _control_set_xfer_stage(uint8_t stage) {
   if (_usbh_data.ctrl_xfer_info.stage != stage) {
     (void) osal_mutex_lock(_usbh_mutex, OSAL_TIMEOUT_WAIT_FOREVER);
@@ -516,6 +597,16 @@ bool tuh_rhport_init(uint8_t rhport, const tusb_rhport_init_t* rh_init) {
     _usbh_q = osal_queue_create(&_usbh_qdef);
     TU_ASSERT(_usbh_q != NULL);
 
+  #if CFG_TUH_TASK_STATS
+    tu_varclr(&_usbh_qstats);
+  #endif
+  #if CFG_TUSB_STATS
+    tu_varclr(&_usbh_ctrl_latency);
+  #endif
+  #if CFG_TUSB_TRACE_DEPTH
+    tu_trace_init();
+  #endif
+
   #if CFG_TUH_HUB
     // Deferred attachment queue
     _usbh_daq = osal_queue_create(&_usbh_daqdef);
@@ -627,6 +718,45 @@ bool tuh_task_event_ready(void) {
   return false;
 }
 
+#if CFG_TUH_TASK_STATS
+void tuh_task_stats_get(tuh_task_stats_t* stats) {
+  stats->event_count = _usbh_qstats.received;
+  stats->queue_hwm   = _usbh_qstats.hwm;
+  stats->queue_size  = CFG_TUH_TASK_QUEUE_SZ;
+}
+
+void tuh_task_stats_reset(void) {
+  osal_spin_lock(&_usbh_spin, false);
+  _usbh_qstats.queued   = _usbh_qstats.queued - _usbh_qstats.received; // keep pending events
+  _usbh_qstats.received = 0;
+  _usbh_qstats.hwm      = (uint16_t) _usbh_qstats.queued;
+  osal_spin_unlock(&_usbh_spin, false);
+}
+#endif
+
+#if CFG_TUSB_STATS
+const tu_stats_edpt_t* tuh_stats_edpt(uint8_t daddr, uint8_t ep_addr) {
+  usbh_device_t* dev = get_device(daddr);
+  const uint8_t epnum = tu_edpt_number(ep_addr);
+  TU_VERIFY(dev != NULL && epnum < CFG_TUH_ENDPOINT_MAX, NULL);
+  return &dev->ep_stats[epnum][tu_edpt_dir(ep_addr)];
+}
+
+const tu_stats_latency_t* tuh_stats_control_latency(void) {
+  return &_usbh_ctrl_latency;
+}
+
+void tuh_stats_reset(void) {
+  for (uint8_t i = 0; i < TOTAL_DEVICES; i++) {
+    tu_memclr(_usbh_devices[i].ep_stats, sizeof(_usbh_devices[i].ep_stats));
+  }
+  tu_varclr(&_usbh_ctrl_latency);
+#if CFG_TUH_TASK_STATS
+  tuh_task_stats_reset();
+#endif
+}
+#endif
+
 /* USB Host Driver task
  * This top level thread manages all host controller event and delegates events to class-specific drivers.
  * This should be called periodically within the mainloop or rtos thread.
@@ -696,11 +826,15 @@ void tuh_task_ext(uint32_t timeout_ms, bool in_isr) {
     if (!has_deferred_attach) // skip event queue to process deferred attach
   #endif
     {
-      if (!osal_queue_receive(_usbh_q, &event, timeout_ms)) {
+      if (!receive_event(&event, timeout_ms)) {
         return;
       }
     }
 
+  #if CFG_TUSB_TRACE_DEPTH
+    trace_event(&event);
+  #endif
+
     switch (event.event_id) {
       case HCD_EVENT_DEVICE_ATTACH:
         // Should we miss the hub detach event due to high traffic, Or due to physical debouncing, some devices can
@@ -747,6 +881,11 @@ void tuh_task_ext(uint32_t timeout_ms, bool in_isr) {
           // clear busy and claimed
           dev->ep_status[epnum][ep_dir] &= (uint8_t) ~(TU_EDPT_STATE_BUSY | TU_EDPT_STATE_CLAIMED);
 
+        #if CFG_TUSB_STATS
+          tu_stats_edpt_add(&dev->ep_stats[epnum][ep_dir], (xfer_result_t) event.xfer_complete.result,
+                            event.xfer_complete.len);
+        #endif
+
           if (0 == epnum) {
             usbh_control_xfer_cb(event.dev_addr, ep_addr, (xfer_result_t) event.xfer_complete.result, event.xfer_complete.len);
           } else {
@@ -832,6 +971,9 @@ bool tuh_control_xfer (tuh_xfer_t* xfer) {
     ctrl_info->complete_cb  = xfer->complete_cb;
     ctrl_info->user_data    = xfer->user_data;
     _usbh_epbuf.request     = (*xfer->setup);
+  #if CFG_TUSB_STATS
+    ctrl_info->start_ms     = tusb_time_millis_api();
+  #endif
   }
   (void) osal_mutex_unlock(_usbh_mutex);
 
@@ -891,6 +1033,10 @@ static void _control_xfer_complete(uint8_t daddr, xfer_result_t result) {
 
   _control_set_xfer_stage(CONTROL_STAGE_IDLE);
 
+#if CFG_TUSB_STATS
+  tu_stats_latency_add(&_usbh_ctrl_latency, tusb_time_millis_api() - ctrl_info->start_ms);
+#endif
+
   if (xfer_temp.complete_cb != NULL) {
     xfer_temp.complete_cb(&xfer_temp);
   }
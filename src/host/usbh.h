@@ -32,6 +32,7 @@
 #endif
 
 #include "common/tusb_common.h"
+#include "common/tusb_stats.h"
 
 #if CFG_TUH_MAX3421
 #include "portable/analog/max3421/hcd_max3421.h"
@@ -191,6 +192,31 @@ TU_ATTR_ALWAYS_INLINE static inline void tuh_task(void) {
 // Check if there is pending events need processing by tuh_task()
 bool tuh_task_event_ready(void);
 
+#if CFG_TUH_TASK_STATS
+typedef struct {
+  uint32_t event_count; // events received from queue
+  uint16_t queue_hwm;   // high-water mark of pending events in queue
+  uint16_t queue_size;  // CFG_TUH_TASK_QUEUE_SZ
+} tuh_task_stats_t;
+
+// Get event queue statistics
+void tuh_task_stats_get(tuh_task_stats_t* stats);
+
+// Reset event queue statistics
+void tuh_task_stats_reset(void);
+#endif
+
+#if CFG_TUSB_STATS
+// Get transfer statistics of a device endpoint, cleared when device is removed. NULL if address is invalid
+const tu_stats_edpt_t* tuh_stats_edpt(uint8_t daddr, uint8_t ep_addr);
+
+// Get latency histogram of control transfers, measured from submitted to completed (including retries)
+const tu_stats_latency_t* tuh_stats_control_latency(void);
+
+// Reset endpoint, control and event queue statistics of all devices
+void tuh_stats_reset(void);
+#endif
+
 #ifndef TUSB_HCD_H_
 extern void hcd_int_handler(uint8_t rhport, bool in_isr);
 #endif
@@ -43,6 +43,10 @@
 // Note: won't work if change to 0 (for now)
   #define FORCE_VBUS_DETECT 1
 
+  // Buffer control bit 27..28 (bit 11..12 of buffer 1 half): offset of buffer 1 for double buffered ISO endpoint,
+  // 128 << n bytes. Non-ISO endpoints always have buffer 1 at 64 bytes after buffer 0.
+  #define BUF1_CTRL_ISO_OFFSET_LSB 11
+
   #define USB_INTS_ERROR_BITS                                                                 \
     (USB_INTS_ERROR_DATA_SEQ_BITS | USB_INTS_ERROR_BIT_STUFF_BITS | USB_INTS_ERROR_CRC_BITS | \
      USB_INTS_ERROR_RX_OVERFLOW_BITS | USB_INTS_ERROR_RX_TIMEOUT_BITS)
@@ -92,6 +96,11 @@ static void hw_endpoint_open(uint8_t ep_addr, uint16_t wMaxPacketSize, uint8_t t
   ep->ep_addr         = ep_addr;
   ep->next_pid        = 0u;
   ep->max_packet_size = wMaxPacketSize;
+  ep->buf1_offset     = 0;
+  ep->buf1_ctrl       = 0;
+  ep->primed          = false;
+  ep->primed_next     = 0;
+  ep->primed_busy     = 0;
 
   // Clear existing buffer control state
   io_rw_32 *buf_reg = get_buf_ctrl(epnum, dir);
@@ -108,16 +117,36 @@ static void hw_endpoint_open(uint8_t ep_addr, uint16_t wMaxPacketSize, uint8_t t
     // round up size to multiple of 64
     uint16_t size = (uint16_t)tu_round_up(wMaxPacketSize, 64);
 
-    // double buffered Bulk endpoint
-    if (transfer_type == TUSB_XFER_BULK) {
+    if (transfer_type == TUSB_XFER_ISOCHRONOUS) {
+      // double buffered ISO endpoint: buffer 1 offset is 128, 256, 512 or 1024. Fall back to single buffer if there is
+      // not enough space left
+      uint16_t offset = 128;
+      while (offset < wMaxPacketSize) {
+        offset <<= 1;
+      }
+      const uint8_t *buf_end = usb_dpram->epx_data + sizeof(usb_dpram->epx_data);
+      if (offset <= 1024 && hw_buffer_ptr + 2 * offset <= buf_end) {
+        size                 = 2 * offset;
+        ep->buf1_offset      = offset;
+        ep->buf1_ctrl        = (uint16_t)((__builtin_ctz(offset) - 7) << BUF1_CTRL_ISO_OFFSET_LSB);
+      }
+    } else if (wMaxPacketSize <= 64) {
+      // double buffered Bulk and Interrupt endpoint, buffer 1 is at fixed 64 offset
       size *= 2u;
+      ep->buf1_offset = 64;
   #if CFG_TUSB_RP2_ERRATA_E15
-      if (dir == TUSB_DIR_IN) {
+      if (transfer_type == TUSB_XFER_BULK && dir == TUSB_DIR_IN) {
         ep->e15_bulk_in = true;
       }
   #endif
     }
 
+    // ISO/Interrupt IN keep both buffers primed, see primed_xfer_continue()
+    if (transfer_type != TUSB_XFER_BULK && dir == TUSB_DIR_IN && ep->buf1_offset != 0) {
+      ep->primed = true;
+      ep_ctrl |= EP_CTRL_DOUBLE_BUFFERED_BITS;
+    }
+
     // assign buffer
     ep->dpram_buf = hw_buffer_ptr;
     hw_buffer_ptr += size;
@@ -150,6 +179,8 @@ static void hw_endpoint_abort_xfer(struct hw_endpoint* ep) {
   io_rw_32 *buf_reg = get_buf_ctrl(epnum, dir);
   *buf_reg          = 0; // clear buffer control
   rp2usb_reset_transfer(ep);
+  ep->primed_next = 0;
+  ep->primed_busy = 0;
 
   if (rp2040_chip_version() >= 2) {
     usb_hw_clear->abort_done = abort_mask;
@@ -157,6 +188,76 @@ static void hw_endpoint_abort_xfer(struct hw_endpoint* ep) {
   }
 }
 
+//--------------------------------------------------------------------+
+// Primed ISO/Interrupt IN
+// Endpoint stays double buffered and both buffers are kept armed across transfers. A transfer completes as soon as
+// its last packet is copied into a hw buffer, so that class driver can queue the next one while previous packet is
+// still waiting for the host to poll. Controller alternates between buffer 0 and 1, primed_next follows it.
+//--------------------------------------------------------------------+
+
+// Arm free buffers with current transfer, return true if all of its data is armed i.e. transfer is complete.
+// Must be called with rp2usb lock held
+static bool __tusb_irq_path_func(primed_xfer_continue)(hw_endpoint_t *ep, io_rw_32 *buf_reg) {
+  while (ep->state == EPSTATE_ACTIVE && ep->primed_busy < 2) {
+    uint16_t buf_ctrl = 0;
+    if (ep->primed_busy == 0) {
+      // both buffers are idle: reset buffer selector to re-sync with controller
+      ep->primed_next = 0;
+      buf_ctrl        = USB_BUF_CTRL_SEL;
+    }
+
+    const uint8_t  buf_id    = ep->primed_next;
+    const uint16_t remaining = ep->remaining_len;
+    buf_ctrl |= bufctrl_prepare16(ep, ep->dpram_buf + (buf_id ? ep->buf1_offset : 0), false);
+    if (buf_id) {
+      buf_ctrl |= ep->buf1_ctrl;
+    }
+    ep->xferred_len += remaining - ep->remaining_len;
+
+    bufctrl_write16((io_rw_16 *)buf_reg + buf_id, buf_ctrl);
+    ep->primed_next ^= 1u;
+    ep->primed_busy++;
+
+    if (ep->remaining_len == 0) {
+      return true;
+    }
+  }
+
+  return false;
+}
+
+static void __tusb_irq_path_func(primed_xfer_complete)(hw_endpoint_t *ep, bool in_isr) {
+  const uint16_t xferred_len = ep->xferred_len;
+  rp2usb_reset_transfer(ep);
+  dcd_event_xfer_complete(0, ep->ep_addr, xferred_len, XFER_RESULT_SUCCESS, in_isr);
+}
+
+static void primed_xfer_start(hw_endpoint_t *ep, io_rw_32 *buf_reg, uint8_t *buffer, tu_fifo_t *ff,
+                              uint16_t total_bytes, bool is_isr) {
+  rp2usb_critical_enter();
+
+  ep->remaining_len = total_bytes;
+  ep->xferred_len   = 0;
+  ep->state         = EPSTATE_ACTIVE;
+  #if CFG_TUD_EDPT_DEDICATED_HWFIFO
+  ep->is_xfer_fifo = (ff != NULL);
+  if (ff != NULL) {
+    ep->user_fifo = ff;
+  } else
+  #endif
+  {
+    (void)ff;
+    ep->user_buf = buffer;
+  }
+
+  const bool is_done = primed_xfer_continue(ep, buf_reg);
+  if (is_done) {
+    primed_xfer_complete(ep, is_isr);
+  }
+
+  rp2usb_critical_exit();
+}
+
 static void __tusb_irq_path_func(handle_hw_buff_status)(void) {
   uint32_t buf_status = usb_hw->buf_status;
   pico_trace("buf_status = 0x%08lx\r\n", buf_status);
@@ -179,6 +280,19 @@ static void __tusb_irq_path_func(handle_hw_buff_status)(void) {
       usb_hw_clear->buf_status = bit;
       buf_status &= ~bit;
 
+      if (ep->primed) {
+        // a primed buffer is sent, re-arm it with pending transfer if any
+        rp2usb_critical_enter();
+        if (ep->primed_busy > 0) {
+          ep->primed_busy--;
+        }
+        if (primed_xfer_continue(ep, buf_reg)) {
+          primed_xfer_complete(ep, true);
+        }
+        rp2usb_critical_exit();
+        continue;
+      }
+
       if (rp2usb_xfer_continue(ep, ep_reg, buf_reg, buf_id, dir == TUSB_DIR_OUT)) {
         const uint16_t xferred_len = ep->xferred_len;
         rp2usb_reset_transfer(ep);
@@ -280,7 +394,7 @@ static void __tusb_irq_path_func(dcd_rp2040_irq)(void) {
             uint16_t buf0 = bufctrl_prepare16(ep, ep->dpram_buf, false);
             bufctrl_write16(buf_reg16, buf0);
           } else if (buf1_idle) {
-            uint16_t buf1 = bufctrl_prepare16(ep, ep->dpram_buf + 64, false);
+            uint16_t buf1 = bufctrl_prepare16(ep, ep->dpram_buf + ep->buf1_offset, false);
             bufctrl_write16(buf_reg16 + 1, buf1);
           }
         }
@@ -500,7 +614,7 @@ bool dcd_edpt_iso_activate(uint8_t rhport, const tusb_desc_endpoint_t *ep_desc)
   struct hw_endpoint *ep    = hw_endpoint_get(epnum, dir);
   TU_ASSERT(ep->dpram_buf != NULL); // must be inited and allocated previously
 
-  if (ep->state == EPSTATE_ACTIVE) {
+  if (ep->state == EPSTATE_ACTIVE || ep->primed_busy > 0) {
     hw_endpoint_abort_xfer(ep); // abort any pending transfer
   }
   ep->max_packet_size = ep_desc->wMaxPacketSize;
@@ -528,18 +642,28 @@ bool dcd_edpt_xfer(uint8_t rhport, uint8_t ep_addr, uint8_t *buffer, uint16_t to
   hw_endpoint_t *ep = hw_endpoint_get(epnum, dir);
   io_rw_32      *ep_reg  = get_ep_ctrl(epnum, dir);
   io_rw_32      *buf_reg = get_buf_ctrl(epnum, dir);
-  rp2usb_xfer_start(ep, ep_reg, buf_reg, buffer, NULL, total_bytes);
+  if (ep->primed) {
+    primed_xfer_start(ep, buf_reg, buffer, NULL, total_bytes, is_isr);
+  } else {
+    rp2usb_xfer_start(ep, ep_reg, buf_reg, buffer, NULL, total_bytes);
+  }
   return true;
 }
 
 #if CFG_TUD_EDPT_DEDICATED_HWFIFO
 bool dcd_edpt_xfer_fifo(uint8_t rhport, uint8_t ep_addr, tu_fifo_t *ff, uint16_t total_bytes, bool is_isr) {
   (void)rhport;
-  (void)is_isr;
+  const uint8_t    epnum = tu_edpt_number(ep_addr);
+  const tusb_dir_t dir   = tu_edpt_dir(ep_addr);
+
   hw_endpoint_t *ep = hw_endpoint_get(epnum, dir);
   io_rw_32      *ep_reg  = get_ep_ctrl(epnum, dir);
   io_rw_32      *buf_reg = get_buf_ctrl(epnum, dir);
-  rp2usb_xfer_start(ep, ep_reg, buf_reg, NULL, ff, total_bytes);
+  if (ep->primed) {
+    primed_xfer_start(ep, buf_reg, NULL, ff, total_bytes, is_isr);
+  } else {
+    rp2usb_xfer_start(ep, ep_reg, buf_reg, NULL, ff, total_bytes);
+  }
   return true;
 }
 #endif
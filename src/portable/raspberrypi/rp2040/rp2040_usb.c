@@ -195,15 +195,22 @@ void __tusb_irq_path_func(rp2usb_buffer_start)(hw_endpoint_t *ep, io_rw_32 *ep_r
   // Note: device EP0 does not have an endpoint control register
   if (ep_reg != NULL) {
     uint32_t ep_ctrl = *ep_reg;
+    bool force_single = false;
   #if CFG_TUH_ENABLED
-    const bool force_single = (rp2usb_is_host_mode() && ep->interrupt_num > 0);
-  #else
-    const bool force_single = false;
+    if (rp2usb_is_host_mode()) {
+      force_single = (ep->interrupt_num > 0);
+    }
+  #endif
+  #if CFG_TUD_ENABLED
+    if (!rp2usb_is_host_mode()) {
+      force_single = (ep->buf1_offset == 0); // only one buffer allocated
+    }
   #endif
 
     if (ep->remaining_len && !force_single) {
       // Use buffer 1 (double buffered) if there is still data
-      buf_ctrl |= (uint32_t)bufctrl_prepare16(ep, ep->dpram_buf + 64, is_rx) << 16;
+      const uint16_t buf1_ctrl = bufctrl_prepare16(ep, ep->dpram_buf + hw_buf1_offset(ep), is_rx) | hw_buf1_ctrl(ep);
+      buf_ctrl |= (uint32_t)buf1_ctrl << 16;
       ep_ctrl |= EP_CTRL_DOUBLE_BUFFERED_BITS;
     } else {
       // Only buf0 used: clear DOUBLE_BUFFERED so controller doesn't toggle buffer selector
@@ -251,7 +258,7 @@ void rp2usb_xfer_start(hw_endpoint_t *ep, io_rw_32 *ep_reg, io_rw_32 *buf_reg, u
   if (!is_host && ep->future_len > 0) {
     // Device only: previous short-packet abort saved data from the other buffer
     const uint8_t future_len = ep->future_len;
-    memcpy(ep->user_buf, ep->dpram_buf + (ep->future_bufid << 6), future_len);
+    memcpy(ep->user_buf, ep->dpram_buf + (ep->future_bufid ? ep->buf1_offset : 0), future_len);
     ep->xferred_len += future_len;
     ep->remaining_len -= future_len;
     ep->user_buf += future_len;
@@ -345,7 +352,7 @@ bool __tusb_irq_path_func(rp2usb_xfer_continue)(hw_endpoint_t *ep, io_rw_32 *ep_
     if (!(is_host && !is_double)) // E4 bug: incorrect buf_id, buffer data is still buf0
   #endif
     {
-      dpram_buf += 64; // buf1 offset
+      dpram_buf += hw_buf1_offset(ep);
     }
   }
 
@@ -426,7 +433,10 @@ bool __tusb_irq_path_func(rp2usb_xfer_continue)(hw_endpoint_t *ep, io_rw_32 *ep_
   #endif
     {
       // ping-pong: arm the completed buffer with new data
-      const uint16_t buf_ctrl16_new = bufctrl_prepare16(ep, dpram_buf, is_rx);
+      uint16_t buf_ctrl16_new = bufctrl_prepare16(ep, dpram_buf, is_rx);
+      if (buf_id) {
+        buf_ctrl16_new |= hw_buf1_ctrl(ep);
+      }
       bufctrl_write16(buf_reg16 + buf_id, buf_ctrl16_new);
     }
   }
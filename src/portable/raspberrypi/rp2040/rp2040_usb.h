@@ -106,6 +106,12 @@ typedef struct hw_endpoint {
 #if CFG_TUD_ENABLED
   uint8_t future_bufid; // which buffer holds next data
   uint8_t future_len;   // next data len
+
+  uint16_t buf1_offset; // double buffered: offset of buffer 1 from dpram_buf, 0 if only one buffer is allocated
+  uint16_t buf1_ctrl;   // double buffered ISO: buffer 1 offset bits in upper half of buffer control
+  bool     primed;      // ISO/Interrupt IN: hw buffers are kept armed across transfers
+  uint8_t  primed_next; // primed: buffer to arm next
+  uint8_t  primed_busy; // primed: number of armed buffers not sent yet
 #endif
 
 #if CFG_TUSB_RP2_ERRATA_E15
@@ -177,6 +183,28 @@ void bufctrl_write32(io_rw_32 *buf_reg, uint32_t value);
 void bufctrl_write16(io_rw_16 *buf_reg16, uint16_t value);
 uint16_t bufctrl_prepare16(hw_endpoint_t *ep, uint8_t *dpram_buf, bool is_rx);
 
+// Offset of buffer 1 from buffer 0 in double buffered mode
+TU_ATTR_ALWAYS_INLINE static inline uint16_t hw_buf1_offset(const hw_endpoint_t *ep) {
+#if CFG_TUD_ENABLED
+  if (!rp2usb_is_host_mode()) {
+    return ep->buf1_offset;
+  }
+#endif
+  (void) ep;
+  return 64;
+}
+
+// Extra bits for buffer 1 half of buffer control
+TU_ATTR_ALWAYS_INLINE static inline uint16_t hw_buf1_ctrl(const hw_endpoint_t *ep) {
+#if CFG_TUD_ENABLED
+  if (!rp2usb_is_host_mode()) {
+    return ep->buf1_ctrl;
+  }
+#endif
+  (void) ep;
+  return 0;
+}
+
 TU_ATTR_ALWAYS_INLINE static inline uintptr_t hw_data_offset(uint8_t *buf) {
   // Remove usb base from buffer pointer
   return (uintptr_t)buf ^ (uintptr_t)usb_dpram;
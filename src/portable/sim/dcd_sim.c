@@ -0,0 +1,392 @@
+/*
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2026 Ha Thach (tinyusb.org)
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ *
+ * This file is part of the TinyUSB stack.
+ */
+
+#include "tusb_option.h"
+
+#if CFG_TUD_ENABLED && CFG_TUD_SIM
+
+#include "device/dcd.h"
+#include "dcd_sim.h"
+
+//--------------------------------------------------------------------+
+// MACRO TYPEDEF CONSTANT ENUM DECLARATION
+//--------------------------------------------------------------------+
+typedef struct {
+  uint8_t   *buffer;
+  tu_fifo_t *ff;          // transfer is done with fifo if not NULL
+  uint16_t   total_len;
+  uint16_t   actual_len;
+  uint16_t   mps;
+  uint8_t    xfer_type;
+  bool       opened;
+  bool       active;
+  bool       stalled;
+} sim_xfer_t;
+
+typedef struct {
+  bool         connected;
+  bool         int_enabled;
+  bool         sof_enabled;
+  uint8_t      dev_addr;
+  tusb_speed_t speed;
+
+  sim_xfer_t           xfer[TUP_DCD_ENDPOINT_MAX][2];
+  tud_sim_edpt_stats_t stats[TUP_DCD_ENDPOINT_MAX][2];
+} dcd_sim_t;
+
+static dcd_sim_t _dcd_sim;
+
+TU_ATTR_ALWAYS_INLINE static inline sim_xfer_t *get_xfer(uint8_t ep_addr) {
+  return &_dcd_sim.xfer[tu_edpt_number(ep_addr)][tu_edpt_dir(ep_addr)];
+}
+
+TU_ATTR_ALWAYS_INLINE static inline tud_sim_edpt_stats_t *get_stats(uint8_t ep_addr) {
+  return &_dcd_sim.stats[tu_edpt_number(ep_addr)][tu_edpt_dir(ep_addr)];
+}
+
+static void edpt0_open(void) {
+  const uint16_t mps = CFG_TUD_ENDPOINT0_SIZE;
+  for (uint8_t dir = 0; dir < 2; dir++) {
+    sim_xfer_t *xfer = &_dcd_sim.xfer[0][dir];
+    tu_varclr(xfer);
+    xfer->mps       = mps;
+    xfer->xfer_type = TUSB_XFER_CONTROL;
+    xfer->opened    = true;
+  }
+}
+
+// Complete current transfer and notify the stack as if it was raised by the controller ISR
+static void xfer_complete(uint8_t rhport, uint8_t ep_addr, sim_xfer_t *xfer) {
+  tud_sim_edpt_stats_t *stats = get_stats(ep_addr);
+  stats->xfer_count++;
+
+  xfer->active = false;
+  dcd_event_xfer_complete(rhport, ep_addr, xfer->actual_len, XFER_RESULT_SUCCESS, true);
+}
+
+//--------------------------------------------------------------------+
+// Controller API
+//--------------------------------------------------------------------+
+bool dcd_init(uint8_t rhport, const tusb_rhport_init_t *rh_init) {
+  (void)rhport;
+  tu_varclr(&_dcd_sim);
+  _dcd_sim.speed = (rh_init->speed == TUSB_SPEED_AUTO) ? TUSB_SPEED_HIGH : rh_init->speed;
+  edpt0_open();
+  dcd_connect(rhport);
+  return true;
+}
+
+bool dcd_deinit(uint8_t rhport) {
+  (void)rhport;
+  tu_varclr(&_dcd_sim);
+  return true;
+}
+
+// Events are raised synchronously by the virtual host API, there is nothing pending here
+void dcd_int_handler(uint8_t rhport) {
+  (void)rhport;
+}
+
+void dcd_int_enable(uint8_t rhport) {
+  (void)rhport;
+  _dcd_sim.int_enabled = true;
+}
+
+void dcd_int_disable(uint8_t rhport) {
+  (void)rhport;
+  _dcd_sim.int_enabled = false;
+}
+
+// Receive Set Address request, mcu port must also include status IN response
+void dcd_set_address(uint8_t rhport, uint8_t dev_addr) {
+  // address takes effect after status stage, which is fine since virtual host is not address aware
+  _dcd_sim.dev_addr = dev_addr;
+  dcd_edpt_xfer(rhport, tu_edpt_addr(0, TUSB_DIR_IN), NULL, 0, false);
+}
+
+// Host resumes the bus right away
+void dcd_remote_wakeup(uint8_t rhport) {
+  dcd_event_bus_signal(rhport, DCD_EVENT_RESUME, true);
+}
+
+void dcd_connect(uint8_t rhport) {
+  (void)rhport;
+  _dcd_sim.connected = true;
+}
+
+void dcd_disconnect(uint8_t rhport) {
+  (void)rhport;
+  _dcd_sim.connected = false;
+}
+
+void dcd_sof_enable(uint8_t rhport, bool en) {
+  (void)rhport;
+  _dcd_sim.sof_enabled = en;
+}
+
+//--------------------------------------------------------------------+
+// Endpoint API
+//--------------------------------------------------------------------+
+bool dcd_edpt_open(uint8_t rhport, const tusb_desc_endpoint_t *desc_ep) {
+  (void)rhport;
+  const uint8_t ep_addr = desc_ep->bEndpointAddress;
+  TU_ASSERT(tu_edpt_number(ep_addr) < TUP_DCD_ENDPOINT_MAX);
+
+  sim_xfer_t *xfer = get_xfer(ep_addr);
+  tu_varclr(xfer);
+  xfer->mps       = tu_edpt_packet_size(desc_ep);
+  xfer->xfer_type = desc_ep->bmAttributes.xfer;
+  xfer->opened    = true;
+
+  return true;
+}
+
+void dcd_edpt_close_all(uint8_t rhport) {
+  (void)rhport;
+  for (uint8_t epnum = 1; epnum < TUP_DCD_ENDPOINT_MAX; epnum++) {
+    tu_varclr(&_dcd_sim.xfer[epnum][TUSB_DIR_OUT]);
+    tu_varclr(&_dcd_sim.xfer[epnum][TUSB_DIR_IN]);
+  }
+}
+
+// Simulated endpoint memory is unlimited, nothing to allocate
+bool dcd_edpt_iso_alloc(uint8_t rhport, uint8_t ep_addr, uint16_t largest_packet_size) {
+  (void)rhport;
+  (void)largest_packet_size;
+  TU_ASSERT(tu_edpt_number(ep_addr) < TUP_DCD_ENDPOINT_MAX);
+  return true;
+}
+
+bool dcd_edpt_iso_activate(uint8_t rhport, const tusb_desc_endpoint_t *desc_ep) {
+  return dcd_edpt_open(rhport, desc_ep);
+}
+
+bool dcd_edpt_xfer(uint8_t rhport, uint8_t ep_addr, uint8_t *buffer, uint16_t total_bytes, bool is_isr) {
+  (void)rhport;
+  (void)is_isr;
+  sim_xfer_t *xfer = get_xfer(ep_addr);
+  TU_ASSERT(xfer->opened);
+
+  xfer->buffer     = buffer;
+  xfer->ff         = NULL;
+  xfer->total_len  = total_bytes;
+  xfer->actual_len = 0;
+  xfer->active     = true;
+
+  return true;
+}
+
+bool dcd_edpt_xfer_fifo(uint8_t rhport, uint8_t ep_addr, tu_fifo_t *ff, uint16_t total_bytes, bool is_isr) {
+  (void)rhport;
+  (void)is_isr;
+  sim_xfer_t *xfer = get_xfer(ep_addr);
+  TU_ASSERT(xfer->opened);
+
+  xfer->buffer     = NULL;
+  xfer->ff         = ff;
+  xfer->total_len  = total_bytes;
+  xfer->actual_len = 0;
+  xfer->active     = true;
+
+  return true;
+}
+
+void dcd_edpt_stall(uint8_t rhport, uint8_t ep_addr) {
+  (void)rhport;
+  sim_xfer_t *xfer = get_xfer(ep_addr);
+  xfer->stalled    = true;
+  xfer->active     = false;
+}
+
+void dcd_edpt_clear_stall(uint8_t rhport, uint8_t ep_addr) {
+  (void)rhport;
+  sim_xfer_t *xfer = get_xfer(ep_addr);
+  xfer->stalled    = false;
+}
+
+//--------------------------------------------------------------------+
+// Virtual Host API
+//--------------------------------------------------------------------+
+void tud_sim_bus_reset(uint8_t rhport, tusb_speed_t speed) {
+  _dcd_sim.dev_addr = 0;
+  _dcd_sim.speed    = speed;
+  dcd_edpt_close_all(rhport);
+  edpt0_open();
+  dcd_event_bus_reset(rhport, speed, true);
+}
+
+void tud_sim_bus_signal(uint8_t rhport, dcd_eventid_t eid) {
+  TU_VERIFY(eid == DCD_EVENT_SUSPEND || eid == DCD_EVENT_RESUME || eid == DCD_EVENT_UNPLUGGED, );
+  if (eid == DCD_EVENT_UNPLUGGED) {
+    _dcd_sim.dev_addr = 0;
+    dcd_edpt_close_all(rhport);
+    edpt0_open();
+  }
+  dcd_event_bus_signal(rhport, eid, true);
+}
+
+void tud_sim_sof(uint8_t rhport, uint32_t frame_count) {
+  if (_dcd_sim.sof_enabled) {
+    dcd_event_sof(rhport, frame_count, true);
+  }
+}
+
+void tud_sim_setup_send(uint8_t rhport, const tusb_control_request_t *request) {
+  // SETUP always clears stall and cancels any on-going control transfer
+  edpt0_open();
+  dcd_event_setup_received(rhport, (const uint8_t *)request, true);
+}
+
+bool tud_sim_host_out(uint8_t rhport, uint8_t ep_addr, const void *data, uint16_t len, uint16_t *xferred) {
+  TU_VERIFY(tu_edpt_number(ep_addr) < TUP_DCD_ENDPOINT_MAX);
+  ep_addr              = tu_edpt_addr(tu_edpt_number(ep_addr), TUSB_DIR_OUT);
+  sim_xfer_t *xfer     = get_xfer(ep_addr);
+  tud_sim_edpt_stats_t *stats = get_stats(ep_addr);
+  const uint8_t *src   = (const uint8_t *)data;
+  uint16_t       count = 0;
+
+  if (xferred != NULL) {
+    *xferred = 0;
+  }
+
+  if (xfer->stalled) {
+    stats->stall_count++;
+    return false;
+  }
+
+  if (!xfer->active) {
+    stats->nak_count++;
+    return false;
+  }
+
+  // Split into packets, transfer completes with short packet or when total length is reached
+  while (1) {
+    const uint16_t remaining = (uint16_t)(xfer->total_len - xfer->actual_len);
+    const uint16_t pkt_len   = tu_min16(tu_min16((uint16_t)(len - count), xfer->mps), remaining);
+
+    if (pkt_len > 0) {
+      if (xfer->ff != NULL) {
+        tu_fifo_write_n(xfer->ff, src + count, pkt_len);
+      } else {
+        memcpy(xfer->buffer + xfer->actual_len, src + count, pkt_len);
+      }
+    }
+    xfer->actual_len = (uint16_t)(xfer->actual_len + pkt_len);
+    count            = (uint16_t)(count + pkt_len);
+
+    if (pkt_len < xfer->mps || xfer->actual_len == xfer->total_len) {
+      xfer_complete(rhport, ep_addr, xfer);
+      break;
+    }
+
+    if (count == len) {
+      break; // host has no more data, transfer remains queued
+    }
+  }
+
+  stats->byte_count += count;
+  if (xferred != NULL) {
+    *xferred = count;
+  }
+
+  return true;
+}
+
+bool tud_sim_host_in(uint8_t rhport, uint8_t ep_addr, void *buffer, uint16_t bufsize, uint16_t *xferred) {
+  TU_VERIFY(tu_edpt_number(ep_addr) < TUP_DCD_ENDPOINT_MAX);
+  ep_addr              = tu_edpt_addr(tu_edpt_number(ep_addr), TUSB_DIR_IN);
+  sim_xfer_t *xfer     = get_xfer(ep_addr);
+  tud_sim_edpt_stats_t *stats = get_stats(ep_addr);
+
+  if (xferred != NULL) {
+    *xferred = 0;
+  }
+
+  if (xfer->stalled) {
+    stats->stall_count++;
+    return false;
+  }
+
+  if (!xfer->active) {
+    stats->nak_count++;
+    return false;
+  }
+
+  // Host can only read whole packets unless this is the last (short) one
+  const uint16_t remaining = (uint16_t)(xfer->total_len - xfer->actual_len);
+  uint16_t       count     = remaining;
+  if (bufsize < remaining) {
+    count = (bufsize >= xfer->mps) ? (uint16_t)(bufsize - (bufsize % xfer->mps)) : bufsize;
+  }
+
+  if (count > 0) {
+    if (xfer->ff != NULL) {
+      tu_fifo_read_n(xfer->ff, buffer, count);
+    } else {
+      memcpy(buffer, xfer->buffer + xfer->actual_len, count);
+    }
+  }
+  xfer->actual_len = (uint16_t)(xfer->actual_len + count);
+
+  if (xfer->actual_len == xfer->total_len) {
+    xfer_complete(rhport, ep_addr, xfer);
+  }
+
+  stats->byte_count += count;
+  if (xferred != NULL) {
+    *xferred = count;
+  }
+
+  return true;
+}
+
+bool tud_sim_edpt_busy(uint8_t rhport, uint8_t ep_addr) {
+  (void)rhport;
+  return get_xfer(ep_addr)->active;
+}
+
+bool tud_sim_edpt_stalled(uint8_t rhport, uint8_t ep_addr) {
+  (void)rhport;
+  return get_xfer(ep_addr)->stalled;
+}
+
+uint8_t tud_sim_address(uint8_t rhport) {
+  (void)rhport;
+  return _dcd_sim.dev_addr;
+}
+
+const tud_sim_edpt_stats_t *tud_sim_edpt_stats(uint8_t rhport, uint8_t ep_addr) {
+  (void)rhport;
+  TU_VERIFY(tu_edpt_number(ep_addr) < TUP_DCD_ENDPOINT_MAX, NULL);
+  return get_stats(ep_addr);
+}
+
+void tud_sim_stats_reset(uint8_t rhport) {
+  (void)rhport;
+  tu_varclr(&_dcd_sim.stats);
+}
+
+#endif
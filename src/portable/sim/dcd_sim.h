@@ -0,0 +1,105 @@
+/*
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2026 Ha Thach (tinyusb.org)
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ *
+ * This file is part of the TinyUSB stack.
+ */
+#ifndef TUSB_DCD_SIM_H
+#define TUSB_DCD_SIM_H
+
+#include "device/dcd.h"
+
+#ifdef __cplusplus
+ extern "C" {
+#endif
+
+//--------------------------------------------------------------------+
+// Simulated device controller, enabled with CFG_TUD_SIM = 1 (CFG_TUSB_MCU = OPT_MCU_NONE).
+// The application plays the role of the USB host and drives the bus with the virtual host API below.
+// Events are generated synchronously as if they were raised by the controller ISR, the virtual host
+// must therefore run in the same thread as tud_task() or serialize with it.
+//
+//   tusb_rhport_init_t dev_init = { .role = TUSB_ROLE_DEVICE, .speed = TUSB_SPEED_HIGH };
+//   tusb_init(0, &dev_init);
+//   tud_sim_bus_reset(0, TUSB_SPEED_HIGH);
+//   tud_sim_setup_send(0, &set_address_req); tud_task();
+//   ...
+//   while (bench) {
+//     tud_sim_host_out(0, 0x02, buf, 512, &xferred);  // host -> device
+//     tud_task();
+//     tud_sim_host_in(0, 0x81, buf, 512, &xferred);   // device -> host
+//   }
+//--------------------------------------------------------------------+
+
+typedef struct {
+  uint32_t xfer_count; // number of completed transfers
+  uint32_t byte_count; // number of bytes moved on the bus
+  uint32_t nak_count;  // host attempts while no transfer was queued
+  uint32_t stall_count; // host attempts while endpoint was stalled
+} tud_sim_edpt_stats_t;
+
+//------------- Bus signalling -------------//
+
+// Issue a bus reset with the (negotiated) speed, EP0 is re-opened and device address is cleared
+void tud_sim_bus_reset(uint8_t rhport, tusb_speed_t speed);
+
+// Raise DCD_EVENT_SUSPEND, DCD_EVENT_RESUME or DCD_EVENT_UNPLUGGED
+void tud_sim_bus_signal(uint8_t rhport, dcd_eventid_t eid);
+
+// Start of frame, only forwarded to the stack when enabled with dcd_sof_enable()
+void tud_sim_sof(uint8_t rhport, uint32_t frame_count);
+
+//------------- Transactions -------------//
+
+// Inject a SETUP packet on EP0, any pending EP0 transfer is cancelled and stall is cleared
+void tud_sim_setup_send(uint8_t rhport, const tusb_control_request_t *request);
+
+// Host sends len bytes (split into max packet size) to an OUT endpoint. The queued transfer completes on short packet
+// or when its total length is reached. Return false if endpoint is NAKing (no transfer queued) or stalled.
+bool tud_sim_host_out(uint8_t rhport, uint8_t ep_addr, const void *data, uint16_t len, uint16_t *xferred);
+
+// Host reads up to bufsize bytes from an IN endpoint. The queued transfer completes once all its data is read.
+// Return false if endpoint is NAKing (no transfer queued) or stalled.
+bool tud_sim_host_in(uint8_t rhport, uint8_t ep_addr, void *buffer, uint16_t bufsize, uint16_t *xferred);
+
+// Check if device has queued a transfer on an endpoint
+bool tud_sim_edpt_busy(uint8_t rhport, uint8_t ep_addr);
+
+// Check if device has stalled an endpoint
+bool tud_sim_edpt_stalled(uint8_t rhport, uint8_t ep_addr);
+
+// Get current device address set by SET_ADDRESS
+uint8_t tud_sim_address(uint8_t rhport);
+
+//------------- Statistics -------------//
+
+// Get per endpoint counters, can be used with a host clock to compute bytes/events per second
+const tud_sim_edpt_stats_t *tud_sim_edpt_stats(uint8_t rhport, uint8_t ep_addr);
+
+// Reset all endpoint counters
+void tud_sim_stats_reset(uint8_t rhport);
+
+#ifdef __cplusplus
+ }
+#endif
+
+#endif
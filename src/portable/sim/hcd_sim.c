@@ -0,0 +1,1428 @@
+/*
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2026 Ha Thach (tinyusb.org)
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ *
+ * This file is part of the TinyUSB stack.
+ */
+
+#include "tusb_option.h"
+
+#if CFG_TUH_ENABLED && CFG_TUH_SIM
+
+#include "host/hcd.h"
+#include "host/usbh.h"
+#include "host/hub.h"
+#include "device/usbd.h" // descriptor templates for virtual devices
+#include "class/cdc/cdc.h"
+#include "class/hid/hid_device.h"
+#include "class/msc/msc.h"
+#include "class/audio/audio.h"
+#include "class/midi/midi.h"
+#include "hcd_sim.h"
+
+//--------------------------------------------------------------------+
+// MACRO TYPEDEF CONSTANT ENUM DECLARATION
+//--------------------------------------------------------------------+
+// address 0 + devices + hubs
+#define SIM_ADDR_COUNT (1 + CFG_TUH_DEVICE_MAX + CFG_TUH_HUB)
+
+typedef struct {
+  uint8_t *buffer;
+  uint16_t buflen;
+  uint16_t mps;
+  uint8_t  xfer_type;
+  uint8_t  interval;   // polling interval in frames for interrupt endpoint
+  uint32_t next_frame; // next frame interrupt endpoint is polled
+  bool     opened;
+  bool     active;
+} sim_edpt_t;
+
+// Control transfers are serialized by usbh, only one is in progress at a time
+typedef struct {
+  tusb_control_request_t request;
+  uint8_t  daddr;
+  uint8_t  new_addr;      // SET_ADDRESS takes effect after status stage
+  bool     setup_pending;
+  bool     handled;       // request is processed by device
+  bool     stalled;
+  uint16_t data_len;
+  uint8_t  data[CFG_TUH_SIM_CTRL_BUFSIZE];
+} sim_control_t;
+
+typedef struct {
+  bool              int_enabled;
+  uint32_t          frame;
+  tuh_sim_device_t *root;
+
+  sim_control_t ctrl;
+  sim_edpt_t    edpt[SIM_ADDR_COUNT][CFG_TUH_ENDPOINT_MAX][2];
+} hcd_sim_t;
+
+static hcd_sim_t _hcd_sim;
+
+static const tuh_sim_driver_t sim_hub_driver;
+
+TU_ATTR_ALWAYS_INLINE static inline uint32_t ep_halt_bit(uint8_t ep_addr) {
+  return TU_BIT(tu_edpt_number(ep_addr) + (tu_edpt_dir(ep_addr) == TUSB_DIR_IN ? 16 : 0));
+}
+
+TU_ATTR_ALWAYS_INLINE static inline uint16_t desc_config_len(const uint8_t *desc_config) {
+  return tu_le16toh(tu_unaligned_read16(desc_config + offsetof(tusb_desc_configuration_t, wTotalLength)));
+}
+
+//--------------------------------------------------------------------+
+// Virtual device helper
+//--------------------------------------------------------------------+
+
+// Find enabled device with address in the tree below dev. Address 0 is resolved with the bus info of the device
+// being enumerated since there can be an un-addressed device on each hub port.
+static tuh_sim_device_t *find_device(tuh_sim_device_t *dev, uint8_t daddr, const tuh_bus_info_t *bus_info) {
+  if (dev == NULL || !dev->enabled) {
+    return NULL;
+  }
+
+  if (dev->addr == daddr) {
+    if (daddr != 0) {
+      return dev;
+    }
+    const uint8_t hub_addr = dev->hub ? dev->hub->addr : 0;
+    if (hub_addr == bus_info->hub_addr && dev->hub_port == bus_info->hub_port) {
+      return dev;
+    }
+  }
+
+  if (dev->driver == &sim_hub_driver) {
+    tuh_sim_hub_t *hub = (tuh_sim_hub_t *)dev->param;
+    for (uint8_t i = 0; i < hub->port_count; i++) {
+      tuh_sim_device_t *found = find_device(hub->port[i].dev, daddr, bus_info);
+      if (found) {
+        return found;
+      }
+    }
+  }
+
+  return NULL;
+}
+
+static tuh_sim_device_t *get_device(uint8_t daddr) {
+  tuh_bus_info_t bus_info = {0};
+  if (daddr == 0) {
+    tuh_bus_info_get(0, &bus_info);
+  }
+  return find_device(_hcd_sim.root, daddr, &bus_info);
+}
+
+// Bus/port reset: device goes back to default state with address 0
+static void device_reset(tuh_sim_device_t *dev) {
+  dev->addr      = 0;
+  dev->cfg_num   = 0;
+  dev->ep_halted = 0;
+  dev->enabled   = true;
+  if (dev->driver->reset) {
+    dev->driver->reset(dev);
+  }
+}
+
+// Device is unplugged (or its upstream port is disabled), downstream devices of a hub become unreachable as well
+static void device_disable(tuh_sim_device_t *dev) {
+  dev->enabled = false;
+  if (dev->driver == &sim_hub_driver) {
+    tuh_sim_hub_t *hub = (tuh_sim_hub_t *)dev->param;
+    for (uint8_t i = 0; i < hub->port_count; i++) {
+      hub->port[i].enabled = false;
+      if (hub->port[i].dev) {
+        device_disable(hub->port[i].dev);
+      }
+    }
+  }
+}
+
+static int32_t string_descriptor(const tuh_sim_device_t *dev, uint8_t index, uint8_t *data) {
+  if (index == 0) {
+    data[0] = 4;
+    data[1] = TUSB_DESC_STRING;
+    tu_unaligned_write16(data + 2, tu_htole16(0x0409));
+    return 4;
+  }
+
+  if (dev->strings == NULL || index > dev->string_count) {
+    return TUH_SIM_STALL;
+  }
+
+  const char *str       = dev->strings[index - 1];
+  const size_t char_max = (TU_MIN(CFG_TUH_SIM_CTRL_BUFSIZE, 255) - 2) / 2;
+  const size_t count    = TU_MIN(strlen(str), char_max);
+  for (size_t i = 0; i < count; i++) {
+    data[2 + 2 * i]     = (uint8_t)str[i];
+    data[2 + 2 * i + 1] = 0;
+  }
+  data[0] = (uint8_t)(2 + 2 * count);
+  data[1] = TUSB_DESC_STRING;
+  return data[0];
+}
+
+// Answer standard requests from descriptors, the rest is forwarded to virtual device driver
+static int32_t device_control(tuh_sim_device_t *dev, const tusb_control_request_t *request, uint8_t *data) {
+  const tuh_sim_driver_t *driver = dev->driver;
+
+  if (request->bmRequestType_bit.type == TUSB_REQ_TYPE_STANDARD) {
+    switch (request->bmRequestType_bit.recipient) {
+      case TUSB_REQ_RCPT_DEVICE:
+        switch (request->bRequest) {
+          case TUSB_REQ_GET_STATUS:
+            data[0] = data[1] = 0;
+            return 2;
+
+          case TUSB_REQ_CLEAR_FEATURE:
+          case TUSB_REQ_SET_FEATURE:
+            return 0;
+
+          case TUSB_REQ_SET_ADDRESS:
+            _hcd_sim.ctrl.new_addr = (uint8_t)request->wValue;
+            return 0;
+
+          case TUSB_REQ_GET_CONFIGURATION:
+            data[0] = dev->cfg_num;
+            return 1;
+
+          case TUSB_REQ_SET_CONFIGURATION:
+            dev->cfg_num = (uint8_t)request->wValue;
+            return 0;
+
+          case TUSB_REQ_GET_DESCRIPTOR: {
+            const uint8_t desc_type  = tu_u16_high(request->wValue);
+            const uint8_t desc_index = tu_u16_low(request->wValue);
+            switch (desc_type) {
+              case TUSB_DESC_DEVICE:
+                memcpy(data, dev->desc_device, sizeof(tusb_desc_device_t));
+                return sizeof(tusb_desc_device_t);
+
+              case TUSB_DESC_CONFIGURATION: {
+                const uint16_t total_len = desc_config_len(dev->desc_config);
+                TU_ASSERT(total_len <= CFG_TUH_SIM_CTRL_BUFSIZE, TUH_SIM_STALL);
+                memcpy(data, dev->desc_config, total_len);
+                return total_len;
+              }
+
+              case TUSB_DESC_STRING:
+                return string_descriptor(dev, desc_index, data);
+
+              default:
+                return TUH_SIM_STALL;
+            }
+          }
+
+          default:
+            return TUH_SIM_STALL;
+        }
+
+      case TUSB_REQ_RCPT_INTERFACE:
+        switch (request->bRequest) {
+          case TUSB_REQ_GET_STATUS:
+            data[0] = data[1] = 0;
+            return 2;
+
+          case TUSB_REQ_GET_INTERFACE:
+            data[0] = 0;
+            return 1;
+
+          case TUSB_REQ_SET_INTERFACE:
+            return 0;
+
+          default:
+            break; // e.g HID report descriptor is handled by driver
+        }
+        break;
+
+      case TUSB_REQ_RCPT_ENDPOINT: {
+        const uint8_t ep_addr = tu_u16_low(request->wIndex);
+        switch (request->bRequest) {
+          case TUSB_REQ_GET_STATUS:
+            data[0] = (dev->ep_halted & ep_halt_bit(ep_addr)) ? 1 : 0;
+            data[1] = 0;
+            return 2;
+
+          case TUSB_REQ_CLEAR_FEATURE:
+            if (request->wValue == TUSB_REQ_FEATURE_EDPT_HALT) {
+              dev->ep_halted &= ~ep_halt_bit(ep_addr);
+            }
+            return 0;
+
+          case TUSB_REQ_SET_FEATURE:
+            if (request->wValue == TUSB_REQ_FEATURE_EDPT_HALT) {
+              dev->ep_halted |= ep_halt_bit(ep_addr);
+            }
+            return 0;
+
+          default:
+            return TUH_SIM_STALL;
+        }
+      }
+
+      default:
+        break;
+    }
+  }
+
+  return driver->control ? driver->control(dev, request, data) : TUH_SIM_STALL;
+}
+
+//--------------------------------------------------------------------+
+// Transfer processing
+//--------------------------------------------------------------------+
+
+// Complete transfer and notify the stack as if it was raised by the controller ISR
+static void xfer_complete(tuh_sim_device_t *dev, uint8_t daddr, uint8_t ep_addr, uint16_t len, xfer_result_t result,
+                          bool in_isr) {
+  _hcd_sim.edpt[daddr][tu_edpt_number(ep_addr)][tu_edpt_dir(ep_addr)].active = false;
+
+  if (dev) {
+    if (result == XFER_RESULT_STALLED) {
+      dev->stats.stall_count++;
+    } else {
+      dev->stats.xfer_count++;
+      dev->stats.byte_count += len;
+    }
+  }
+
+  hcd_event_xfer_complete(daddr, ep_addr, len, result, in_isr);
+}
+
+static void control_request(tuh_sim_device_t *dev) {
+  sim_control_t *ctrl = &_hcd_sim.ctrl;
+  const int32_t  ret  = device_control(dev, &ctrl->request, ctrl->data);
+
+  ctrl->handled = true;
+  if (ret < 0) {
+    ctrl->stalled  = true;
+    ctrl->data_len = 0;
+  } else {
+    ctrl->data_len = (uint16_t)TU_MIN((uint32_t)ret, ctrl->request.wLength);
+  }
+}
+
+static void control_setup_process(bool in_isr) {
+  sim_control_t    *ctrl = &_hcd_sim.ctrl;
+  tuh_sim_device_t *dev  = get_device(ctrl->daddr);
+  ctrl->setup_pending    = false;
+
+  if (dev == NULL) {
+    // no device responds: transaction error
+    xfer_complete(NULL, ctrl->daddr, 0, 0, XFER_RESULT_FAILED, in_isr);
+    return;
+  }
+
+  dev->stats.setup_count++;
+
+  // OUT request with data is processed once its data stage is received
+  if (ctrl->request.bmRequestType_bit.direction == TUSB_DIR_IN || ctrl->request.wLength == 0) {
+    control_request(dev);
+  }
+
+  // SETUP is always ACKed, stall is reported in data/status stage
+  xfer_complete(dev, ctrl->daddr, 0, 8, XFER_RESULT_SUCCESS, in_isr);
+}
+
+static void control_xfer_process(uint8_t daddr, uint8_t dir, sim_edpt_t *ep, bool in_isr) {
+  sim_control_t    *ctrl    = &_hcd_sim.ctrl;
+  tuh_sim_device_t *dev     = get_device(daddr);
+  const uint8_t     ep_addr = tu_edpt_addr(0, dir);
+
+  if (dev == NULL || daddr != ctrl->daddr) {
+    xfer_complete(dev, daddr, ep_addr, 0, XFER_RESULT_FAILED, in_isr);
+    return;
+  }
+
+  uint16_t xferred = 0;
+  if (ep->buflen > 0 && dir == ctrl->request.bmRequestType_bit.direction) {
+    // Data stage
+    if (dir == TUSB_DIR_OUT) {
+      const uint16_t len = TU_MIN(ep->buflen, CFG_TUH_SIM_CTRL_BUFSIZE);
+      memcpy(ctrl->data, ep->buffer, len);
+      control_request(dev);
+      xferred = ep->buflen;
+    } else {
+      xferred = TU_MIN(ep->buflen, ctrl->data_len);
+      memcpy(ep->buffer, ctrl->data, xferred);
+    }
+  } else if (!ctrl->stalled && ctrl->new_addr) {
+    // Status stage of SET_ADDRESS
+    dev->addr       = ctrl->new_addr;
+    ctrl->new_addr  = 0;
+  }
+
+  if (ctrl->stalled) {
+    xfer_complete(dev, daddr, ep_addr, 0, XFER_RESULT_STALLED, in_isr);
+  } else {
+    xfer_complete(dev, daddr, ep_addr, xferred, XFER_RESULT_SUCCESS, in_isr);
+  }
+}
+
+static void edpt_xfer_process(uint8_t daddr, uint8_t ep_addr, sim_edpt_t *ep, bool in_isr) {
+  if (ep->xfer_type == TUSB_XFER_INTERRUPT) {
+    if ((int32_t)(_hcd_sim.frame - ep->next_frame) < 0) {
+      return; // not yet polling interval
+    }
+    ep->next_frame = _hcd_sim.frame + ep->interval;
+  }
+
+  tuh_sim_device_t *dev = get_device(daddr);
+  if (dev == NULL) {
+    xfer_complete(NULL, daddr, ep_addr, 0, XFER_RESULT_FAILED, in_isr);
+    return;
+  }
+
+  if (dev->ep_halted & ep_halt_bit(ep_addr)) {
+    xfer_complete(dev, daddr, ep_addr, 0, XFER_RESULT_STALLED, in_isr);
+    return;
+  }
+
+  const int32_t ret = dev->driver->xfer ? dev->driver->xfer(dev, ep_addr, ep->buffer, ep->buflen) : TUH_SIM_STALL;
+  if (ret == TUH_SIM_NAK) {
+    dev->stats.nak_count++;
+  } else if (ret < 0) {
+    dev->ep_halted |= ep_halt_bit(ep_addr);
+    xfer_complete(dev, daddr, ep_addr, 0, XFER_RESULT_STALLED, in_isr);
+  } else {
+    xfer_complete(dev, daddr, ep_addr, (uint16_t)TU_MIN((uint32_t)ret, ep->buflen), XFER_RESULT_SUCCESS, in_isr);
+  }
+}
+
+//--------------------------------------------------------------------+
+// Root port API
+//--------------------------------------------------------------------+
+bool tuh_sim_attach(uint8_t rhport, tuh_sim_device_t *dev) {
+  TU_VERIFY(_hcd_sim.root == NULL && dev != NULL);
+  dev->hub       = NULL;
+  dev->hub_port  = 0;
+  dev->enabled   = false; // until port is reset
+  _hcd_sim.root = dev;
+  hcd_event_device_attach(rhport, true);
+  return true;
+}
+
+void tuh_sim_detach(uint8_t rhport) {
+  TU_VERIFY(_hcd_sim.root != NULL,);
+  device_disable(_hcd_sim.root);
+  _hcd_sim.root = NULL;
+  hcd_event_device_remove(rhport, true);
+}
+
+tuh_sim_device_t *tuh_sim_root(uint8_t rhport) {
+  (void)rhport;
+  return _hcd_sim.root;
+}
+
+//--------------------------------------------------------------------+
+// Controller API
+//--------------------------------------------------------------------+
+bool hcd_init(uint8_t rhport, const tusb_rhport_init_t *rh_init) {
+  (void)rhport;
+  (void)rh_init;
+  tuh_sim_device_t *root = _hcd_sim.root; // device can be plugged before stack is initialized
+  tu_varclr(&_hcd_sim);
+  _hcd_sim.root = root;
+  return true;
+}
+
+bool hcd_deinit(uint8_t rhport) {
+  (void)rhport;
+  tu_varclr(&_hcd_sim);
+  return true;
+}
+
+// One frame on the bus: all pending transfers are serviced once
+void hcd_int_handler(uint8_t rhport, bool in_isr) {
+  (void)rhport;
+  if (!_hcd_sim.int_enabled) {
+    return;
+  }
+
+  _hcd_sim.frame++;
+
+  if (_hcd_sim.ctrl.setup_pending) {
+    control_setup_process(in_isr);
+  }
+
+  for (uint8_t daddr = 0; daddr < SIM_ADDR_COUNT; daddr++) {
+    for (uint8_t epnum = 0; epnum < CFG_TUH_ENDPOINT_MAX; epnum++) {
+      for (uint8_t dir = 0; dir < 2; dir++) {
+        sim_edpt_t *ep = &_hcd_sim.edpt[daddr][epnum][dir];
+        if (!ep->active) {
+          continue;
+        }
+
+        if (epnum == 0) {
+          control_xfer_process(daddr, dir, ep, in_isr);
+        } else {
+          edpt_xfer_process(daddr, tu_edpt_addr(epnum, dir), ep, in_isr);
+        }
+      }
+    }
+  }
+}
+
+void hcd_int_enable(uint8_t rhport) {
+  (void)rhport;
+  _hcd_sim.int_enabled = true;
+}
+
+void hcd_int_disable(uint8_t rhport) {
+  (void)rhport;
+  _hcd_sim.int_enabled = false;
+}
+
+uint32_t hcd_frame_number(uint8_t rhport) {
+  (void)rhport;
+  return _hcd_sim.frame;
+}
+
+//--------------------------------------------------------------------+
+// Port API
+//--------------------------------------------------------------------+
+bool hcd_port_connect_status(uint8_t rhport) {
+  (void)rhport;
+  return _hcd_sim.root != NULL;
+}
+
+void hcd_port_reset(uint8_t rhport) {
+  (void)rhport;
+  if (_hcd_sim.root) {
+    device_reset(_hcd_sim.root);
+    _hcd_sim.root->enabled = false; // enabled when reset ends
+  }
+}
+
+void hcd_port_reset_end(uint8_t rhport) {
+  (void)rhport;
+  if (_hcd_sim.root) {
+    _hcd_sim.root->enabled = true;
+  }
+}
+
+tusb_speed_t hcd_port_speed_get(uint8_t rhport) {
+  (void)rhport;
+  return _hcd_sim.root ? (tusb_speed_t)_hcd_sim.root->speed : TUSB_SPEED_FULL;
+}
+
+void hcd_device_close(uint8_t rhport, uint8_t dev_addr) {
+  (void)rhport;
+  TU_VERIFY(dev_addr < SIM_ADDR_COUNT,);
+  tu_memclr(_hcd_sim.edpt[dev_addr], sizeof(_hcd_sim.edpt[dev_addr]));
+  if (_hcd_sim.ctrl.daddr == dev_addr) {
+    _hcd_sim.ctrl.setup_pending = false;
+  }
+}
+
+//--------------------------------------------------------------------+
+// Endpoints API
+//--------------------------------------------------------------------+
+bool hcd_edpt_open(uint8_t rhport, uint8_t daddr, const tusb_desc_endpoint_t *ep_desc) {
+  (void)rhport;
+  const uint8_t epnum = tu_edpt_number(ep_desc->bEndpointAddress);
+  TU_ASSERT(daddr < SIM_ADDR_COUNT && epnum < CFG_TUH_ENDPOINT_MAX);
+
+  tuh_bus_info_t bus_info;
+  tuh_bus_info_get(daddr, &bus_info);
+
+  const uint8_t xfer_type = ep_desc->bmAttributes.xfer;
+  uint32_t      interval  = 1;
+  if (xfer_type == TUSB_XFER_INTERRUPT && ep_desc->bInterval > 0) {
+    // high speed interval is 2^(bInterval-1) micro-frames
+    interval = (bus_info.speed == TUSB_SPEED_HIGH) ? ((1u << (TU_MIN(ep_desc->bInterval, 16) - 1)) / 8)
+                                                   : ep_desc->bInterval;
+  }
+
+  // control endpoint is bi-directional
+  for (uint8_t dir = 0; dir < 2; dir++) {
+    if (epnum != 0 && dir != tu_edpt_dir(ep_desc->bEndpointAddress)) {
+      continue;
+    }
+    sim_edpt_t *ep = &_hcd_sim.edpt[daddr][epnum][dir];
+    tu_varclr(ep);
+    ep->mps       = tu_edpt_packet_size(ep_desc);
+    ep->xfer_type = xfer_type;
+    ep->interval  = (uint8_t)TU_MIN(TU_MAX(interval, 1), 255);
+    ep->opened    = true;
+  }
+
+  return true;
+}
+
+bool hcd_edpt_close(uint8_t rhport, uint8_t daddr, uint8_t ep_addr) {
+  (void)rhport;
+  TU_VERIFY(daddr < SIM_ADDR_COUNT && tu_edpt_number(ep_addr) < CFG_TUH_ENDPOINT_MAX);
+  tu_varclr(&_hcd_sim.edpt[daddr][tu_edpt_number(ep_addr)][tu_edpt_dir(ep_addr)]);
+  return true;
+}
+
+bool hcd_edpt_xfer(uint8_t rhport, uint8_t daddr, uint8_t ep_addr, uint8_t *buffer, uint16_t buflen) {
+  (void)rhport;
+  TU_ASSERT(daddr < SIM_ADDR_COUNT && tu_edpt_number(ep_addr) < CFG_TUH_ENDPOINT_MAX);
+  sim_edpt_t *ep = &_hcd_sim.edpt[daddr][tu_edpt_number(ep_addr)][tu_edpt_dir(ep_addr)];
+  TU_ASSERT(ep->opened);
+
+  ep->buffer     = buffer;
+  ep->buflen     = buflen;
+  ep->next_frame = _hcd_sim.frame + 1;
+  ep->active     = true;
+  return true;
+}
+
+bool hcd_edpt_abort_xfer(uint8_t rhport, uint8_t dev_addr, uint8_t ep_addr) {
+  (void)rhport;
+  TU_VERIFY(dev_addr < SIM_ADDR_COUNT && tu_edpt_number(ep_addr) < CFG_TUH_ENDPOINT_MAX);
+  _hcd_sim.edpt[dev_addr][tu_edpt_number(ep_addr)][tu_edpt_dir(ep_addr)].active = false;
+  return true;
+}
+
+bool hcd_setup_send(uint8_t rhport, uint8_t daddr, const uint8_t setup_packet[8]) {
+  (void)rhport;
+  TU_ASSERT(daddr < SIM_ADDR_COUNT);
+  sim_control_t *ctrl = &_hcd_sim.ctrl;
+
+  memcpy(&ctrl->request, setup_packet, 8);
+  ctrl->daddr         = daddr;
+  ctrl->new_addr      = 0;
+  ctrl->handled       = false;
+  ctrl->stalled       = false;
+  ctrl->data_len      = 0;
+  ctrl->setup_pending = true;
+
+  // new SETUP cancels any data/status stage in progress
+  _hcd_sim.edpt[daddr][0][0].active = false;
+  _hcd_sim.edpt[daddr][0][1].active = false;
+  return true;
+}
+
+// data toggle is not simulated, device side halt is cleared by CLEAR_FEATURE request
+bool hcd_edpt_clear_stall(uint8_t rhport, uint8_t dev_addr, uint8_t ep_addr) {
+  (void)rhport;
+  (void)dev_addr;
+  (void)ep_addr;
+  return true;
+}
+
+//--------------------------------------------------------------------+
+// Virtual Devices
+//--------------------------------------------------------------------+
+#define SIM_VID 0xCafe
+
+#define SIM_DESC_DEVICE(_class, _subclass, _protocol, _vid, _pid, _bcd) \
+  {                                                                     \
+    .bLength            = sizeof(tusb_desc_device_t),                   \
+    .bDescriptorType    = TUSB_DESC_DEVICE,                             \
+    .bcdUSB             = 0x0200,                                       \
+    .bDeviceClass       = _class,                                       \
+    .bDeviceSubClass    = _subclass,                                    \
+    .bDeviceProtocol    = _protocol,                                    \
+    .bMaxPacketSize0    = 64,                                           \
+    .idVendor           = _vid,                                         \
+    .idProduct          = _pid,                                         \
+    .bcdDevice          = _bcd,                                         \
+    .iManufacturer      = 1,                                            \
+    .iProduct           = 2,                                            \
+    .iSerialNumber      = 3,                                            \
+    .bNumConfigurations = 1                                             \
+  }
+
+static void sim_device_init(tuh_sim_device_t *dev, const tuh_sim_driver_t *driver, const tusb_desc_device_t *desc_device,
+                            const uint8_t *desc_config, const char *const *strings, uint8_t string_count,
+                            tusb_speed_t speed, void *param) {
+  tu_memclr(dev, sizeof(tuh_sim_device_t));
+  dev->driver       = driver;
+  dev->desc_device  = desc_device;
+  dev->desc_config  = desc_config;
+  dev->strings      = strings;
+  dev->string_count = string_count;
+  dev->speed        = (uint8_t)speed;
+  dev->param        = param;
+  if (driver->reset) {
+    driver->reset(dev);
+  }
+}
+
+//------------- Hub -------------//
+enum {
+  SIM_HUB_PORT_STATUS_CONNECTION = TU_BIT(0),
+  SIM_HUB_PORT_STATUS_ENABLE     = TU_BIT(1),
+  SIM_HUB_PORT_STATUS_SUSPEND    = TU_BIT(2),
+  SIM_HUB_PORT_STATUS_RESET      = TU_BIT(4),
+  SIM_HUB_PORT_STATUS_POWER      = TU_BIT(8),
+  SIM_HUB_PORT_STATUS_LOW_SPEED  = TU_BIT(9),
+  SIM_HUB_PORT_STATUS_HIGH_SPEED = TU_BIT(10),
+};
+
+static const tusb_desc_device_t sim_hub_desc_device[2] = {
+  SIM_DESC_DEVICE(TUSB_CLASS_HUB, 0, HUB_PROTOCOL_FULL_SPEED, SIM_VID, 0x4001, 0x0100),
+  SIM_DESC_DEVICE(TUSB_CLASS_HUB, 0, HUB_PROTOCOL_HIGH_SPEED_STT, SIM_VID, 0x4001, 0x0100),
+};
+
+#define SIM_HUB_CONFIG(_interval)                                                 \
+  { TUD_CONFIG_DESCRIPTOR(1, 1, 0, TUD_CONFIG_DESC_LEN + 9 + 7, 0, 100),          \
+    9, TUSB_DESC_INTERFACE, 0, 0, 1, TUSB_CLASS_HUB, 0, 0, 0,                     \
+    7, TUSB_DESC_ENDPOINT, 0x81, TUSB_XFER_INTERRUPT, U16_TO_U8S_LE(1), _interval }
+
+// 255 ms for full speed, 2^(12-1) micro-frames = 256 ms for high speed
+static const uint8_t sim_hub_desc_config[2][TUD_CONFIG_DESC_LEN + 9 + 7] = {SIM_HUB_CONFIG(255), SIM_HUB_CONFIG(12)};
+
+static const char *const sim_hub_strings[] = {"TinyUSB", "Simulated Hub", "000001"};
+
+static uint16_t sim_hub_port_status(const tuh_sim_hub_port_t *port) {
+  uint16_t status = 0;
+  if (port->powered) {
+    status |= SIM_HUB_PORT_STATUS_POWER;
+    if (port->dev) {
+      status |= SIM_HUB_PORT_STATUS_CONNECTION;
+      if (port->dev->speed == TUSB_SPEED_LOW) {
+        status |= SIM_HUB_PORT_STATUS_LOW_SPEED;
+      } else if (port->dev->speed == TUSB_SPEED_HIGH) {
+        status |= SIM_HUB_PORT_STATUS_HIGH_SPEED;
+      }
+    }
+    if (port->enabled) {
+      status |= SIM_HUB_PORT_STATUS_ENABLE;
+    }
+    if (port->suspended) {
+      status |= SIM_HUB_PORT_STATUS_SUSPEND;
+    }
+  }
+  return status;
+}
+
+static void sim_hub_reset(tuh_sim_device_t *dev) {
+  tuh_sim_hub_t *hub = (tuh_sim_hub_t *)dev->param;
+  for (uint8_t i = 0; i < hub->port_count; i++) {
+    tuh_sim_hub_port_t *port = &hub->port[i];
+    port->powered   = false;
+    port->enabled   = false;
+    port->suspended = false;
+    port->change    = 0;
+    if (port->dev) {
+      device_disable(port->dev);
+    }
+  }
+}
+
+static int32_t sim_hub_port_feature(tuh_sim_hub_t *hub, tuh_sim_hub_port_t *port, uint8_t bRequest, uint16_t feature) {
+  (void)hub;
+  const bool set = (bRequest == HUB_REQUEST_SET_FEATURE);
+
+  switch (feature) {
+    case HUB_FEATURE_PORT_POWER:
+      if (set && !port->powered && port->dev) {
+        port->change |= SIM_HUB_PORT_STATUS_CONNECTION; // connection is detected once port is powered
+      }
+      port->powered = set;
+      if (!set && port->dev) {
+        port->enabled = false;
+        device_disable(port->dev);
+      }
+      break;
+
+    case HUB_FEATURE_PORT_RESET:
+      // reset completes immediately
+      if (set && port->powered && port->dev) {
+        device_reset(port->dev);
+        port->enabled   = true;
+        port->suspended = false;
+        port->change |= SIM_HUB_PORT_STATUS_RESET;
+      }
+      break;
+
+    case HUB_FEATURE_PORT_ENABLE:
+      if (!set && port->dev) {
+        port->enabled = false;
+        device_disable(port->dev);
+      }
+      break;
+
+    case HUB_FEATURE_PORT_SUSPEND:
+      port->suspended = set && port->enabled;
+      break;
+
+    case HUB_FEATURE_PORT_CONNECTION_CHANGE:
+    case HUB_FEATURE_PORT_ENABLE_CHANGE:
+    case HUB_FEATURE_PORT_SUSPEND_CHANGE:
+    case HUB_FEATURE_PORT_OVER_CURRENT_CHANGE:
+    case HUB_FEATURE_PORT_RESET_CHANGE:
+      if (!set) {
+        port->change &= (uint16_t)~TU_BIT(feature - HUB_FEATURE_PORT_CONNECTION_CHANGE);
+      }
+      break;
+
+    default:
+      break;
+  }
+
+  return 0;
+}
+
+static int32_t sim_hub_control(tuh_sim_device_t *dev, const tusb_control_request_t *request, uint8_t *data) {
+  tuh_sim_hub_t *hub = (tuh_sim_hub_t *)dev->param;
+  TU_VERIFY(request->bmRequestType_bit.type == TUSB_REQ_TYPE_CLASS, TUH_SIM_STALL);
+
+  if (request->bmRequestType_bit.recipient == TUSB_REQ_RCPT_DEVICE) {
+    switch (request->bRequest) {
+      case HUB_REQUEST_GET_DESCRIPTOR: {
+        hub_desc_cs_t desc_hub = {
+          .bLength             = sizeof(hub_desc_cs_t),
+          .bDescriptorType     = 0x29,
+          .bNbrPorts           = hub->port_count,
+          .wHubCharacteristics = tu_htole16(0x0009), // individual power switching and over-current protection
+          .bPwrOn2PwrGood      = 1,
+          .bHubContrCurrent    = 100,
+          .DeviceRemovable     = 0,
+          .PortPwrCtrlMask     = 0xff
+        };
+        memcpy(data, &desc_hub, sizeof(desc_hub));
+        return sizeof(desc_hub);
+      }
+
+      case HUB_REQUEST_GET_STATUS:
+        tu_memclr(data, sizeof(hub_status_response_t));
+        return sizeof(hub_status_response_t);
+
+      case HUB_REQUEST_SET_FEATURE:
+      case HUB_REQUEST_CLEAR_FEATURE:
+        return 0;
+
+      default:
+        return TUH_SIM_STALL;
+    }
+  }
+
+  // port requests
+  const uint8_t port_num = tu_u16_low(request->wIndex);
+  TU_VERIFY(port_num >= 1 && port_num <= hub->port_count, TUH_SIM_STALL);
+  tuh_sim_hub_port_t *port = &hub->port[port_num - 1];
+
+  switch (request->bRequest) {
+    case HUB_REQUEST_GET_STATUS:
+      tu_unaligned_write16(data, tu_htole16(sim_hub_port_status(port)));
+      tu_unaligned_write16(data + 2, tu_htole16(port->change));
+      return sizeof(hub_port_status_response_t);
+
+    case HUB_REQUEST_SET_FEATURE:
+    case HUB_REQUEST_CLEAR_FEATURE:
+      return sim_hub_port_feature(hub, port, request->bRequest, request->wValue);
+
+    default:
+      return TUH_SIM_STALL;
+  }
+}
+
+// status change endpoint: bit 0 is hub, bit n is port n. NAK if there is no change
+static int32_t sim_hub_xfer(tuh_sim_device_t *dev, uint8_t ep_addr, uint8_t *buffer, uint16_t buflen) {
+  tuh_sim_hub_t *hub = (tuh_sim_hub_t *)dev->param;
+  TU_VERIFY(tu_edpt_dir(ep_addr) == TUSB_DIR_IN && buflen > 0, TUH_SIM_STALL);
+
+  uint8_t bitmap = 0;
+  for (uint8_t i = 0; i < hub->port_count; i++) {
+    if (hub->port[i].change) {
+      bitmap |= (uint8_t)TU_BIT(i + 1);
+    }
+  }
+  if (bitmap == 0) {
+    return TUH_SIM_NAK;
+  }
+
+  buffer[0] = bitmap;
+  return 1;
+}
+
+static const tuh_sim_driver_t sim_hub_driver = {
+  .reset   = sim_hub_reset,
+  .control = sim_hub_control,
+  .xfer    = sim_hub_xfer,
+};
+
+void tuh_sim_hub_init(tuh_sim_device_t *dev, tuh_sim_hub_t *hub, tusb_speed_t speed, uint8_t port_count) {
+  const bool is_hs = (speed == TUSB_SPEED_HIGH);
+  tu_memclr(hub, sizeof(tuh_sim_hub_t));
+  hub->port_count = TU_MIN(port_count, TUH_SIM_HUB_PORT_MAX);
+  sim_device_init(dev, &sim_hub_driver, &sim_hub_desc_device[is_hs], sim_hub_desc_config[is_hs], sim_hub_strings,
+                  TU_ARRAY_SIZE(sim_hub_strings), speed, hub);
+}
+
+bool tuh_sim_hub_attach(tuh_sim_device_t *hub_dev, uint8_t hub_port, tuh_sim_device_t *dev) {
+  TU_VERIFY(hub_dev->driver == &sim_hub_driver && dev != NULL);
+  tuh_sim_hub_t *hub = (tuh_sim_hub_t *)hub_dev->param;
+  TU_VERIFY(hub_port >= 1 && hub_port <= hub->port_count);
+  tuh_sim_hub_port_t *port = &hub->port[hub_port - 1];
+  TU_VERIFY(port->dev == NULL);
+
+  dev->hub      = hub_dev;
+  dev->hub_port = hub_port;
+  dev->enabled  = false; // until port is reset
+  port->dev     = dev;
+  if (port->powered) {
+    port->change |= SIM_HUB_PORT_STATUS_CONNECTION;
+  }
+  return true;
+}
+
+bool tuh_sim_hub_detach(tuh_sim_device_t *hub_dev, uint8_t hub_port) {
+  TU_VERIFY(hub_dev->driver == &sim_hub_driver);
+  tuh_sim_hub_t *hub = (tuh_sim_hub_t *)hub_dev->param;
+  TU_VERIFY(hub_port >= 1 && hub_port <= hub->port_count);
+  tuh_sim_hub_port_t *port = &hub->port[hub_port - 1];
+  TU_VERIFY(port->dev != NULL);
+
+  device_disable(port->dev);
+  port->dev->hub = NULL;
+  port->dev      = NULL;
+  port->enabled  = false;
+  if (port->powered) {
+    port->change |= SIM_HUB_PORT_STATUS_CONNECTION;
+  }
+  return true;
+}
+
+//------------- MSC: Bulk-only SCSI RAM disk -------------//
+enum {
+  SIM_MSC_STAGE_CMD = 0,
+  SIM_MSC_STAGE_DATA,
+  SIM_MSC_STAGE_STATUS,
+};
+
+static const tusb_desc_device_t sim_msc_desc_device =
+  SIM_DESC_DEVICE(TUSB_CLASS_UNSPECIFIED, 0, 0, SIM_VID, 0x4002, 0x0100);
+
+#define SIM_MSC_CONFIG(_epsize)                                                 \
+  { TUD_CONFIG_DESCRIPTOR(1, 1, 0, TUD_CONFIG_DESC_LEN + TUD_MSC_DESC_LEN, 0, 100), \
+    TUD_MSC_DESCRIPTOR(0, 0, 0x01, 0x81, _epsize) }
+
+static const uint8_t sim_msc_desc_config[2][TUD_CONFIG_DESC_LEN + TUD_MSC_DESC_LEN] = {SIM_MSC_CONFIG(64),
+                                                                                     SIM_MSC_CONFIG(512)};
+
+static const char *const sim_msc_strings[] = {"TinyUSB", "Simulated Disk", "000002"};
+
+static void sim_msc_reset(tuh_sim_device_t *dev) {
+  tuh_sim_msc_t *msc = (tuh_sim_msc_t *)dev->param;
+  msc->stage     = SIM_MSC_STAGE_CMD;
+  msc->sense_key = SCSI_SENSE_NONE;
+  msc->sense_asc = 0;
+}
+
+static void sim_msc_set_sense(tuh_sim_msc_t *msc, uint8_t sense_key, uint8_t asc) {
+  msc->status    = MSC_CSW_STATUS_FAILED;
+  msc->sense_key = sense_key;
+  msc->sense_asc = asc;
+}
+
+TU_ATTR_ALWAYS_INLINE static inline bool sim_msc_is_rw(uint8_t opcode) {
+  return opcode == SCSI_CMD_READ_10 || opcode == SCSI_CMD_WRITE_10 || opcode == SCSI_CMD_READ_16 ||
+         opcode == SCSI_CMD_WRITE_16;
+}
+
+// LBA of READ/WRITE (10) and (16)
+static uint64_t sim_msc_rw_lba(const uint8_t *cmd) {
+  if (cmd[0] == SCSI_CMD_READ_16 || cmd[0] == SCSI_CMD_WRITE_16) {
+    const uint32_t hi = tu_ntohl(tu_unaligned_read32(cmd + offsetof(scsi_read16_t, lba_hi)));
+    const uint32_t lo = tu_ntohl(tu_unaligned_read32(cmd + offsetof(scsi_read16_t, lba_lo)));
+    return ((uint64_t)hi << 32) | lo;
+  }
+  return tu_ntohl(tu_unaligned_read32(cmd + offsetof(scsi_read10_t, lba)));
+}
+
+// byte offset of current data stage in storage
+static uint64_t sim_msc_rw_offset(const tuh_sim_msc_t *msc) {
+  return (sim_msc_rw_lba(msc->command) - msc->lba_offset) * msc->block_size + msc->xferred;
+}
+
+// Validate new command, data stage is processed by sim_msc_data_in()/sim_msc_data_out()
+static void sim_msc_command(tuh_sim_msc_t *msc) {
+  const uint8_t *cmd = msc->command;
+  msc->status        = MSC_CSW_STATUS_PASSED;
+
+  switch (cmd[0]) {
+    case SCSI_CMD_READ_10:
+    case SCSI_CMD_WRITE_10:
+    case SCSI_CMD_READ_16:
+    case SCSI_CMD_WRITE_16: {
+      const uint64_t lba   = sim_msc_rw_lba(cmd);
+      const uint32_t count = (cmd[0] == SCSI_CMD_READ_16 || cmd[0] == SCSI_CMD_WRITE_16)
+                               ? tu_ntohl(tu_unaligned_read32(cmd + offsetof(scsi_read16_t, block_count)))
+                               : tu_ntohs(tu_unaligned_read16(cmd + offsetof(scsi_read10_t, block_count)));
+      if (lba < msc->lba_offset || lba - msc->lba_offset + count > msc->block_count ||
+          (uint64_t)count * msc->block_size != msc->total_bytes) {
+        sim_msc_set_sense(msc, SCSI_SENSE_ILLEGAL_REQUEST, 0x21); // LBA out of range
+      }
+      break;
+    }
+
+    case SCSI_CMD_SERVICE_ACTION_IN_16:
+      if ((cmd[1] & 0x1f) != SCSI_SERVICE_ACTION_READ_CAPACITY_16) {
+        sim_msc_set_sense(msc, SCSI_SENSE_ILLEGAL_REQUEST, 0x24); // invalid field in CDB
+      }
+      break;
+
+    case SCSI_CMD_TEST_UNIT_READY:
+    case SCSI_CMD_INQUIRY:
+    case SCSI_CMD_REQUEST_SENSE:
+    case SCSI_CMD_READ_CAPACITY_10:
+    case SCSI_CMD_MODE_SENSE_6:
+    case SCSI_CMD_START_STOP_UNIT:
+    case SCSI_CMD_PREVENT_ALLOW_MEDIUM_REMOVAL:
+      break;
+
+    default:
+      sim_msc_set_sense(msc, SCSI_SENSE_ILLEGAL_REQUEST, 0x20); // invalid command operation code
+      break;
+  }
+}
+
+static uint32_t sim_msc_data_in(tuh_sim_msc_t *msc, uint8_t *buffer, uint32_t len) {
+  const uint8_t *cmd = msc->command;
+
+  switch (cmd[0]) {
+    case SCSI_CMD_READ_10:
+    case SCSI_CMD_READ_16:
+      memcpy(buffer, msc->storage + sim_msc_rw_offset(msc), len);
+      return len;
+
+    case SCSI_CMD_INQUIRY: {
+      scsi_inquiry_resp_t resp;
+      tu_memclr(&resp, sizeof(resp));
+      resp.is_removable         = 1;
+      resp.version              = 2;
+      resp.response_data_format = 2;
+      resp.additional_length    = sizeof(resp) - 5;
+      memcpy(resp.vendor_id, "TinyUSB ", 8);
+      memcpy(resp.product_id, "Simulated Disk  ", 16);
+      memcpy(resp.product_rev, "1.0 ", 4);
+      len = TU_MIN(len, sizeof(resp));
+      memcpy(buffer, &resp, len);
+      return len;
+    }
+
+    case SCSI_CMD_REQUEST_SENSE: {
+      scsi_sense_fixed_resp_t resp;
+      tu_memclr(&resp, sizeof(resp));
+      resp.response_code  = 0x70;
+      resp.valid          = 1;
+      resp.sense_key      = msc->sense_key & 0x0f;
+      resp.add_sense_len  = sizeof(resp) - 8;
+      resp.add_sense_code = msc->sense_asc;
+      msc->sense_key      = SCSI_SENSE_NONE;
+      msc->sense_asc      = 0;
+      len = TU_MIN(len, sizeof(resp));
+      memcpy(buffer, &resp, len);
+      return len;
+    }
+
+    case SCSI_CMD_READ_CAPACITY_10: {
+      const uint64_t last_lba = msc->lba_offset + msc->block_count - 1;
+      const scsi_read_capacity10_resp_t resp = {
+        .last_lba   = tu_htonl(last_lba > UINT32_MAX ? UINT32_MAX : (uint32_t)last_lba),
+        .block_size = tu_htonl(msc->block_size)
+      };
+      len = TU_MIN(len, sizeof(resp));
+      memcpy(buffer, &resp, len);
+      return len;
+    }
+
+    case SCSI_CMD_SERVICE_ACTION_IN_16: {
+      const uint64_t last_lba = msc->lba_offset + msc->block_count - 1;
+      scsi_read_capacity16_resp_t resp;
+      tu_memclr(&resp, sizeof(resp));
+      resp.last_lba_hi = tu_htonl((uint32_t)(last_lba >> 32));
+      resp.last_lba_lo = tu_htonl((uint32_t)last_lba);
+      resp.block_size  = tu_htonl(msc->block_size);
+      len = TU_MIN(len, sizeof(resp));
+      memcpy(buffer, &resp, len);
+      return len;
+    }
+
+    case SCSI_CMD_MODE_SENSE_6: {
+      const uint8_t resp[4] = {3, 0, 0, 0}; // mode data length, medium type, device-specific (not write protected)
+      len = TU_MIN(len, sizeof(resp));
+      memcpy(buffer, resp, len);
+      return len;
+    }
+
+    default:
+      return 0;
+  }
+}
+
+static int32_t sim_msc_control(tuh_sim_device_t *dev, const tusb_control_request_t *request, uint8_t *data) {
+  TU_VERIFY(request->bmRequestType_bit.type == TUSB_REQ_TYPE_CLASS, TUH_SIM_STALL);
+  switch (request->bRequest) {
+    case MSC_REQ_GET_MAX_LUN:
+      data[0] = 0;
+      return 1;
+
+    case MSC_REQ_RESET:
+      sim_msc_reset(dev);
+      return 0;
+
+    default:
+      return TUH_SIM_STALL;
+  }
+}
+
+static int32_t sim_msc_xfer(tuh_sim_device_t *dev, uint8_t ep_addr, uint8_t *buffer, uint16_t buflen) {
+  tuh_sim_msc_t *msc    = (tuh_sim_msc_t *)dev->param;
+  const bool     dir_in = (tu_edpt_dir(ep_addr) == TUSB_DIR_IN);
+
+  switch (msc->stage) {
+    case SIM_MSC_STAGE_CMD: {
+      TU_VERIFY(!dir_in, TUH_SIM_NAK);
+      const msc_cbw_t *cbw = (const msc_cbw_t *)buffer;
+      TU_VERIFY(buflen == sizeof(msc_cbw_t) && tu_le32toh(cbw->signature) == MSC_CBW_SIGNATURE, TUH_SIM_STALL);
+
+      msc->tag         = cbw->tag;
+      msc->total_bytes = tu_le32toh(cbw->total_bytes);
+      msc->xferred     = 0;
+      msc->actual      = 0;
+      memcpy(msc->command, cbw->command, sizeof(msc->command));
+      sim_msc_command(msc);
+      msc->stage = msc->total_bytes ? SIM_MSC_STAGE_DATA : SIM_MSC_STAGE_STATUS;
+      return buflen;
+    }
+
+    case SIM_MSC_STAGE_DATA: {
+      const uint32_t len = TU_MIN(buflen, msc->total_bytes - msc->xferred);
+      uint32_t actual = len;
+
+      if (msc->status != MSC_CSW_STATUS_PASSED) {
+        // failed command: host gets a short (empty) packet, OUT data is discarded
+        actual       = dir_in ? 0 : len;
+        msc->xferred = msc->total_bytes;
+      } else if (dir_in) {
+        actual = sim_msc_data_in(msc, buffer, len);
+        // non read/write command completes its data stage in one transfer
+        msc->xferred = sim_msc_is_rw(msc->command[0]) ? (msc->xferred + len) : msc->total_bytes;
+      } else {
+        if (msc->command[0] == SCSI_CMD_WRITE_10 || msc->command[0] == SCSI_CMD_WRITE_16) {
+          memcpy(msc->storage + sim_msc_rw_offset(msc), buffer, len);
+        }
+        msc->xferred += len;
+      }
+
+      if (!dir_in || msc->status == MSC_CSW_STATUS_PASSED) {
+        msc->actual += actual;
+      }
+      if (msc->xferred >= msc->total_bytes) {
+        msc->stage = SIM_MSC_STAGE_STATUS;
+      }
+      return (int32_t)actual;
+    }
+
+    case SIM_MSC_STAGE_STATUS: {
+      TU_VERIFY(dir_in && buflen >= sizeof(msc_csw_t), TUH_SIM_NAK);
+      const msc_csw_t csw = {
+        .signature    = tu_htole32(MSC_CSW_SIGNATURE),
+        .tag          = msc->tag,
+        .data_residue = tu_htole32(msc->total_bytes - msc->actual),
+        .status       = msc->status
+      };
+      memcpy(buffer, &csw, sizeof(csw));
+      msc->stage = SIM_MSC_STAGE_CMD;
+      return sizeof(csw);
+    }
+
+    default:
+      return TUH_SIM_STALL;
+  }
+}
+
+static const tuh_sim_driver_t sim_msc_driver = {
+  .reset   = sim_msc_reset,
+  .control = sim_msc_control,
+  .xfer    = sim_msc_xfer,
+};
+
+void tuh_sim_msc_init(tuh_sim_device_t *dev, tuh_sim_msc_t *msc, tusb_speed_t speed, uint8_t *storage,
+                      uint32_t block_count, uint16_t block_size) {
+  tu_memclr(msc, sizeof(tuh_sim_msc_t));
+  msc->storage     = storage;
+  msc->block_count = block_count;
+  msc->block_size  = block_size;
+  sim_device_init(dev, &sim_msc_driver, &sim_msc_desc_device, sim_msc_desc_config[speed == TUSB_SPEED_HIGH],
+                  sim_msc_strings, TU_ARRAY_SIZE(sim_msc_strings), speed, msc);
+}
+
+//------------- Serial: CDC-ACM, FTDI, MIDI -------------//
+static void sim_serial_reset(tuh_sim_device_t *dev) {
+  tuh_sim_serial_t *serial = (tuh_sim_serial_t *)dev->param;
+  serial->count = 0;
+}
+
+static int32_t sim_serial_out(tuh_sim_serial_t *serial, const uint8_t *buffer, uint16_t buflen) {
+  if (serial->loopback) {
+    // accept whole transfer only, otherwise NAK until host reads back
+    if (buflen > sizeof(serial->buf) - serial->count) {
+      return TUH_SIM_NAK;
+    }
+    memcpy(serial->buf + serial->count, buffer, buflen);
+    serial->count = (uint16_t)(serial->count + buflen);
+  }
+  return buflen;
+}
+
+static int32_t sim_serial_in(tuh_sim_serial_t *serial, uint8_t *buffer, uint16_t buflen) {
+  if (!serial->loopback) {
+    return buflen; // source: content is not touched
+  }
+  if (serial->count == 0) {
+    return TUH_SIM_NAK;
+  }
+  const uint16_t len = TU_MIN(buflen, serial->count);
+  memcpy(buffer, serial->buf, len);
+  serial->count = (uint16_t)(serial->count - len);
+  memmove(serial->buf, serial->buf + len, serial->count);
+  return len;
+}
+
+static int32_t sim_serial_xfer(tuh_sim_device_t *dev, uint8_t ep_addr, uint8_t *buffer, uint16_t buflen) {
+  tuh_sim_serial_t *serial = (tuh_sim_serial_t *)dev->param;
+  if (tu_edpt_dir(ep_addr) == TUSB_DIR_OUT) {
+    return sim_serial_out(serial, buffer, buflen);
+  }
+  // CDC notification endpoint has nothing to report
+  return (tu_edpt_number(ep_addr) == 1) ? sim_serial_in(serial, buffer, buflen) : TUH_SIM_NAK;
+}
+
+//------------- CDC-ACM -------------//
+static const tusb_desc_device_t sim_cdc_desc_device =
+  SIM_DESC_DEVICE(TUSB_CLASS_MISC, MISC_SUBCLASS_COMMON, MISC_PROTOCOL_IAD, SIM_VID, 0x4003, 0x0100);
+
+// notification endpoint 0x82 so that data IN is endpoint 1 for all serial devices
+#define SIM_CDC_CONFIG(_epsize)                                                 \
+  { TUD_CONFIG_DESCRIPTOR(1, 2, 0, TUD_CONFIG_DESC_LEN + TUD_CDC_DESC_LEN, 0, 100), \
+    TUD_CDC_DESCRIPTOR(0, 0, 0x82, 8, 0x01, 0x81, _epsize) }
+
+static const uint8_t sim_cdc_desc_config[2][TUD_CONFIG_DESC_LEN + TUD_CDC_DESC_LEN] = {SIM_CDC_CONFIG(64),
+                                                                                     SIM_CDC_CONFIG(512)};
+
+static const char *const sim_cdc_strings[] = {"TinyUSB", "Simulated CDC", "000003"};
+
+static int32_t sim_cdc_control(tuh_sim_device_t *dev, const tusb_control_request_t *request, uint8_t *data) {
+  (void)dev;
+  TU_VERIFY(request->bmRequestType_bit.type == TUSB_REQ_TYPE_CLASS, TUH_SIM_STALL);
+  switch (request->bRequest) {
+    case CDC_REQUEST_GET_LINE_CODING: {
+      const cdc_line_coding_t coding = {.bit_rate = tu_htole32(115200), .stop_bits = 0, .parity = 0, .data_bits = 8};
+      memcpy(data, &coding, sizeof(coding));
+      return sizeof(coding);
+    }
+
+    case CDC_REQUEST_SET_LINE_CODING:
+    case CDC_REQUEST_SET_CONTROL_LINE_STATE:
+    case CDC_REQUEST_SEND_BREAK:
+      return 0;
+
+    default:
+      return TUH_SIM_STALL;
+  }
+}
+
+static const tuh_sim_driver_t sim_cdc_driver = {
+  .reset   = sim_serial_reset,
+  .control = sim_cdc_control,
+  .xfer    = sim_serial_xfer,
+};
+
+void tuh_sim_cdc_init(tuh_sim_device_t *dev, tuh_sim_serial_t *serial, tusb_speed_t speed, bool loopback) {
+  tu_memclr(serial, sizeof(tuh_sim_serial_t));
+  serial->loopback = loopback;
+  sim_device_init(dev, &sim_cdc_driver, &sim_cdc_desc_device, sim_cdc_desc_config[speed == TUSB_SPEED_HIGH],
+                  sim_cdc_strings, TU_ARRAY_SIZE(sim_cdc_strings), speed, serial);
+}
+
+//------------- FTDI FT232R -------------//
+#define SIM_FTDI_EPSIZE 64
+
+static const tusb_desc_device_t sim_ftdi_desc_device =
+  SIM_DESC_DEVICE(0x00, 0x00, 0x00, 0x0403, 0x6001, 0x0600);
+
+static const uint8_t sim_ftdi_desc_config[] = {
+  TUD_CONFIG_DESCRIPTOR(1, 1, 0, TUD_CONFIG_DESC_LEN + TUD_VENDOR_DESC_LEN, 0, 90),
+  9, TUSB_DESC_INTERFACE, 0, 0, 2, TUSB_CLASS_VENDOR_SPECIFIC, 0xff, 0xff, 2,
+  7, TUSB_DESC_ENDPOINT, 0x81, TUSB_XFER_BULK, U16_TO_U8S_LE(SIM_FTDI_EPSIZE), 0,
+  7, TUSB_DESC_ENDPOINT, 0x02, TUSB_XFER_BULK, U16_TO_U8S_LE(SIM_FTDI_EPSIZE), 0
+};
+
+static const char *const sim_ftdi_strings[] = {"FTDI", "FT232R USB UART", "000004"};
+
+// all vendor requests are accepted, IN requests (e.g modem status, latency timer) return zeroes
+static int32_t sim_ftdi_control(tuh_sim_device_t *dev, const tusb_control_request_t *request, uint8_t *data) {
+  (void)dev;
+  TU_VERIFY(request->bmRequestType_bit.type == TUSB_REQ_TYPE_VENDOR, TUH_SIM_STALL);
+  if (request->bmRequestType_bit.direction == TUSB_DIR_OUT) {
+    return 0;
+  }
+  const uint16_t len = TU_MIN(request->wLength, CFG_TUH_SIM_CTRL_BUFSIZE);
+  tu_memclr(data, len);
+  return len;
+}
+
+// Every IN packet starts with 2 bytes of modem/line status. Real chip sends status-only packets when latency timer
+// expires without data, that is NAKed here to not flood the stack.
+static int32_t sim_ftdi_xfer(tuh_sim_device_t *dev, uint8_t ep_addr, uint8_t *buffer, uint16_t buflen) {
+  tuh_sim_serial_t *serial = (tuh_sim_serial_t *)dev->param;
+  if (tu_edpt_dir(ep_addr) == TUSB_DIR_OUT) {
+    return sim_serial_out(serial, buffer, buflen);
+  }
+
+  TU_VERIFY(buflen > 2, TUH_SIM_NAK);
+  const int32_t len = sim_serial_in(serial, buffer + 2, (uint16_t)(TU_MIN(buflen, SIM_FTDI_EPSIZE) - 2));
+  if (len < 0) {
+    return len;
+  }
+  buffer[0] = 0x01; // modem status
+  buffer[1] = 0x60; // line status: transmitter empty
+  return len + 2;
+}
+
+static const tuh_sim_driver_t sim_ftdi_driver = {
+  .reset   = sim_serial_reset,
+  .control = sim_ftdi_control,
+  .xfer    = sim_ftdi_xfer,
+};
+
+void tuh_sim_ftdi_init(tuh_sim_device_t *dev, tuh_sim_serial_t *serial, bool loopback) {
+  tu_memclr(serial, sizeof(tuh_sim_serial_t));
+  serial->loopback = loopback;
+  sim_device_init(dev, &sim_ftdi_driver, &sim_ftdi_desc_device, sim_ftdi_desc_config, sim_ftdi_strings,
+                  TU_ARRAY_SIZE(sim_ftdi_strings), TUSB_SPEED_FULL, serial);
+}
+
+//------------- MIDI -------------//
+static const tusb_desc_device_t sim_midi_desc_device =
+  SIM_DESC_DEVICE(TUSB_CLASS_UNSPECIFIED, 0, 0, SIM_VID, 0x4005, 0x0100);
+
+static const uint8_t sim_midi_desc_config[] = {
+  TUD_CONFIG_DESCRIPTOR(1, 2, 0, TUD_CONFIG_DESC_LEN + TUD_MIDI_DESC_LEN, 0, 100),
+  TUD_MIDI_DESCRIPTOR(0, 0, 0x01, 0x81, 64)
+};
+
+static const char *const sim_midi_strings[] = {"TinyUSB", "Simulated MIDI", "000005"};
+
+static const tuh_sim_driver_t sim_midi_driver = {
+  .reset   = sim_serial_reset,
+  .control = NULL,
+  .xfer    = sim_serial_xfer,
+};
+
+void tuh_sim_midi_init(tuh_sim_device_t *dev, tuh_sim_serial_t *serial, bool loopback) {
+  tu_memclr(serial, sizeof(tuh_sim_serial_t));
+  serial->loopback = loopback;
+  sim_device_init(dev, &sim_midi_driver, &sim_midi_desc_device, sim_midi_desc_config, sim_midi_strings,
+                  TU_ARRAY_SIZE(sim_midi_strings), TUSB_SPEED_FULL, serial);
+}
+
+//------------- HID boot keyboard -------------//
+static const tusb_desc_device_t sim_hid_desc_device =
+  SIM_DESC_DEVICE(TUSB_CLASS_UNSPECIFIED, 0, 0, SIM_VID, 0x4006, 0x0100);
+
+static const uint8_t sim_hid_desc_report[] = {TUD_HID_REPORT_DESC_KEYBOARD()};
+
+static const uint8_t sim_hid_desc_config[] = {
+  TUD_CONFIG_DESCRIPTOR(1, 1, 0, TUD_CONFIG_DESC_LEN + TUD_HID_DESC_LEN, 0, 100),
+  TUD_HID_DESCRIPTOR(0, 0, HID_ITF_PROTOCOL_KEYBOARD, sizeof(sim_hid_desc_report), 0x81, 8, 1)
+};
+
+static const char *const sim_hid_strings[] = {"TinyUSB", "Simulated Keyboard", "000006"};
+
+static void sim_hid_reset(tuh_sim_device_t *dev) {
+  tuh_sim_hid_t *hid = (tuh_sim_hid_t *)dev->param;
+  hid->protocol  = HID_PROTOCOL_REPORT;
+  hid->idle_rate = 0;
+  hid->leds      = 0;
+}
+
+static uint16_t sim_hid_report(tuh_sim_hid_t *hid, uint8_t *buffer, uint16_t buflen) {
+  hid_keyboard_report_t report;
+  tu_memclr(&report, sizeof(report));
+  // alternate key press ('a' to 'z') and release
+  if ((hid->report_count & 1) == 0) {
+    report.keycode[0] = (uint8_t)(HID_KEY_A + (hid->report_count / 2) % 26);
+  }
+  hid->report_count++;
+
+  const uint16_t len = TU_MIN(buflen, sizeof(report));
+  memcpy(buffer, &report, len);
+  return len;
+}
+
+static int32_t sim_hid_control(tuh_sim_device_t *dev, const tusb_control_request_t *request, uint8_t *data) {
+  tuh_sim_hid_t *hid = (tuh_sim_hid_t *)dev->param;
+
+  if (request->bmRequestType_bit.type == TUSB_REQ_TYPE_STANDARD) {
+    TU_VERIFY(request->bRequest == TUSB_REQ_GET_DESCRIPTOR &&
+              tu_u16_high(request->wValue) == HID_DESC_TYPE_REPORT, TUH_SIM_STALL);
+    memcpy(data, sim_hid_desc_report, sizeof(sim_hid_desc_report));
+    return sizeof(sim_hid_desc_report);
+  }
+
+  TU_VERIFY(request->bmRequestType_bit.type == TUSB_REQ_TYPE_CLASS, TUH_SIM_STALL);
+  switch (request->bRequest) {
+    case HID_REQ_CONTROL_GET_REPORT:
+      return sim_hid_report(hid, data, request->wLength);
+
+    case HID_REQ_CONTROL_SET_REPORT:
+      hid->leds = data[0];
+      return 0;
+
+    case HID_REQ_CONTROL_GET_IDLE:
+      data[0] = hid->idle_rate;
+      return 1;
+
+    case HID_REQ_CONTROL_SET_IDLE:
+      hid->idle_rate = tu_u16_high(request->wValue);
+      return 0;
+
+    case HID_REQ_CONTROL_GET_PROTOCOL:
+      data[0] = hid->protocol;
+      return 1;
+
+    case HID_REQ_CONTROL_SET_PROTOCOL:
+      hid->protocol = tu_u16_low(request->wValue);
+      return 0;
+
+    default:
+      return TUH_SIM_STALL;
+  }
+}
+
+static int32_t sim_hid_xfer(tuh_sim_device_t *dev, uint8_t ep_addr, uint8_t *buffer, uint16_t buflen) {
+  TU_VERIFY(tu_edpt_dir(ep_addr) == TUSB_DIR_IN, TUH_SIM_STALL);
+  return sim_hid_report((tuh_sim_hid_t *)dev->param, buffer, buflen);
+}
+
+static const tuh_sim_driver_t sim_hid_driver = {
+  .reset   = sim_hid_reset,
+  .control = sim_hid_control,
+  .xfer    = sim_hid_xfer,
+};
+
+void tuh_sim_hid_init(tuh_sim_device_t *dev, tuh_sim_hid_t *hid) {
+  tu_memclr(hid, sizeof(tuh_sim_hid_t));
+  sim_device_init(dev, &sim_hid_driver, &sim_hid_desc_device, sim_hid_desc_config, sim_hid_strings,
+                  TU_ARRAY_SIZE(sim_hid_strings), TUSB_SPEED_FULL, hid);
+}
+
+#endif
@@ -0,0 +1,195 @@
+/*
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2026 Ha Thach (tinyusb.org)
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ *
+ * This file is part of the TinyUSB stack.
+ */
+#ifndef TUSB_HCD_SIM_H
+#define TUSB_HCD_SIM_H
+
+#include "host/hcd.h"
+
+#ifdef __cplusplus
+ extern "C" {
+#endif
+
+//--------------------------------------------------------------------+
+// Simulated host controller, enabled with CFG_TUH_SIM = 1 (CFG_TUSB_MCU = OPT_MCU_NONE).
+// Virtual devices are plugged into the root port (or into a virtual hub) and answer the transfers queued by the
+// stack. Each call of hcd_int_handler() i.e tuh_int_handler() simulates one 1ms frame: pending transfers are
+// serviced and completed as if by the controller ISR. Enumeration delays can elapse in virtual time by
+// implementing tusb_time_millis_api() with hcd_frame_number().
+//
+//   uint32_t tusb_time_millis_api(void) { return hcd_frame_number(0); }
+//
+//   tuh_sim_msc_init(&disk, &disk_msc, TUSB_SPEED_HIGH, ram, 1024, 512);
+//   tuh_sim_attach(0, &disk);
+//   while (bench) {
+//     tuh_int_handler(0); // one frame on the bus
+//     tuh_task();
+//   }
+//   tuh_sim_detach(0);
+//--------------------------------------------------------------------+
+
+#ifndef CFG_TUH_SIM_CTRL_BUFSIZE
+  #define CFG_TUH_SIM_CTRL_BUFSIZE 512
+#endif
+
+#ifndef CFG_TUH_SIM_SERIAL_BUFSIZE
+  #define CFG_TUH_SIM_SERIAL_BUFSIZE 1024
+#endif
+
+#define TUH_SIM_HUB_PORT_MAX 7 // status change bitmap of virtual hub is one byte
+
+// Return value of virtual device driver callbacks
+enum {
+  TUH_SIM_NAK   = -1, // transfer is kept pending and retried in next frame
+  TUH_SIM_STALL = -2, // request is stalled or endpoint is halted
+};
+
+typedef struct {
+  uint32_t setup_count; // number of SETUP packets
+  uint32_t xfer_count;  // number of completed transfers (including control stages)
+  uint32_t byte_count;  // number of data bytes moved on the bus
+  uint32_t nak_count;   // number of NAKed attempts (e.g. interrupt polling without data)
+  uint32_t stall_count; // number of stalled transfers
+} tuh_sim_stats_t;
+
+typedef struct tuh_sim_device_s tuh_sim_device_t;
+
+typedef struct {
+  // Optional: reset driver state, invoked on attach and bus/port reset
+  void (*reset)(tuh_sim_device_t *dev);
+
+  // Optional: non-standard control request (standard requests are answered from descriptors). For IN request fill
+  // data and return its length, for OUT request data holds wLength bytes from host. Return TUH_SIM_STALL to stall.
+  int32_t (*control)(tuh_sim_device_t *dev, const tusb_control_request_t *request, uint8_t *data);
+
+  // Optional: non-control transfer, the whole host transfer is presented at once. OUT returns number of accepted
+  // bytes, IN fills buffer and returns its length. Return TUH_SIM_NAK to retry next frame or TUH_SIM_STALL to halt.
+  int32_t (*xfer)(tuh_sim_device_t *dev, uint8_t ep_addr, uint8_t *buffer, uint16_t buflen);
+} tuh_sim_driver_t;
+
+struct tuh_sim_device_s {
+  const tuh_sim_driver_t   *driver;
+  const tusb_desc_device_t *desc_device;
+  const uint8_t            *desc_config;
+  const char *const        *strings; // ASCII string descriptors starting from index 1
+  uint8_t                   string_count;
+  uint8_t                   speed; // tusb_speed_t
+  void                     *param; // driver instance
+
+  // below are managed by simulator
+  tuh_sim_device_t *hub; // upstream hub, NULL if connected to root port
+  uint8_t           hub_port;
+  uint8_t           addr;
+  uint8_t           cfg_num;
+  bool              enabled;   // port is reset and enabled, device responds to its address
+  uint32_t          ep_halted; // bit n: OUT endpoint n, bit 16+n: IN endpoint n
+  tuh_sim_stats_t   stats;
+};
+
+//------------- Built-in virtual devices -------------//
+typedef struct {
+  tuh_sim_device_t *dev;
+  bool              powered;
+  bool              enabled;
+  bool              suspended;
+  uint16_t          change; // wPortChange bits
+} tuh_sim_hub_port_t;
+
+typedef struct {
+  uint8_t            port_count;
+  tuh_sim_hub_port_t port[TUH_SIM_HUB_PORT_MAX];
+} tuh_sim_hub_t;
+
+typedef struct {
+  uint8_t *storage;
+  uint32_t block_count;
+  uint16_t block_size;
+  uint64_t lba_offset; // storage is mapped at this LBA of a larger virtual disk, emulate device bigger than storage
+
+  // bulk-only transport state
+  uint8_t  stage;
+  uint8_t  status;
+  uint8_t  sense_key;
+  uint8_t  sense_asc;
+  uint32_t tag;
+  uint32_t total_bytes; // data stage length expected by host
+  uint32_t xferred;     // data stage bytes processed
+  uint32_t actual;      // data stage bytes actually transferred, the rest is reported as residue
+  uint8_t  command[16];
+} tuh_sim_msc_t;
+
+typedef struct {
+  bool     loopback; // echo OUT data to IN, otherwise OUT is discarded and IN always returns full transfer
+  uint16_t count;
+  uint8_t  buf[CFG_TUH_SIM_SERIAL_BUFSIZE];
+} tuh_sim_serial_t;
+
+typedef struct {
+  uint8_t  protocol; // boot or report
+  uint8_t  idle_rate;
+  uint8_t  leds;
+  uint32_t report_count;
+} tuh_sim_hid_t;
+
+// Hub with 1-7 ports, device speed of port is reported from the attached device
+void tuh_sim_hub_init(tuh_sim_device_t *dev, tuh_sim_hub_t *hub, tusb_speed_t speed, uint8_t port_count);
+
+// Plug/unplug a device into a port of virtual hub, stack is notified via hub status change endpoint
+bool tuh_sim_hub_attach(tuh_sim_device_t *hub_dev, uint8_t hub_port, tuh_sim_device_t *dev);
+bool tuh_sim_hub_detach(tuh_sim_device_t *hub_dev, uint8_t hub_port);
+
+// Bulk-only SCSI RAM disk backed by storage of block_count * block_size bytes
+void tuh_sim_msc_init(tuh_sim_device_t *dev, tuh_sim_msc_t *msc, tusb_speed_t speed, uint8_t *storage,
+                      uint32_t block_count, uint16_t block_size);
+
+// CDC-ACM, FTDI (FT232R) and MIDI serial devices, either loopback or sink/source
+void tuh_sim_cdc_init(tuh_sim_device_t *dev, tuh_sim_serial_t *serial, tusb_speed_t speed, bool loopback);
+void tuh_sim_ftdi_init(tuh_sim_device_t *dev, tuh_sim_serial_t *serial, bool loopback);
+void tuh_sim_midi_init(tuh_sim_device_t *dev, tuh_sim_serial_t *serial, bool loopback);
+
+// Boot keyboard that sends a report on every interrupt poll
+void tuh_sim_hid_init(tuh_sim_device_t *dev, tuh_sim_hid_t *hid);
+
+//------------- Root port -------------//
+
+// Plug a device into root port and raise attach event
+bool tuh_sim_attach(uint8_t rhport, tuh_sim_device_t *dev);
+
+// Unplug device (and its downstream devices) from root port and raise remove event
+void tuh_sim_detach(uint8_t rhport);
+
+// Get device currently attached to root port
+tuh_sim_device_t *tuh_sim_root(uint8_t rhport);
+
+// Reset statistics of a device
+TU_ATTR_ALWAYS_INLINE static inline void tuh_sim_stats_reset(tuh_sim_device_t *dev) {
+  tu_varclr(&dev->stats);
+}
+
+#ifdef __cplusplus
+ }
+#endif
+
+#endif
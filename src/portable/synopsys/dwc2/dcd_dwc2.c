@@ -53,6 +53,7 @@ typedef struct {
   uint16_t max_size;
   uint8_t interval;
   uint8_t iso_retry; // ISO retry counter
+  uint8_t desc_count; // Scatter/Gather DMA: number of descriptors of current transfer
 } xfer_ctl_t;
 
 // This variable is modified from ISR context, so it must be protected by critical section
@@ -75,8 +76,24 @@ static dcd_data_t _dcd_data;
 
 CFG_TUD_MEM_SECTION static struct {
   TUD_EPBUF_DEF(setup_packet, 8);
+#if CFG_TUD_DWC2_DMA_DESC_ENABLE
+  TUD_EPBUF_TYPE_DEF(dwc2_dma_desc_t, setup_desc);
+#endif
 } _dcd_usbbuf;
 
+#if CFG_TUD_DWC2_DMA_DESC_ENABLE
+// Scatter/Gather DMA descriptor list of each endpoint: 2 descriptors for linear and wrapped part of a fifo transfer
+#define DDMA_DESC_PER_EP 2
+
+typedef struct {
+  dwc2_dma_desc_t desc[DDMA_DESC_PER_EP];
+} ddma_list_t;
+
+CFG_TUD_MEM_SECTION static struct {
+  TUD_EPBUF_TYPE_DEF(ddma_list_t, list);
+} _dcd_ddma[DWC2_EP_MAX][2];
+#endif
+
 static tud_configure_dwc2_t _tud_cfg = CFG_TUD_CONFIGURE_DWC2_DEFAULT;
 
 TU_ATTR_ALWAYS_INLINE static inline uint8_t dwc2_ep_count(const dwc2_regs_t* dwc2) {
@@ -127,6 +144,16 @@ TU_ATTR_ALWAYS_INLINE static inline bool dma_device_enabled(const dwc2_regs_t* d
   return CFG_TUD_DWC2_DMA_ENABLE && ghwcfg2.arch == GHWCFG2_ARCH_INTERNAL_DMA;
 }
 
+TU_ATTR_ALWAYS_INLINE static inline bool dma_desc_enabled(const dwc2_regs_t* dwc2) {
+#if CFG_TUD_DWC2_DMA_DESC_ENABLE
+  const dwc2_ghwcfg4_t ghwcfg4 = {.value = dwc2->ghwcfg4};
+  return ghwcfg4.dma_desc_enabled && dma_device_enabled(dwc2);
+#else
+  (void) dwc2;
+  return false;
+#endif
+}
+
 static void dma_setup_prepare(uint8_t rhport) {
   dwc2_regs_t* dwc2 = DWC2_REG(rhport);
 
@@ -136,12 +163,174 @@ static void dma_setup_prepare(uint8_t rhport) {
     }
   }
 
+#if CFG_TUD_DWC2_DMA_DESC_ENABLE
+  if (dma_desc_enabled(dwc2)) {
+    // SETUP packet is written to its own descriptor, DMA_DONE with SR set marks a received SETUP
+    dwc2_dma_desc_t* setup_desc = &_dcd_usbbuf.setup_desc;
+    setup_desc->buf = (uint32_t) (uintptr_t) _dcd_usbbuf.setup_packet;
+    setup_desc->status = DDMA_BS_HOST_READY | DDMA_L | DDMA_IOC | (8 << DDMA_BYTES_Pos);
+    dcd_dcache_clean(setup_desc, sizeof(dwc2_dma_desc_t));
+
+    dwc2->epout[0].doepdma = (uintptr_t) setup_desc;
+    dwc2->epout[0].doepctl |= DOEPCTL_EPENA | DOEPCTL_USBAEP;
+    return;
+  }
+#endif
+
   // Receive only 1 packet
   dwc2->epout[0].doeptsiz = (1 << DOEPTSIZ_STUPCNT_Pos) | (1 << DOEPTSIZ_PKTCNT_Pos) | (8 << DOEPTSIZ_XFRSIZ_Pos);
   dwc2->epout[0].doepdma = (uintptr_t) _dcd_usbbuf.setup_packet;
   dwc2->epout[0].doepctl |= DOEPCTL_EPENA | DOEPCTL_USBAEP;
 }
 
+#if CFG_TUD_DWC2_DMA_DESC_ENABLE
+TU_ATTR_ALWAYS_INLINE static inline bool ddma_addr_aligned(const void* addr) {
+  return (((uintptr_t) addr) & 3u) == 0; // DMA buffer must be DWORD aligned
+}
+
+// Split a fifo transfer into its linear and wrapped part. Wrapped part is only chained for non-ISO when linear part
+// ends on a packet boundary, otherwise only linear part is transferred (rounded down to whole packets for OUT).
+// Return number of bytes to transfer.
+static uint16_t ddma_fifo_segments(const xfer_ctl_t* xfer, uint8_t dir, uint16_t total_bytes, bool is_iso,
+                                   tu_fifo_buffer_info_t* info) {
+  if (dir == TUSB_DIR_IN) {
+    tu_fifo_get_read_info(xfer->ff, info);
+  } else {
+    tu_fifo_get_write_info(xfer->ff, info);
+  }
+
+  info->linear.len = tu_min16(total_bytes, info->linear.len);
+  info->wrapped.len = tu_min16(total_bytes - info->linear.len, info->wrapped.len);
+
+  if (info->wrapped.len > 0) {
+    const bool can_chain = !is_iso && (info->linear.len % xfer->max_size) == 0 && ddma_addr_aligned(info->wrapped.ptr);
+    if (!can_chain) {
+      info->wrapped.len = 0;
+      if (dir == TUSB_DIR_OUT) {
+        info->linear.len -= info->linear.len % xfer->max_size;
+      }
+    }
+  }
+
+  return info->linear.len + info->wrapped.len;
+}
+
+// Build descriptor list for the scheduled part of current transfer, return its address for DxEPDMA.
+// Non-ISO uses one descriptor per buffer segment, ISO uses a single descriptor for the next (micro)frame.
+static uint32_t ddma_prepare(dwc2_regs_t* dwc2, uint8_t epnum, uint8_t dir, uint16_t total_bytes, bool is_iso) {
+  xfer_ctl_t* const xfer = XFER_CTL_BASE(epnum, dir);
+  dwc2_dma_desc_t* const desc = _dcd_ddma[epnum][dir].list.desc;
+  const uint16_t mps = xfer->max_size;
+
+  tu_fifo_buffer_info_t seg = {
+    .linear  = {.len = total_bytes, .ptr = xfer->buffer},
+    .wrapped = {.len = 0, .ptr = NULL}
+  };
+  if (xfer->ff != NULL) {
+    (void) ddma_fifo_segments(xfer, dir, total_bytes, is_iso, &seg);
+  }
+
+  if (is_iso) {
+    uint32_t status = DDMA_BS_HOST_READY | DDMA_L | DDMA_IOC;
+    if (dir == TUSB_DIR_IN) {
+      // transmit in next (micro)frame
+      const dwc2_dsts_t dsts = {.value = dwc2->dsts};
+      const uint32_t frame = dsts.frame_number + 1u;
+      const uint32_t pid = tu_div_ceil(seg.linear.len, mps);
+      status |= ((uint32_t) seg.linear.len & DDMA_ISO_TX_BYTES_Msk) | ((frame << DDMA_ISO_FRNUM_Pos) & DDMA_ISO_FRNUM_Msk) |
+                ((pid << DDMA_ISO_PID_Pos) & DDMA_ISO_PID_Msk);
+      if ((seg.linear.len % mps) != 0) {
+        status |= DDMA_SP;
+      }
+    } else {
+      status |= (uint32_t) seg.linear.len & DDMA_ISO_RX_BYTES_Msk;
+    }
+    desc[0].buf = (uint32_t) (uintptr_t) seg.linear.ptr;
+    desc[0].status = status;
+    xfer->desc_count = 1;
+  } else {
+    const uint16_t seg_len[DDMA_DESC_PER_EP] = {seg.linear.len, seg.wrapped.len};
+    void* const seg_ptr[DDMA_DESC_PER_EP] = {seg.linear.ptr, seg.wrapped.ptr};
+    uint8_t count = 0;
+    while (count < DDMA_DESC_PER_EP && (count == 0 || seg_len[count] > 0)) {
+      uint32_t status = DDMA_BS_HOST_READY | ((uint32_t) seg_len[count] << DDMA_BYTES_Pos);
+      if (dir == TUSB_DIR_IN && (seg_len[count] % mps) != 0) {
+        status |= DDMA_SP;
+      }
+      desc[count].buf = (uint32_t) (uintptr_t) seg_ptr[count];
+      desc[count].status = status;
+      count++;
+    }
+    desc[count - 1].status |= DDMA_L | DDMA_IOC;
+    xfer->desc_count = count;
+  }
+
+  if (dir == TUSB_DIR_IN) {
+    if (seg.linear.len != 0) {
+      dcd_dcache_clean(seg.linear.ptr, seg.linear.len);
+    }
+    if (seg.wrapped.len != 0) {
+      dcd_dcache_clean(seg.wrapped.ptr, seg.wrapped.len);
+    }
+  }
+  dcd_dcache_clean(desc, sizeof(ddma_list_t));
+
+  return (uint32_t) (uintptr_t) desc;
+}
+
+// Check completed descriptor list: return false if any descriptor reported an error, remaining bytes (not
+// transferred) of the list is returned in remain
+static bool ddma_complete(dwc2_dep_t* dep, uint8_t epnum, uint8_t dir, uint16_t* remain) {
+  const xfer_ctl_t* xfer = XFER_CTL_BASE(epnum, dir);
+  const dwc2_dma_desc_t* desc = _dcd_ddma[epnum][dir].list.desc;
+  dcd_dcache_invalidate(desc, sizeof(ddma_list_t));
+
+  const dwc2_depctl_t depctl = {.value = dep->ctl};
+  uint32_t bytes_mask = DDMA_BYTES_Msk;
+  if (depctl.type == DEPCTL_EPTYPE_ISOCHRONOUS) {
+    bytes_mask = (dir == TUSB_DIR_IN) ? DDMA_ISO_TX_BYTES_Msk : DDMA_ISO_RX_BYTES_Msk;
+  }
+
+  bool ok = true;
+  uint16_t sum = 0;
+  for (uint8_t i = 0; i < xfer->desc_count; i++) {
+    const uint32_t status = desc[i].status;
+    sum += (uint16_t) (status & bytes_mask);
+    if ((status & DDMA_STS_Msk) != DDMA_STS_SUCCESS) {
+      ok = false;
+    }
+  }
+
+  *remain = sum;
+  return ok;
+}
+
+// Update fifo pointers after DMA has transferred xferred bytes
+static void ddma_fifo_complete(const xfer_ctl_t* xfer, uint8_t dir, uint16_t xferred) {
+  if (dir == TUSB_DIR_IN) {
+    tu_fifo_advance_read_pointer(xfer->ff, xferred);
+  } else {
+    tu_fifo_buffer_info_t info;
+    tu_fifo_get_write_info(xfer->ff, &info);
+    const uint16_t linear_len = tu_min16(xferred, info.linear.len);
+    if (linear_len != 0) {
+      dcd_dcache_invalidate(info.linear.ptr, linear_len);
+    }
+    if (xferred > linear_len) {
+      dcd_dcache_invalidate(info.wrapped.ptr, xferred - linear_len);
+    }
+    tu_fifo_advance_write_pointer(xfer->ff, xferred);
+  }
+}
+
+// Completion of SETUP descriptor is reported as EP0 OUT XferCompl as well, it is handled by SETUP phase done
+static bool ddma_setup_received(void) {
+  const dwc2_dma_desc_t* setup_desc = &_dcd_usbbuf.setup_desc;
+  dcd_dcache_invalidate(setup_desc, sizeof(dwc2_dma_desc_t));
+  return (setup_desc->status & (DDMA_BS_Msk | DDMA_SR)) == (DDMA_BS_DMA_DONE | DDMA_SR);
+}
+#endif
+
 //--------------------------------------------------------------------+
 // Data FIFO
 //--------------------------------------------------------------------+
@@ -248,10 +437,12 @@ static void dfifo_device_init(uint8_t rhport) {
   dwc2_regs_t* dwc2 = DWC2_REG(rhport);
   dwc2->grxfsiz = calc_device_grxfsiz(CFG_TUD_ENDPOINT0_SIZE, dwc2_controller->ep_count);
 
-  // Scatter/Gather DMA mode is not yet supported. Buffer DMA only need 1 words per endpoint direction
+  // Buffer DMA only need 1 word per endpoint direction, Scatter/Gather DMA need 4 words
   const bool is_dma = dma_device_enabled(dwc2);
   _dcd_data.dfifo_top = dwc2_controller->otg_dfifo_depth;
-  if (is_dma) {
+  if (dma_desc_enabled(dwc2)) {
+    _dcd_data.dfifo_top -= 8 * dwc2_controller->ep_count;
+  } else if (is_dma) {
     _dcd_data.dfifo_top -= 2 * dwc2_controller->ep_count;
   }
   dwc2->gdfifocfg = ((uint32_t) _dcd_data.dfifo_top << GDFIFOCFG_EPINFOBASE_SHIFT) | _dcd_data.dfifo_top;
@@ -378,16 +569,20 @@ static void edpt_schedule_packets(uint8_t rhport, const uint8_t epnum, const uin
   }
 
   // transfer size: A full OUT transfer (multiple packets, possibly) triggers XFRC.
-  dwc2_ep_tsize_t deptsiz = {.value = 0};
-  deptsiz.xfer_size = total_bytes;
-  deptsiz.packet_count = num_packets;
-  dep->tsiz = deptsiz.value;
+  // Scatter/Gather DMA takes transfer size from descriptors instead
+  const bool is_ddma = dma_desc_enabled(dwc2);
+  if (!is_ddma) {
+    dwc2_ep_tsize_t deptsiz = {.value = 0};
+    deptsiz.xfer_size = total_bytes;
+    deptsiz.packet_count = num_packets;
+    dep->tsiz = deptsiz.value;
+  }
 
   // control
   dwc2_depctl_t depctl = {.value = dep->ctl};
   depctl.clear_nak = 1;
   depctl.enable = 1;
-  if (depctl.type == DEPCTL_EPTYPE_ISOCHRONOUS) {
+  if (depctl.type == DEPCTL_EPTYPE_ISOCHRONOUS && !is_ddma) {
     const dwc2_dsts_t dsts = {.value = dwc2->dsts};
     const uint32_t odd_now = dsts.frame_number & 1u;
     if (odd_now != 0) {
@@ -400,10 +595,17 @@ static void edpt_schedule_packets(uint8_t rhport, const uint8_t epnum, const uin
   #if CFG_TUD_DWC2_DMA_ENABLE
   const bool is_dma = dma_device_enabled(dwc2);
   if(is_dma) {
-    if (dir == TUSB_DIR_IN && total_bytes != 0) {
-      dcd_dcache_clean(xfer->buffer, total_bytes);
+    #if CFG_TUD_DWC2_DMA_DESC_ENABLE
+    if (is_ddma) {
+      dep->diepdma = ddma_prepare(dwc2, epnum, dir, total_bytes, depctl.type == DEPCTL_EPTYPE_ISOCHRONOUS);
+    } else
+    #endif
+    {
+      if (dir == TUSB_DIR_IN && total_bytes != 0) {
+        dcd_dcache_clean(xfer->buffer, total_bytes);
+      }
+      dep->diepdma = (uintptr_t) xfer->buffer;
     }
-    dep->diepdma = (uintptr_t) xfer->buffer;
     dep->diepctl = depctl.value; // enable endpoint
     // Advance buffer pointer for EP0
     if (epnum == 0) {
@@ -469,6 +671,9 @@ bool dcd_init(uint8_t rhport, const tusb_rhport_init_t* rh_init) {
   }
 
   dcfg |= DCFG_NZLSOHSK; // send STALL back and discard if host send non-zlp during control status
+  if (dma_desc_enabled(dwc2)) {
+    dcfg |= DCFG_DESCDMA;
+  }
   dwc2->dcfg = dcfg;
 
   dcd_disconnect(rhport);
@@ -697,11 +902,28 @@ bool dcd_edpt_xfer_fifo(uint8_t rhport, uint8_t ep_addr, tu_fifo_t* ff, uint16_t
     xfer->ff = ff;
     xfer->total_len = total_bytes;
     xfer->iso_retry = xfer->interval; // Reset ISO retry counter to interval value
+    ret = true;
+
+  #if CFG_TUD_DWC2_DMA_ENABLE
+    dwc2_regs_t* dwc2 = DWC2_REG(rhport);
+    if (dma_device_enabled(dwc2)) {
+      // Buffer DMA can only transfer a linear buffer, Scatter/Gather DMA transfers both parts of the fifo
+      ret = false;
+      #if CFG_TUD_DWC2_DMA_DESC_ENABLE
+      if (dma_desc_enabled(dwc2) && epnum != 0) {
+        const dwc2_depctl_t depctl = {.value = dwc2->ep[dir == TUSB_DIR_IN ? 0 : 1][epnum].ctl};
+        tu_fifo_buffer_info_t info;
+        xfer->total_len = ddma_fifo_segments(xfer, dir, total_bytes, depctl.type == DEPCTL_EPTYPE_ISOCHRONOUS, &info);
+        ret = ddma_addr_aligned(info.linear.ptr) && (xfer->total_len > 0 || total_bytes == 0);
+      }
+      #endif
+    }
+  #endif
 
     // Schedule packets to be sent within interrupt
-    // TODO xfer fifo may only available for slave mode
-    edpt_schedule_packets(rhport, epnum, dir);
-    ret = true;
+    if (ret) {
+      edpt_schedule_packets(rhport, epnum, dir);
+    }
   }
 
   usbd_spin_unlock(is_isr);
@@ -799,7 +1021,11 @@ static void handle_bus_reset(uint8_t rhport) {
     dwc2->epout[0].doeptsiz |= (3 << DOEPTSIZ_STUPCNT_Pos);
   }
 
-  dwc2->gintmsk |= GINTMSK_OTGINT | GINTMSK_OEPINT | GINTMSK_IEPINT | GINTMSK_IISOIXFRM;
+  // Scatter/Gather DMA schedules ISO IN by frame number in descriptor, incomplete ISO IN is not used
+  dwc2->gintmsk |= GINTMSK_OTGINT | GINTMSK_OEPINT | GINTMSK_IEPINT;
+  if (!dma_desc_enabled(dwc2)) {
+    dwc2->gintmsk |= GINTMSK_IISOIXFRM;
+  }
 }
 
 static void handle_enum_done(uint8_t rhport) {
@@ -1023,6 +1249,12 @@ static void handle_epout_dma(uint8_t rhport, uint8_t epnum, dwc2_doepint_t doepi
     // only handle data skip if it is setup or status related
     // Normal OUT transfer complete
     if (!doepint_bm.status_phase_rx && !doepint_bm.setup_packet_rx) {
+      #if CFG_TUD_DWC2_DMA_DESC_ENABLE
+      if (epnum == 0 && dma_desc_enabled(dwc2) && ddma_setup_received()) {
+        return; // SETUP is handled with setup phase done
+      }
+      #endif
+
       if ((epnum == 0) && _dcd_data.ep0_pending[TUSB_DIR_OUT]) {
         // EP0 can only handle one packet Schedule another packet to be received.
         edpt_schedule_packets(rhport, epnum, TUSB_DIR_OUT);
@@ -1031,8 +1263,19 @@ static void handle_epout_dma(uint8_t rhport, uint8_t epnum, dwc2_doepint_t doepi
         xfer_ctl_t* xfer = XFER_CTL_BASE(epnum, TUSB_DIR_OUT);
 
         // determine actual received bytes
-        const dwc2_ep_tsize_t tsiz = {.value = epout->tsiz};
-        const uint16_t remain = tsiz.xfer_size;
+        xfer_result_t result = XFER_RESULT_SUCCESS;
+        uint16_t remain;
+        #if CFG_TUD_DWC2_DMA_DESC_ENABLE
+        if (dma_desc_enabled(dwc2)) {
+          if (!ddma_complete(epout, epnum, TUSB_DIR_OUT, &remain)) {
+            result = XFER_RESULT_FAILED;
+          }
+        } else
+        #endif
+        {
+          const dwc2_ep_tsize_t tsiz = {.value = epout->tsiz};
+          remain = tsiz.xfer_size;
+        }
         xfer->total_len -= remain;
 
         // this is ZLP, so prepare EP0 for next setup
@@ -1041,8 +1284,15 @@ static void handle_epout_dma(uint8_t rhport, uint8_t epnum, dwc2_doepint_t doepi
           dma_setup_prepare(rhport);
         }
 
-        dcd_dcache_invalidate(xfer->buffer, xfer->total_len);
-        dcd_event_xfer_complete(rhport, epnum, xfer->total_len, XFER_RESULT_SUCCESS, true);
+        #if CFG_TUD_DWC2_DMA_DESC_ENABLE
+        if (xfer->ff != NULL) {
+          ddma_fifo_complete(xfer, TUSB_DIR_OUT, xfer->total_len);
+        } else
+        #endif
+        {
+          dcd_dcache_invalidate(xfer->buffer, xfer->total_len);
+        }
+        dcd_event_xfer_complete(rhport, epnum, xfer->total_len, result, true);
       }
     }
   }
@@ -1059,7 +1309,21 @@ static void handle_epin_dma(uint8_t rhport, uint8_t epnum, dwc2_diepint_t diepin
       if(epnum == 0) {
         dma_setup_prepare(rhport);
       }
-      dcd_event_xfer_complete(rhport, epnum | TUSB_DIR_IN_MASK, xfer->total_len, XFER_RESULT_SUCCESS, true);
+
+      xfer_result_t result = XFER_RESULT_SUCCESS;
+      #if CFG_TUD_DWC2_DMA_DESC_ENABLE
+      dwc2_regs_t* dwc2 = DWC2_REG(rhport);
+      if (dma_desc_enabled(dwc2)) {
+        uint16_t remain;
+        if (!ddma_complete(&dwc2->epin[epnum], epnum, TUSB_DIR_IN, &remain)) {
+          result = XFER_RESULT_FAILED;
+        }
+        if (xfer->ff != NULL) {
+          ddma_fifo_complete(xfer, TUSB_DIR_IN, xfer->total_len);
+        }
+      }
+      #endif
+      dcd_event_xfer_complete(rhport, epnum | TUSB_DIR_IN_MASK, xfer->total_len, result, true);
     }
   }
 }
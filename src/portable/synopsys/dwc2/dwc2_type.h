@@ -691,6 +691,13 @@ typedef struct {
 
 TU_VERIFY_STATIC(sizeof(dwc2_dep_t) == 0x20, "incorrect size");
 
+// Device Scatter/Gather DMA descriptor, endpoint DxEPDMA points to a list of these when DCFG.DESCDMA is set
+typedef struct {
+  volatile uint32_t status; // buffer status, transfer status, flags and byte count (DDMA_* bits)
+  volatile uint32_t buf;    // buffer address
+} dwc2_dma_desc_t;
+TU_VERIFY_STATIC(sizeof(dwc2_dma_desc_t) == 8, "incorrect size");
+
 //--------------------------------------------------------------------
 // CSR Register Map
 //--------------------------------------------------------------------
@@ -946,6 +953,10 @@ TU_VERIFY_STATIC(offsetof(dwc2_regs_t, fifo   ) == 0x1000, "incorrect size");
 #define DCFG_XCVRDLY_Msk                 (0x1UL << DCFG_XCVRDLY_Pos)             // 0x00004000
 #define DCFG_XCVRDLY                     DCFG_XCVRDLY_Msk                        // Enables delay between xcvr_sel and txvalid during device chirp
 
+#define DCFG_DESCDMA_Pos                 (23U)
+#define DCFG_DESCDMA_Msk                 (0x1UL << DCFG_DESCDMA_Pos)              // 0x00800000
+#define DCFG_DESCDMA                     DCFG_DESCDMA_Msk                         // Enable scatter/gather DMA
+
 #define DCFG_PERSCHIVL_Pos               (24U)
 #define DCFG_PERSCHIVL_Msk               (0x3UL << DCFG_PERSCHIVL_Pos)            // 0x03000000
 #define DCFG_PERSCHIVL                   DCFG_PERSCHIVL_Msk                       // Periodic scheduling interval
@@ -1744,6 +1755,37 @@ TU_VERIFY_STATIC(offsetof(dwc2_regs_t, fifo   ) == 0x1000, "incorrect size");
 #define GLPMCFG_ENBESL_Msk               (0x1UL << GLPMCFG_ENBESL_Pos)            // 0x10000000
 #define GLPMCFG_ENBESL                   GLPMCFG_ENBESL_Msk                       // Enable best effort service latency
 
+// Device Scatter/Gather DMA descriptor status
+#define DDMA_BYTES_Pos                   (0U)
+#define DDMA_BYTES_Msk                   (0xFFFFUL << DDMA_BYTES_Pos)             // Non-ISO: bytes to send or buffer size, remaining bytes on OUT completion
+#define DDMA_ISO_TX_BYTES_Msk            (0xFFFUL << DDMA_BYTES_Pos)              // ISO IN: bytes to send
+#define DDMA_ISO_RX_BYTES_Msk            (0x7FFUL << DDMA_BYTES_Pos)              // ISO OUT: buffer size, remaining bytes on completion
+#define DDMA_ISO_FRNUM_Pos               (12U)
+#define DDMA_ISO_FRNUM_Msk               (0x7FFUL << DDMA_ISO_FRNUM_Pos)          // ISO: (micro)frame number to transmit in or received in
+#define DDMA_MTRF_Pos                    (23U)
+#define DDMA_MTRF                        (0x1UL << DDMA_MTRF_Pos)                 // Non-ISO OUT: continue list after short packet
+#define DDMA_ISO_PID_Pos                 (23U)
+#define DDMA_ISO_PID_Msk                 (0x3UL << DDMA_ISO_PID_Pos)              // ISO IN: number of packets in (micro)frame
+#define DDMA_SR_Pos                      (24U)
+#define DDMA_SR                          (0x1UL << DDMA_SR_Pos)                   // Control OUT: SETUP packet received
+#define DDMA_IOC_Pos                     (25U)
+#define DDMA_IOC                         (0x1UL << DDMA_IOC_Pos)                  // Interrupt on complete
+#define DDMA_SP_Pos                      (26U)
+#define DDMA_SP                          (0x1UL << DDMA_SP_Pos)                   // IN: last packet is short, OUT: short packet received
+#define DDMA_L_Pos                       (27U)
+#define DDMA_L                           (0x1UL << DDMA_L_Pos)                    // Last descriptor of list
+#define DDMA_STS_Pos                     (28U)
+#define DDMA_STS_Msk                     (0x3UL << DDMA_STS_Pos)                  // Transfer status
+#define DDMA_STS_SUCCESS                 (0x0UL << DDMA_STS_Pos)
+#define DDMA_STS_BUFFLUSH                (0x1UL << DDMA_STS_Pos)
+#define DDMA_STS_BUFERR                  (0x3UL << DDMA_STS_Pos)
+#define DDMA_BS_Pos                      (30U)
+#define DDMA_BS_Msk                      (0x3UL << DDMA_BS_Pos)                   // Buffer status
+#define DDMA_BS_HOST_READY               (0x0UL << DDMA_BS_Pos)
+#define DDMA_BS_DMA_BUSY                 (0x1UL << DDMA_BS_Pos)
+#define DDMA_BS_DMA_DONE                 (0x2UL << DDMA_BS_Pos)
+#define DDMA_BS_HOST_BUSY                (0x3UL << DDMA_BS_Pos)
+
 // GDFIFOCFG
 #define GDFIFOCFG_EPINFOBASE_MASK   (0xffff << 16)
 #define GDFIFOCFG_EPINFOBASE_SHIFT  16
@@ -357,17 +357,28 @@ static bool stream_claim(tu_edpt_stream_t *s) {
   return false;
 }
 
-static bool stream_xfer(tu_edpt_stream_t *s, uint16_t count) {
+// Transfer with ep_buf, FIFO (dedicated hw fifo) or FIFO memory sent in place (direct_len > 0)
+static bool stream_xfer(tu_edpt_stream_t *s, uint16_t count, bool in_isr) {
+  (void) in_isr;
+  uint8_t *buf = s->ep_buf;
+#if CFG_TUSB_EDPT_STREAM_TX_DIRECT
+  if (s->direct_len > 0) {
+    tu_fifo_buffer_info_t info;
+    tu_fifo_get_read_info(&s->ff, &info);
+    buf = info.linear.ptr;
+  }
+#endif
+
   if (s->is_host) {
     #if CFG_TUH_ENABLED
-    return usbh_edpt_xfer(s->hwid, s->ep_addr, count ? s->ep_buf : NULL, count);
+    return usbh_edpt_xfer(s->hwid, s->ep_addr, count ? buf : NULL, count);
   #endif
   } else {
     #if CFG_TUD_ENABLED
     if (s->ep_buf == NULL) {
-      return usbd_edpt_xfer_fifo(s->hwid, s->ep_addr, &s->ff, count, false);
+      return usbd_edpt_xfer_fifo(s->hwid, s->ep_addr, &s->ff, count, in_isr);
     } else {
-      return usbd_edpt_xfer(s->hwid, s->ep_addr, count ? s->ep_buf : NULL, count, false);
+      return usbd_edpt_xfer(s->hwid, s->ep_addr, count ? buf : NULL, count, in_isr);
     }
   #endif
   }
@@ -390,11 +401,54 @@ static bool stream_release(tu_edpt_stream_t *s) {
 //--------------------------------------------------------------------+
 // Stream Write
 //--------------------------------------------------------------------+
+// ZLP condition: no pending data, last transferred bytes is multiple of packet size
+TU_ATTR_ALWAYS_INLINE static inline bool stream_zlp_needed(tu_edpt_stream_t *s, uint32_t last_xferred_bytes) {
+  return tu_fifo_empty(&s->ff) && last_xferred_bytes > 0 && (0 == (last_xferred_bytes & (s->mps - 1)));
+}
+
+#if CFG_TUSB_EDPT_STREAM_TX_DIRECT
+// Copy count for direct stream: if more data follows, end the copy where the next read is word aligned so that
+// following transfers can be sent in place
+static uint16_t stream_write_copy_count(const tu_edpt_stream_t *s, const tu_fifo_buffer_info_t *info) {
+  const uint16_t total = info->linear.len + info->wrapped.len;
+  uint16_t count = tu_min16(total, s->xfer_len);
+  if (count < total) {
+    const uint8_t *end = (count <= info->linear.len) ? (info->linear.ptr + count)
+                                                      : (info->wrapped.ptr + (count - info->linear.len));
+    count -= (uint16_t) ((uintptr_t) end & 3u);
+  }
+  return count;
+}
+#endif
+
+// Pull data from FIFO -> EP buf, return number of bytes to transfer
+static uint16_t stream_write_prepare(tu_edpt_stream_t *s) {
+  if (s->ep_buf == NULL) {
+    return tu_fifo_count(&s->ff);
+  }
+
+  uint16_t count = s->xfer_len;
+#if CFG_TUSB_EDPT_STREAM_TX_DIRECT
+  if (s->direct && !s->ff.overwritable) {
+    tu_fifo_buffer_info_t info;
+    tu_fifo_get_read_info(&s->ff, &info);
+    if (info.linear.len >= s->xfer_len && 0 == ((uintptr_t) info.linear.ptr & 3u)) {
+      // send in place, FIFO data is released by tu_edpt_stream_write_xfer_complete()
+      s->direct_len = info.linear.len;
+      return info.linear.len;
+    }
+    count = stream_write_copy_count(s, &info);
+  }
+  s->direct_len = 0;
+#endif
+
+  return tu_fifo_read_n(&s->ff, s->ep_buf, count);
+}
+
 bool tu_edpt_stream_write_zlp_if_needed(tu_edpt_stream_t *s, uint32_t last_xferred_bytes) {
-  // ZLP condition: no pending data, last transferred bytes is multiple of packet size
-  TU_VERIFY(tu_fifo_empty(&s->ff) && last_xferred_bytes > 0 && (0 == (last_xferred_bytes & (s->mps - 1))));
+  TU_VERIFY(stream_zlp_needed(s, last_xferred_bytes));
   TU_VERIFY(stream_claim(s));
-  TU_ASSERT(stream_xfer(s, 0));
+  TU_ASSERT(stream_xfer(s, 0, false));
   return true;
 }
 
@@ -403,16 +457,10 @@ uint32_t tu_edpt_stream_write_xfer(tu_edpt_stream_t *s) {
   TU_VERIFY(ff_count > 0, 0); // skip if no data
   TU_VERIFY(stream_claim(s), 0);
 
-  // Pull data from FIFO -> EP buf
-  uint16_t count;
-  if (s->ep_buf == NULL) {
-    count = tu_fifo_count(&s->ff); // re-get count since fifo can be changed
-  } else {
-    count = tu_fifo_read_n(&s->ff, s->ep_buf, s->xfer_len);
-  }
+  const uint16_t count = stream_write_prepare(s); // re-get count since fifo can be changed
 
   if (count > 0) {
-    TU_ASSERT(stream_xfer(s, count), 0);
+    TU_ASSERT(stream_xfer(s, count, false), 0);
     return count;
   } else {
     // Release endpoint since we don't make any transfer
@@ -422,41 +470,146 @@ uint32_t tu_edpt_stream_write_xfer(tu_edpt_stream_t *s) {
   }
 }
 
+// flush if fifo has more than packet size or
+// in rare case: fifo depth is configured too small (which never reach packet size)
+static void stream_write_flush_if_needed(tu_edpt_stream_t *s) {
+  if ((tu_fifo_count(&s->ff) >= s->mps) || (tu_fifo_depth(&s->ff) < s->mps)) {
+    tu_edpt_stream_write_xfer(s);
+  }
+}
+
 uint32_t tu_edpt_stream_write(tu_edpt_stream_t *s, const void *buffer, uint32_t bufsize) {
   TU_VERIFY(bufsize > 0);
   const uint16_t ret = tu_fifo_write_n(&s->ff, buffer, (uint16_t) bufsize);
+  stream_write_flush_if_needed(s);
+  return ret;
+}
 
-  // flush if fifo has more than packet size or
-  // in rare case: fifo depth is configured too small (which never reach packet size)
-  if ((tu_fifo_count(&s->ff) >= s->mps) || (tu_fifo_depth(&s->ff) < s->mps)) {
-    tu_edpt_stream_write_xfer(s);
+uint32_t tu_edpt_stream_write_commit(tu_edpt_stream_t *s, uint16_t n) {
+  tu_fifo_write_commit(&s->ff, n);
+  if (n > 0) {
+    stream_write_flush_if_needed(s);
   }
-  return ret;
+  return n;
 }
 
 uint32_t tu_edpt_stream_write_available(tu_edpt_stream_t *s) {
   return (uint32_t)tu_fifo_remaining(&s->ff);
 }
 
+#if CFG_TUSB_EDPT_STREAM_WRITE_BUFFER
+// Largest transfer of user buffer: multiple of packet size that fits transfer length
+TU_ATTR_ALWAYS_INLINE static inline uint16_t stream_write_buffer_count(const tu_edpt_stream_t *s) {
+  const uint32_t remaining = s->user_len - s->user_sent;
+  return (uint16_t) tu_min32(remaining, UINT16_MAX & ~(uint32_t) (s->mps - 1));
+}
+
+static bool stream_write_buffer_xfer(tu_edpt_stream_t *s) {
+  const uint16_t count = stream_write_buffer_count(s);
+  if (s->is_host) {
+    #if CFG_TUH_ENABLED
+    return usbh_edpt_xfer(s->hwid, s->ep_addr, (uint8_t *) (uintptr_t) (s->user_buf + s->user_sent), count);
+    #endif
+  } else {
+    #if CFG_TUD_ENABLED
+    return usbd_edpt_xfer(s->hwid, s->ep_addr, (uint8_t *) (uintptr_t) (s->user_buf + s->user_sent), count, false);
+    #endif
+  }
+  return false;
+}
+
+bool tu_edpt_stream_write_buffer(tu_edpt_stream_t *s, const void *buffer, uint32_t bufsize) {
+  TU_VERIFY(bufsize > 0 && 0 == ((uintptr_t) buffer & 3u));
+  TU_VERIFY(s->user_buf == NULL && tu_fifo_empty(&s->ff)); // pre-check reduces endpoint claiming
+  TU_VERIFY(stream_claim(s));
+
+  // re-check since FIFO can be written before endpoint is claimed
+  if (!tu_fifo_empty(&s->ff)) {
+    stream_release(s);
+    return false;
+  }
+
+  s->user_buf  = (const uint8_t *) buffer;
+  s->user_len  = bufsize;
+  s->user_sent = 0;
+  if (!stream_write_buffer_xfer(s)) {
+    s->user_buf = NULL;
+    TU_BREAKPOINT();
+    return false;
+  }
+  return true;
+}
+
+bool tu_edpt_stream_write_buffer_xfer_complete(tu_edpt_stream_t *s, uint32_t xferred_bytes) {
+  const uint16_t count = stream_write_buffer_count(s);
+  s->user_sent += xferred_bytes;
+
+  if (xferred_bytes == count && s->user_sent < s->user_len && stream_claim(s)) {
+    if (stream_write_buffer_xfer(s)) {
+      return false;
+    }
+  }
+
+  s->user_buf = NULL;
+  return true;
+}
+#endif
+
 //--------------------------------------------------------------------+
 // Stream Read
 //--------------------------------------------------------------------+
+// multiple of packet size limit by ep bufsize
+TU_ATTR_ALWAYS_INLINE static inline uint16_t stream_read_count(const tu_edpt_stream_t *s, uint16_t available) {
+  return tu_min16((uint16_t) (available & ~(s->mps - 1)), s->xfer_len);
+}
+
+#if CFG_TUSB_EDPT_STREAM_RX_STAGED
+// Move staged bytes ep_buf -> FIFO
+static void stream_read_drain(tu_edpt_stream_t *s) {
+  if (s->staged_len > 0) {
+    const uint16_t count = tu_fifo_write_n(&s->ff, s->ep_buf + s->staged_ofs, s->staged_len);
+    s->staged_ofs += count;
+    s->staged_len -= count;
+  }
+}
+
+// Staged receive: transfer whole ep_buf regardless of FIFO space. Endpoint is claimed while draining so that
+// staged bytes are not touched by another task
+static uint32_t stream_read_xfer_staged(tu_edpt_stream_t *s) {
+  // This pre-check reduces endpoint claiming
+  TU_VERIFY(s->staged_len == 0 || !tu_fifo_full(&s->ff), 0);
+  TU_VERIFY(stream_claim(s), 0);
+  stream_read_drain(s);
+
+  if (s->staged_len == 0) {
+    const uint16_t count = stream_read_count(s, s->xfer_len);
+    TU_ASSERT(stream_xfer(s, count, false), 0);
+    return count;
+  } else {
+    // ep_buf still holds data, next transfer is started by read()
+    stream_release(s);
+    return 0;
+  }
+}
+#endif
+
 uint32_t tu_edpt_stream_read_xfer(tu_edpt_stream_t *s) {
-  uint16_t available = tu_fifo_remaining(&s->ff);
+#if CFG_TUSB_EDPT_STREAM_RX_STAGED
+  if (s->staged) {
+    return stream_read_xfer_staged(s);
+  }
+#endif
 
-  // Prepare for incoming data but only allow what we can store in the ring buffer.
-  // TODO Actually we can still carry out the transfer, keeping count of received bytes
-  // and slowly move it to the FIFO when read().
+  // Transfer directly into FIFO: only allow what we can store in the ring buffer.
   // This pre-check reduces endpoint claiming
+  uint16_t available = tu_fifo_remaining(&s->ff);
   TU_VERIFY(available >= s->mps);
   TU_VERIFY(stream_claim(s), 0);
   available = tu_fifo_remaining(&s->ff); // re-get available since fifo can be changed
 
   if (available >= s->mps) {
-    // multiple of packet size limit by ep bufsize
-    uint16_t count = (uint16_t) (available & ~(s->mps - 1));
-    count = tu_min16(count, s->xfer_len);
-    TU_ASSERT(stream_xfer(s, count), 0);
+    const uint16_t count = stream_read_count(s, available);
+    TU_ASSERT(stream_xfer(s, count, false), 0);
     return count;
   } else {
     // Release endpoint since we don't make any transfer
@@ -466,11 +619,53 @@ uint32_t tu_edpt_stream_read_xfer(tu_edpt_stream_t *s) {
 }
 
 uint32_t tu_edpt_stream_read(tu_edpt_stream_t *s, void *buffer, uint32_t bufsize) {
-  const uint32_t num_read = tu_fifo_read_n(&s->ff, buffer, (uint16_t)bufsize);
-  tu_edpt_stream_read_xfer(s);
+  uint32_t num_read = tu_fifo_read_n(&s->ff, buffer, (uint16_t)bufsize);
+  const bool has_staged = (tu_edpt_stream_staged_count(s) > 0);
+  tu_edpt_stream_read_xfer(s); // also move staged bytes to FIFO
+
+  // continue with staged bytes just moved to FIFO
+  if (has_staged && num_read < bufsize) {
+    num_read += tu_fifo_read_n(&s->ff, (uint8_t *) buffer + num_read, (uint16_t) (bufsize - num_read));
+    tu_edpt_stream_read_xfer(s);
+  }
   return num_read;
 }
 
+#if CFG_TUD_ENABLED
+//--------------------------------------------------------------------+
+// Stream Transfer in ISR
+// usbd keeps the endpoint claimed (busy cleared) while invoking class driver xfer_isr(), therefore no task can claim
+// the endpoint and it is used without claiming. usbd releases it if no transfer is queued.
+//--------------------------------------------------------------------+
+uint32_t tu_edpt_stream_write_xfer_isr(tu_edpt_stream_t *s, uint32_t last_xferred_bytes) {
+  const uint16_t count = stream_write_prepare(s);
+  if (count > 0) {
+    TU_ASSERT(stream_xfer(s, count, true), 0);
+  } else if (stream_zlp_needed(s, last_xferred_bytes)) {
+    TU_ASSERT(stream_xfer(s, 0, true), 0);
+  }
+  return count;
+}
+
+uint32_t tu_edpt_stream_read_xfer_isr(tu_edpt_stream_t *s) {
+  uint16_t count;
+#if CFG_TUSB_EDPT_STREAM_RX_STAGED
+  if (s->staged) {
+    // staged bytes are moved to FIFO by read() in task context
+    TU_VERIFY(s->staged_len == 0, 0);
+    count = stream_read_count(s, s->xfer_len);
+  } else
+#endif
+  {
+    const uint16_t available = tu_fifo_remaining(&s->ff);
+    TU_VERIFY(available >= s->mps, 0);
+    count = stream_read_count(s, available);
+  }
+  TU_ASSERT(stream_xfer(s, count, true), 0);
+  return count;
+}
+#endif
+
 //--------------------------------------------------------------------+
 // Debug
 //--------------------------------------------------------------------+
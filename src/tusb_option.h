@@ -313,6 +313,12 @@
   #define CFG_TUD_DWC2_SLAVE_ENABLE CFG_TUD_DWC2_SLAVE_ENABLE_DEFAULT
 #endif
 
+// Scatter/Gather (descriptor) DMA mode for device, requires CFG_TUD_DWC2_DMA_ENABLE and is only used if supported by
+// the core (GHWCFG4). Transfers are described by descriptor lists, which also allows DMA to/from a wrapped tu_fifo
+#ifndef CFG_TUD_DWC2_DMA_DESC_ENABLE
+  #define CFG_TUD_DWC2_DMA_DESC_ENABLE 0
+#endif
+
 // DMA mode for host
 #ifndef CFG_TUH_DWC2_DMA_ENABLE
   #ifndef CFG_TUH_DWC2_DMA_ENABLE_DEFAULT
@@ -365,6 +371,26 @@
   #define CFG_TUH_MAX3421 0
 #endif
 
+//------------ Simulator -------------//
+// In-process simulated controller, used to run/benchmark the stack on a host PC without hardware
+#ifndef CFG_TUD_SIM
+  #define CFG_TUD_SIM 0
+#endif
+
+#ifndef CFG_TUH_SIM
+  #define CFG_TUH_SIM 0
+#endif
+
+#if CFG_TUD_SIM
+  // simulated endpoint memory is plain RAM: byte access with incrementing address
+  #ifndef CFG_TUSB_FIFO_HWFIFO_DATA_STRIDE
+    #define CFG_TUSB_FIFO_HWFIFO_DATA_STRIDE 1
+  #endif
+  #ifndef CFG_TUSB_FIFO_HWFIFO_ADDR_STRIDE
+    #define CFG_TUSB_FIFO_HWFIFO_ADDR_STRIDE 1
+  #endif
+#endif
+
 //------------ MUSB --------------//
 #if defined(TUP_USBIP_MUSB)
   #define CFG_TUD_EDPT_DEDICATED_HWFIFO              1
@@ -503,6 +529,18 @@
   #define CFG_TUSB_DEBUG 0
 #endif
 
+// Runtime statistics: per endpoint transfer counters, event queue high-water mark and control transfer latency
+// histogram of device and host stack. Requires tusb_time_millis_api()
+#ifndef CFG_TUSB_STATS
+  #define CFG_TUSB_STATS 0
+#endif
+
+// Number of entries in the binary trace buffer of timestamped stack events, 0 to disable, see tu_trace_read().
+// Requires tusb_time_millis_api()
+#ifndef CFG_TUSB_TRACE_DEPTH
+  #define CFG_TUSB_TRACE_DEPTH 0
+#endif
+
 // Level where CFG_TUSB_DEBUG must be at least for USBH is logged
 #ifndef CFG_TUH_LOG_LEVEL
   #define CFG_TUH_LOG_LEVEL   2
@@ -589,6 +627,17 @@
   #define CFG_TUD_TASK_EVENTS_PER_RUN  16
 #endif
 
+// Merge consecutive SOF events when draining the event queue: tud_sof_cb() is only invoked with the latest frame count.
+// Class driver sof() is invoked in ISR and not affected
+#ifndef CFG_TUD_TASK_MERGE_SOF
+  #define CFG_TUD_TASK_MERGE_SOF  0
+#endif
+
+// Event queue statistics (high-water mark, merged SOF events), see tud_task_stats_get()
+#ifndef CFG_TUD_TASK_STATS
+  #define CFG_TUD_TASK_STATS  CFG_TUSB_STATS
+#endif
+
 // default to max hardware endpoint, but can be smaller to save RAM
 #ifndef CFG_TUD_ENDPPOINT_MAX
   #define CFG_TUD_ENDPPOINT_MAX   TUP_DCD_ENDPOINT_MAX
@@ -686,6 +735,46 @@
   #define CFG_TUD_EDPT_DEDICATED_HWFIFO 0
 #endif
 
+//------------- Endpoint Stream -------------//
+// Class options that change the endpoint stream (tu_edpt_stream_t) layout are defaulted here instead of in class
+// headers, since every source file must see the same layout.
+
+// Staged receive: RX endpoint keeps receiving into its buffer while FIFO is full, see tu_edpt_stream_set_staged()
+#ifndef CFG_TUD_CDC_RX_STAGED
+  #define CFG_TUD_CDC_RX_STAGED 0
+#endif
+
+#ifndef CFG_TUD_VENDOR_RX_STAGED
+  #define CFG_TUD_VENDOR_RX_STAGED 0
+#endif
+
+#ifndef CFG_TUD_MIDI_RX_STAGED
+  #define CFG_TUD_MIDI_RX_STAGED 0
+#endif
+
+#define CFG_TUSB_EDPT_STREAM_RX_STAGED (CFG_TUD_CDC_RX_STAGED || CFG_TUD_VENDOR_RX_STAGED || CFG_TUD_MIDI_RX_STAGED)
+
+// Send CDC tx fifo data in place instead of copying it to endpoint buffer: a transfer can carry all contiguous data of
+// the fifo rather than CFG_TUD_CDC_TX_EPSIZE, which cuts per-transfer overhead on high speed ports. Interface memory is
+// then placed in CFG_TUD_MEM_SECTION since controller reads the fifo directly. Not used with dedicated hw fifo, which
+// already transfers from fifo. Use large CFG_TUD_CDC_TX_BUFSIZE (multiple of packet size) to benefit.
+#ifndef CFG_TUD_CDC_TX_DIRECT
+  #define CFG_TUD_CDC_TX_DIRECT 0
+#endif
+
+#define CFG_TUSB_EDPT_STREAM_TX_DIRECT CFG_TUD_CDC_TX_DIRECT
+
+// Send caller's buffer without copying to TX FIFO: tud_cdc_n_write_buffer(), tud_vendor_n_write_buffer()
+#ifndef CFG_TUD_CDC_WRITE_BUFFER
+  #define CFG_TUD_CDC_WRITE_BUFFER 0
+#endif
+
+#ifndef CFG_TUD_VENDOR_WRITE_BUFFER
+  #define CFG_TUD_VENDOR_WRITE_BUFFER 0
+#endif
+
+#define CFG_TUSB_EDPT_STREAM_WRITE_BUFFER (CFG_TUD_CDC_WRITE_BUFFER || CFG_TUD_VENDOR_WRITE_BUFFER)
+
 //--------------------------------------------------------------------
 // Host Options (Default)
 //--------------------------------------------------------------------
@@ -726,6 +815,11 @@
   #define CFG_TUH_TASK_EVENTS_PER_RUN  16
 #endif
 
+// Event queue statistics (high-water mark), see tuh_task_stats_get()
+#ifndef CFG_TUH_TASK_STATS
+  #define CFG_TUH_TASK_STATS  CFG_TUSB_STATS
+#endif
+
 //------------- CLASS -------------//
 
 #ifndef CFG_TUH_HUB
@@ -0,0 +1,360 @@
+/*
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2026 Ha Thach (tinyusb.org)
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ *
+ * This file is part of the TinyUSB stack.
+ */
+
+// DWC2 Scatter/Gather (descriptor) DMA: register level mock of the device controller. The driver is included in this
+// file to inspect its descriptor lists. Each test checks the descriptor chain built for a transfer, then plays the DMA
+// engine by writing back descriptor status and raising the endpoint interrupt, and checks the completion event.
+// Note: descriptors hold 32-bit addresses, on a 64-bit host only the lower half of pointers is compared.
+
+#include <string.h>
+
+#include "portable/synopsys/dwc2/dcd_dwc2.c"
+#include "test_common.h"
+
+dwc2_regs_t dwc2_mock_regs;
+#define regs dwc2_mock_regs
+
+#define ADDR32(_p) ((uint32_t) (uintptr_t) (_p))
+
+//--------------------------------------------------------------------+
+// usbd stubs
+//--------------------------------------------------------------------+
+static dcd_event_t last_event;
+static uint32_t    event_count;
+
+void dcd_event_handler(dcd_event_t const *event, bool in_isr) {
+  (void) in_isr;
+  last_event = *event;
+  event_count++;
+}
+
+void usbd_spin_lock(bool in_isr) {
+  (void) in_isr;
+}
+
+void usbd_spin_unlock(bool in_isr) {
+  (void) in_isr;
+}
+
+// no data cache on host
+bool dcd_dcache_clean(const void *addr, uint32_t data_size) {
+  (void) addr;
+  (void) data_size;
+  return true;
+}
+
+bool dcd_dcache_invalidate(const void *addr, uint32_t data_size) {
+  (void) addr;
+  (void) data_size;
+  return true;
+}
+
+//--------------------------------------------------------------------+
+// Mock helpers
+//--------------------------------------------------------------------+
+// Controller with internal DMA after bus reset, descriptor DMA is supported if ddma is true
+static void mock_reset(bool ddma) {
+  tu_memclr(&regs, sizeof(regs));
+
+  dwc2_ghwcfg2_t ghwcfg2 = {.value = 0};
+  ghwcfg2.arch           = GHWCFG2_ARCH_INTERNAL_DMA;
+  ghwcfg2.num_dev_ep     = DWC2_EP_MAX - 1;
+  regs.ghwcfg2           = ghwcfg2.value;
+
+  dwc2_ghwcfg4_t ghwcfg4   = {.value = 0};
+  ghwcfg4.dma_desc_enabled = ddma ? 1 : 0;
+  regs.ghwcfg4             = ghwcfg4.value;
+
+  dwc2_dsts_t dsts = {.value = 0};
+  dsts.enum_speed  = DCFG_SPEED_HIGH;
+  regs.dsts        = dsts.value;
+
+  tu_memclr(xfer_status, sizeof(xfer_status));
+  tu_memclr(&_dcd_data, sizeof(_dcd_data));
+  dfifo_device_init(0);
+  xfer_status[0][TUSB_DIR_OUT].max_size = CFG_TUD_ENDPOINT0_SIZE;
+  xfer_status[0][TUSB_DIR_IN].max_size  = CFG_TUD_ENDPOINT0_SIZE;
+  event_count                           = 0;
+}
+
+static void mock_open(uint8_t ep_addr, uint8_t xfer_type, uint16_t mps) {
+  const tusb_desc_endpoint_t desc = {
+    .bLength          = sizeof(tusb_desc_endpoint_t),
+    .bDescriptorType  = TUSB_DESC_ENDPOINT,
+    .bEndpointAddress = ep_addr,
+    .bmAttributes     = {.xfer = xfer_type},
+    .wMaxPacketSize   = mps,
+    .bInterval        = 1
+  };
+  TEST_ASSERT(dcd_edpt_open(0, &desc));
+}
+
+static dwc2_dma_desc_t *mock_desc(uint8_t ep_addr) {
+  return _dcd_ddma[tu_edpt_number(ep_addr)][tu_edpt_dir(ep_addr)].list.desc;
+}
+
+// DMA engine is done with descriptor: write back remaining bytes and transfer status
+static void mock_desc_done(dwc2_dma_desc_t *desc, uint16_t remain, uint32_t sts) {
+  desc->status = (desc->status & ~(DDMA_BS_Msk | DDMA_STS_Msk | DDMA_BYTES_Msk)) | DDMA_BS_DMA_DONE | sts | remain;
+}
+
+// raise endpoint interrupt and run the driver ISR
+static void mock_ep_irq(uint8_t ep_addr, uint32_t epint) {
+  const uint8_t epnum = tu_edpt_number(ep_addr);
+  if (tu_edpt_dir(ep_addr) == TUSB_DIR_IN) {
+    regs.epin[epnum].diepint = epint;
+    regs.daint               = TU_BIT(DAINT_IEPINT_Pos + epnum);
+    regs.gintsts             = GINTSTS_IEPINT;
+  } else {
+    regs.epout[epnum].doepint = epint;
+    regs.daint                = TU_BIT(DAINT_OEPINT_Pos + epnum);
+    regs.gintsts              = GINTSTS_OEPINT;
+  }
+  regs.gintmsk = GINTMSK_IEPINT | GINTMSK_OEPINT;
+  dcd_int_handler(0);
+}
+
+static void check_xfer_complete(uint8_t ep_addr, uint32_t len, xfer_result_t result) {
+  TEST_ASSERT(event_count == 1);
+  TEST_ASSERT(last_event.event_id == DCD_EVENT_XFER_COMPLETE);
+  TEST_ASSERT(last_event.xfer_complete.ep_addr == ep_addr);
+  TEST_ASSERT(last_event.xfer_complete.len == len);
+  TEST_ASSERT(last_event.xfer_complete.result == result);
+  event_count = 0;
+}
+
+// Configure fifo and move its indices to offset so that linear part ends there
+static void fifo_at(tu_fifo_t *ff, uint8_t *buf, uint16_t depth, uint16_t offset) {
+  static uint8_t scratch[4096];
+  tu_fifo_config(ff, buf, depth, false);
+  tu_fifo_write_n(ff, scratch, offset);
+  tu_fifo_read_n(ff, scratch, offset);
+}
+
+//--------------------------------------------------------------------+
+// Tests
+//--------------------------------------------------------------------+
+static void test_setup(void) {
+  mock_reset(true);
+  dma_setup_prepare(0);
+
+  dwc2_dma_desc_t *desc = &_dcd_usbbuf.setup_desc;
+  TEST_ASSERT(regs.epout[0].doepdma == ADDR32(desc));
+  TEST_ASSERT(desc->buf == ADDR32(_dcd_usbbuf.setup_packet));
+  TEST_ASSERT(desc->status == (DDMA_BS_HOST_READY | DDMA_L | DDMA_IOC | 8));
+  TEST_ASSERT(regs.epout[0].doepctl & DOEPCTL_EPENA);
+
+  // XferCompl of SETUP descriptor is ignored, SETUP is reported with setup phase done
+  const uint8_t setup[8] = {0x80, 0x06, 0x00, 0x01, 0x00, 0x00, 0x12, 0x00};
+  memcpy(_dcd_usbbuf.setup_packet, setup, 8);
+  mock_desc_done(desc, 0, DDMA_STS_SUCCESS);
+  desc->status |= DDMA_SR;
+  mock_ep_irq(0x00, DOEPINT_XFRC);
+  TEST_ASSERT(event_count == 0);
+
+  mock_ep_irq(0x00, DOEPINT_SETUP);
+  TEST_ASSERT(event_count == 1 && last_event.event_id == DCD_EVENT_SETUP_RECEIVED);
+  TEST_ASSERT(0 == memcmp(&last_event.setup_received, setup, 8));
+
+  // next SETUP descriptor is re-armed
+  TEST_ASSERT(desc->status == (DDMA_BS_HOST_READY | DDMA_L | DDMA_IOC | 8));
+  printf("setup: ok\n");
+}
+
+static void test_bulk_in_buffer(void) {
+  static uint8_t buf[1000];
+  mock_reset(true);
+  mock_open(0x81, TUSB_XFER_BULK, 512);
+
+  TEST_ASSERT(dcd_edpt_xfer(0, 0x81, buf, sizeof(buf), false));
+  dwc2_dma_desc_t *desc = mock_desc(0x81);
+  TEST_ASSERT(regs.epin[1].diepdma == ADDR32(desc));
+  TEST_ASSERT(regs.epin[1].diepctl & DIEPCTL_EPENA);
+  TEST_ASSERT(desc[0].buf == ADDR32(buf));
+  TEST_ASSERT(desc[0].status == (DDMA_BS_HOST_READY | DDMA_SP | DDMA_L | DDMA_IOC | sizeof(buf)));
+
+  mock_desc_done(&desc[0], 0, DDMA_STS_SUCCESS);
+  mock_ep_irq(0x81, DIEPINT_XFRC);
+  check_xfer_complete(0x81, sizeof(buf), XFER_RESULT_SUCCESS);
+  printf("bulk in buffer: ok\n");
+}
+
+// wrapped fifo whose linear part ends on packet boundary is chained into 2 descriptors
+static void test_bulk_in_fifo_chained(void) {
+  TU_ATTR_ALIGNED(4) static uint8_t ff_buf[2048];
+  tu_fifo_t ff;
+  mock_reset(true);
+  mock_open(0x81, TUSB_XFER_BULK, 512);
+
+  fifo_at(&ff, ff_buf, sizeof(ff_buf), 1024);
+  static uint8_t data[1524];
+  TEST_ASSERT(tu_fifo_write_n(&ff, data, sizeof(data)) == sizeof(data));
+
+  TEST_ASSERT(dcd_edpt_xfer_fifo(0, 0x81, &ff, sizeof(data), false));
+  dwc2_dma_desc_t *desc = mock_desc(0x81);
+  TEST_ASSERT(desc[0].buf == ADDR32(ff_buf + 1024));
+  TEST_ASSERT(desc[0].status == (DDMA_BS_HOST_READY | 1024));
+  TEST_ASSERT(desc[1].buf == ADDR32(ff_buf));
+  TEST_ASSERT(desc[1].status == (DDMA_BS_HOST_READY | DDMA_SP | DDMA_L | DDMA_IOC | 500));
+
+  mock_desc_done(&desc[0], 0, DDMA_STS_SUCCESS);
+  mock_desc_done(&desc[1], 0, DDMA_STS_SUCCESS);
+  mock_ep_irq(0x81, DIEPINT_XFRC);
+  check_xfer_complete(0x81, sizeof(data), XFER_RESULT_SUCCESS);
+  TEST_ASSERT(tu_fifo_empty(&ff)); // read pointer advanced by DMA'ed bytes
+  printf("bulk in fifo chained: ok\n");
+}
+
+// linear part not on packet boundary: only linear part is transferred, rest is sent by next transfer
+static void test_bulk_in_fifo_linear(void) {
+  TU_ATTR_ALIGNED(4) static uint8_t ff_buf[2048];
+  tu_fifo_t ff;
+  mock_reset(true);
+  mock_open(0x81, TUSB_XFER_BULK, 512);
+
+  fifo_at(&ff, ff_buf, sizeof(ff_buf), 1048);
+  static uint8_t data[1500];
+  TEST_ASSERT(tu_fifo_write_n(&ff, data, sizeof(data)) == sizeof(data));
+
+  TEST_ASSERT(dcd_edpt_xfer_fifo(0, 0x81, &ff, sizeof(data), false));
+  dwc2_dma_desc_t *desc = mock_desc(0x81);
+  TEST_ASSERT(desc[0].buf == ADDR32(ff_buf + 1048));
+  TEST_ASSERT(desc[0].status == (DDMA_BS_HOST_READY | DDMA_SP | DDMA_L | DDMA_IOC | 1000));
+
+  mock_desc_done(&desc[0], 0, DDMA_STS_SUCCESS);
+  mock_ep_irq(0x81, DIEPINT_XFRC);
+  check_xfer_complete(0x81, 1000, XFER_RESULT_SUCCESS);
+  TEST_ASSERT(tu_fifo_count(&ff) == 500);
+  printf("bulk in fifo linear: ok\n");
+}
+
+// OUT into wrapped fifo, short packet ends the transfer in 2nd descriptor
+static void test_bulk_out_fifo_short(void) {
+  TU_ATTR_ALIGNED(4) static uint8_t ff_buf[2048];
+  tu_fifo_t ff;
+  mock_reset(true);
+  mock_open(0x02, TUSB_XFER_BULK, 512);
+
+  fifo_at(&ff, ff_buf, sizeof(ff_buf), 1024);
+  TEST_ASSERT(dcd_edpt_xfer_fifo(0, 0x02, &ff, 2048, false));
+  dwc2_dma_desc_t *desc = mock_desc(0x02);
+  TEST_ASSERT(regs.epout[2].doepdma == ADDR32(desc));
+  TEST_ASSERT(desc[0].buf == ADDR32(ff_buf + 1024));
+  TEST_ASSERT(desc[0].status == (DDMA_BS_HOST_READY | 1024));
+  TEST_ASSERT(desc[1].buf == ADDR32(ff_buf));
+  TEST_ASSERT(desc[1].status == (DDMA_BS_HOST_READY | DDMA_L | DDMA_IOC | 1024));
+
+  // host sends 1024 + 100 bytes
+  mock_desc_done(&desc[0], 0, DDMA_STS_SUCCESS);
+  mock_desc_done(&desc[1], 1024 - 100, DDMA_STS_SUCCESS);
+  desc[1].status |= DDMA_SP;
+  mock_ep_irq(0x02, DOEPINT_XFRC);
+  check_xfer_complete(0x02, 1124, XFER_RESULT_SUCCESS);
+  TEST_ASSERT(tu_fifo_count(&ff) == 1124); // write pointer advanced by received bytes
+  printf("bulk out fifo short packet: ok\n");
+}
+
+// OUT ends with short packet in 1st descriptor, 2nd descriptor is untouched by DMA
+static void test_bulk_out_fifo_first_short(void) {
+  TU_ATTR_ALIGNED(4) static uint8_t ff_buf[2048];
+  tu_fifo_t ff;
+  mock_reset(true);
+  mock_open(0x02, TUSB_XFER_BULK, 512);
+
+  fifo_at(&ff, ff_buf, sizeof(ff_buf), 1024);
+  TEST_ASSERT(dcd_edpt_xfer_fifo(0, 0x02, &ff, 2048, false));
+  dwc2_dma_desc_t *desc = mock_desc(0x02);
+
+  mock_desc_done(&desc[0], 1024 - 10, DDMA_STS_SUCCESS);
+  mock_ep_irq(0x02, DOEPINT_XFRC);
+  check_xfer_complete(0x02, 10, XFER_RESULT_SUCCESS);
+  TEST_ASSERT(tu_fifo_count(&ff) == 10);
+  printf("bulk out fifo short 1st descriptor: ok\n");
+}
+
+static void test_desc_error(void) {
+  static uint8_t buf[64];
+  mock_reset(true);
+  mock_open(0x81, TUSB_XFER_BULK, 512);
+
+  TEST_ASSERT(dcd_edpt_xfer(0, 0x81, buf, sizeof(buf), false));
+  dwc2_dma_desc_t *desc = mock_desc(0x81);
+  mock_desc_done(&desc[0], 0, DDMA_STS_BUFERR);
+  mock_ep_irq(0x81, DIEPINT_XFRC);
+  check_xfer_complete(0x81, sizeof(buf), XFER_RESULT_FAILED);
+  printf("descriptor error: ok\n");
+}
+
+// ISO IN is a single descriptor scheduled for the next (micro)frame
+static void test_iso_in(void) {
+  static uint8_t buf[600];
+  mock_reset(true);
+  mock_open(0x83, TUSB_XFER_ISOCHRONOUS, 256);
+
+  dwc2_dsts_t dsts  = {.value = regs.dsts};
+  dsts.frame_number = 100;
+  regs.dsts         = dsts.value;
+
+  TEST_ASSERT(dcd_edpt_xfer(0, 0x83, buf, sizeof(buf), false));
+  dwc2_dma_desc_t *desc = mock_desc(0x83);
+  TEST_ASSERT(desc[0].buf == ADDR32(buf));
+  TEST_ASSERT(desc[0].status == (DDMA_BS_HOST_READY | DDMA_L | DDMA_IOC | DDMA_SP | (3u << DDMA_ISO_PID_Pos) |
+                                 (101u << DDMA_ISO_FRNUM_Pos) | sizeof(buf)));
+
+  mock_desc_done(&desc[0], 0, DDMA_STS_SUCCESS);
+  mock_ep_irq(0x83, DIEPINT_XFRC);
+  check_xfer_complete(0x83, sizeof(buf), XFER_RESULT_SUCCESS);
+  printf("iso in: ok\n");
+}
+
+// buffer DMA can't transfer a fifo
+static void test_buffer_dma_fifo(void) {
+  TU_ATTR_ALIGNED(4) static uint8_t ff_buf[512];
+  tu_fifo_t ff;
+  mock_reset(false);
+  mock_open(0x81, TUSB_XFER_BULK, 512);
+
+  fifo_at(&ff, ff_buf, sizeof(ff_buf), 0);
+  TEST_ASSERT(tu_fifo_write_n(&ff, ff_buf, 100) == 100);
+  TEST_ASSERT(!dcd_edpt_xfer_fifo(0, 0x81, &ff, 100, false));
+  TEST_ASSERT(0 == (regs.epin[1].diepctl & DIEPCTL_EPENA));
+  printf("buffer dma fifo rejected: ok\n");
+}
+
+int main(void) {
+  test_setup();
+  test_bulk_in_buffer();
+  test_bulk_in_fifo_chained();
+  test_bulk_in_fifo_linear();
+  test_bulk_out_fifo_short();
+  test_bulk_out_fifo_first_short();
+  test_desc_error();
+  test_iso_in();
+  test_buffer_dma_fifo();
+
+  printf("dwc2 descriptor dma: all tests passed\n");
+  return 0;
+}
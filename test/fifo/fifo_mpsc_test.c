@@ -0,0 +1,157 @@
+/*
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2026 Ha Thach (tinyusb.org)
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ *
+ * This file is part of the TinyUSB stack.
+ */
+
+// Lock-free multiple producers (CFG_TUSB_FIFO_MPSC) stress test: several threads write 4-byte records tagged with
+// writer id and sequence number through tu_fifo_write_n() and zero-copy write_reserve()/commit() while main thread
+// reads them back. Each writer's records must arrive complete and in order. Zero-copy writers reserve more than a
+// record and commit less, the unused space must not reach the reader. Optional argument scales the record count.
+// An overwritable fifo keeps using the locked write and must still be overwritten when full.
+
+#include <pthread.h>
+#include <sched.h>
+#include <string.h>
+
+#include "tusb.h"
+#include "test_common.h"
+
+#define WRITER_COUNT 4
+#define RECORD_SIZE  4
+#define FIFO_DEPTH   (255 * RECORD_SIZE) // multiple of record size so that a record is never split by a full fifo
+
+static uint8_t   ff_buf[FIFO_DEPTH];
+static tu_fifo_t ff;
+static uint32_t  record_count;
+
+static void record_make(uint8_t rec[RECORD_SIZE], uint8_t id, uint32_t seq) {
+  rec[0] = id;
+  rec[1] = (uint8_t) seq;
+  rec[2] = (uint8_t) (seq >> 8);
+  rec[3] = (uint8_t) (id ^ seq ^ (seq >> 8) ^ 0x5a);
+}
+
+static void *writer_thread(void *arg) {
+  const uint8_t id = (uint8_t) (uintptr_t) arg;
+
+  for (uint32_t seq = 0; seq < record_count; seq++) {
+    uint8_t rec[RECORD_SIZE];
+    record_make(rec, id, seq);
+
+    if (seq & 1) {
+      // reserve up to 3 records, fill the reservation with junk then commit only one
+      uint16_t len;
+      uint8_t *p;
+      while (NULL == (p = tu_fifo_write_reserve(&ff, 3 * RECORD_SIZE, &len))) {
+        sched_yield();
+      }
+      memset(p, 0xee, len);
+      if (len < RECORD_SIZE) {
+        tu_fifo_write_commit(&ff, 0);
+        seq--; // retry
+        continue;
+      }
+      memcpy(p, rec, RECORD_SIZE);
+      tu_fifo_write_commit(&ff, RECORD_SIZE);
+    } else {
+      while (tu_fifo_write_n(&ff, rec, RECORD_SIZE) == 0) {
+        sched_yield();
+      }
+    }
+  }
+
+  return NULL;
+}
+
+static void test_overwritable(void) {
+  uint8_t data[FIFO_DEPTH + 8];
+  for (size_t i = 0; i < sizeof(data); i++) {
+    data[i] = (uint8_t) i;
+  }
+
+  tu_fifo_config(&ff, ff_buf, FIFO_DEPTH, true);
+  TEST_ASSERT(!ff.mpsc);
+  TEST_ASSERT(tu_fifo_write_n(&ff, data, 8) == 8);
+  TEST_ASSERT(tu_fifo_write_n(&ff, data + 8, FIFO_DEPTH) == FIFO_DEPTH);
+  TEST_ASSERT(tu_fifo_count(&ff) == FIFO_DEPTH);
+
+  uint8_t out[FIFO_DEPTH];
+  TEST_ASSERT(tu_fifo_read_n(&ff, out, FIFO_DEPTH) == FIFO_DEPTH);
+  TEST_ASSERT(0 == memcmp(out, data + 8, FIFO_DEPTH)); // oldest 8 bytes are overwritten
+
+  // lock-free fifo can not be changed to overwritable
+  tu_fifo_config(&ff, ff_buf, FIFO_DEPTH, false);
+  TEST_ASSERT(ff.mpsc);
+  tu_fifo_set_overwritable(&ff, true);
+  TEST_ASSERT(!ff.overwritable);
+}
+
+int main(int argc, char **argv) {
+  const uint32_t scale = (argc > 1) ? (uint32_t) atoi(argv[1]) : 16;
+  record_count         = scale * 250000u;
+
+  test_overwritable();
+
+  tu_fifo_config(&ff, ff_buf, FIFO_DEPTH, false);
+
+  pthread_t threads[WRITER_COUNT];
+  for (uintptr_t i = 0; i < WRITER_COUNT; i++) {
+    TEST_ASSERT(0 == pthread_create(&threads[i], NULL, writer_thread, (void *) i));
+  }
+
+  uint32_t next_seq[WRITER_COUNT] = {0};
+  uint32_t total                  = 0;
+  uint8_t  buf[64 * RECORD_SIZE];
+  const double t0 = test_time_now();
+
+  while (total < WRITER_COUNT * record_count) {
+    const uint16_t n = tu_fifo_read_n(&ff, buf, sizeof(buf));
+    if (n == 0) {
+      sched_yield();
+      continue;
+    }
+    TEST_ASSERT(n % RECORD_SIZE == 0);
+
+    for (uint16_t i = 0; i < n; i += RECORD_SIZE) {
+      const uint8_t id = buf[i];
+      TEST_ASSERT(id < WRITER_COUNT);
+
+      uint8_t expected[RECORD_SIZE];
+      record_make(expected, id, next_seq[id]);
+      TEST_ASSERT(0 == memcmp(buf + i, expected, RECORD_SIZE));
+      next_seq[id]++;
+      total++;
+    }
+  }
+  const double dt = test_time_now() - t0;
+
+  for (size_t i = 0; i < WRITER_COUNT; i++) {
+    pthread_join(threads[i], NULL);
+  }
+  TEST_ASSERT(tu_fifo_empty(&ff));
+
+  printf("%u writers: %u records ok\n", WRITER_COUNT, total);
+  test_report_rate("mpsc fifo", (double) total * RECORD_SIZE, dt);
+  return 0;
+}
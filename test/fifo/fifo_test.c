@@ -0,0 +1,154 @@
+/*
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2026 Ha Thach (tinyusb.org)
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ *
+ * This file is part of the TinyUSB stack.
+ */
+
+// tu_fifo copy paths: randomized round trips across wrap-around and buffer alignment, followed by a throughput
+// benchmark of tu_fifo_write_n()/tu_fifo_read_n() and the hwfifo API. Built with and without CFG_TUSB_FIFO_WORD_COPY
+// to compare the word copy path against memcpy(). Optional argument scales the benchmark length.
+
+#include <string.h>
+
+#include "tusb.h"
+#include "test_common.h"
+
+#define FIFO_DEPTH 4096
+
+static uint8_t  ff_buf[FIFO_DEPTH];
+static uint32_t hw_buf[FIFO_DEPTH / 4]; // emulated hwfifo, address stride 4
+static uint8_t  src[FIFO_DEPTH + 4];
+static uint8_t  dst[FIFO_DEPTH + 4];
+
+//--------------------------------------------------------------------+
+// Round trip
+//--------------------------------------------------------------------+
+// Write n bytes at a random fifo position through either buffer or hwfifo API, read them back through either one
+static void test_roundtrip(uint32_t iterations) {
+  tu_fifo_t ff;
+  srand(1);
+
+  for (uint32_t it = 0; it < iterations; it++) {
+    const uint16_t depth = (uint16_t) (64 + rand() % 960);
+    tu_fifo_config(&ff, ff_buf, depth, false);
+
+    // move read/write index to a random position to exercise wrap-around
+    const uint16_t pre = (uint16_t) (rand() % depth);
+    tu_fifo_write_n(&ff, dst, pre);
+    tu_fifo_read_n(&ff, dst, pre);
+
+    const uint16_t n       = (uint16_t) (rand() % (depth + 1));
+    const uint16_t src_ofs = (uint16_t) (rand() % 4);
+    const uint16_t dst_ofs = (uint16_t) (rand() % 4);
+    for (uint16_t i = 0; i < n; i++) {
+      src[src_ofs + i] = (uint8_t) rand();
+    }
+
+    if (rand() & 1) {
+      TEST_ASSERT(tu_fifo_write_n(&ff, src + src_ofs, n) == n);
+    } else {
+      memcpy(hw_buf, src + src_ofs, n);
+      TEST_ASSERT(tu_hwfifo_read_to_fifo(hw_buf, &ff, n, NULL) == n);
+    }
+
+    memset(dst, 0, sizeof(dst));
+    if (rand() & 1) {
+      TEST_ASSERT(tu_fifo_read_n(&ff, dst + dst_ofs, n) == n);
+    } else {
+      memset(hw_buf, 0, sizeof(hw_buf));
+      TEST_ASSERT(tu_hwfifo_write_from_fifo(hw_buf, &ff, n, NULL) == n);
+      memcpy(dst + dst_ofs, hw_buf, n);
+    }
+    TEST_ASSERT(memcmp(src + src_ofs, dst + dst_ofs, n) == 0);
+  }
+
+  // hwfifo <-> linear buffer
+  for (uint32_t it = 0; it < iterations; it++) {
+    const uint16_t n   = (uint16_t) (rand() % 1024);
+    const uint16_t ofs = (uint16_t) (rand() % 4);
+    for (uint16_t i = 0; i < n; i++) {
+      src[ofs + i] = (uint8_t) rand();
+    }
+    memset(hw_buf, 0, sizeof(hw_buf));
+    tu_hwfifo_write(hw_buf, src + ofs, n, NULL);
+    TEST_ASSERT(memcmp(hw_buf, src + ofs, n) == 0);
+
+    memset(dst, 0, sizeof(dst));
+    tu_hwfifo_read(hw_buf, dst + ofs, n, NULL);
+    TEST_ASSERT(memcmp(dst + ofs, src + ofs, n) == 0);
+  }
+  printf("round trip: %u iterations ok\n", iterations);
+}
+
+//--------------------------------------------------------------------+
+// Benchmark
+//--------------------------------------------------------------------+
+static void bench_fifo(uint32_t scale, uint16_t chunk, uint8_t ofs) {
+  tu_fifo_t ff;
+  tu_fifo_config(&ff, ff_buf, FIFO_DEPTH, false);
+  const uint32_t rounds = scale * (1024u * 1024 / chunk);
+
+  const double t0 = test_time_now();
+  for (uint32_t r = 0; r < rounds; r++) {
+    tu_fifo_write_n(&ff, src + ofs, chunk);
+    tu_fifo_read_n(&ff, dst + ofs, chunk);
+  }
+  const double dt = test_time_now() - t0;
+
+  char name[48];
+  snprintf(name, sizeof(name), "fifo %4u B %s", chunk, ofs ? "unaligned" : "aligned");
+  test_report_rate(name, (double) rounds * chunk, dt);
+}
+
+static void bench_hwfifo(uint32_t scale, uint16_t chunk, uint8_t ofs) {
+  const uint32_t rounds = scale * (1024u * 1024 / chunk);
+
+  const double t0 = test_time_now();
+  for (uint32_t r = 0; r < rounds; r++) {
+    tu_hwfifo_write(hw_buf, src + ofs, chunk, NULL);
+    tu_hwfifo_read(hw_buf, dst + ofs, chunk, NULL);
+  }
+  const double dt = test_time_now() - t0;
+
+  char name[48];
+  snprintf(name, sizeof(name), "hwfifo %4u B %s", chunk, ofs ? "unaligned" : "aligned");
+  test_report_rate(name, (double) rounds * chunk, dt);
+}
+
+int main(int argc, char **argv) {
+  const uint32_t scale = (argc > 1) ? (uint32_t) atoi(argv[1]) : 16;
+
+  test_roundtrip(100000);
+
+  printf("CFG_TUSB_FIFO_WORD_COPY = %u\n", CFG_TUSB_FIFO_WORD_COPY);
+  const uint16_t chunks[] = {64, 512, 4096};
+  for (size_t i = 0; i < TU_ARRAY_SIZE(chunks); i++) {
+    bench_fifo(scale, chunks[i], 0);
+    bench_fifo(scale, chunks[i], 1);
+  }
+  for (size_t i = 0; i < TU_ARRAY_SIZE(chunks); i++) {
+    bench_hwfifo(scale, chunks[i], 0);
+    bench_hwfifo(scale, chunks[i], 1);
+  }
+  return 0;
+}
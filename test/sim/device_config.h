@@ -0,0 +1,70 @@
+/*
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2026 Ha Thach (tinyusb.org)
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ *
+ * This file is part of the TinyUSB stack.
+ */
+
+#ifndef TUSB_TEST_DEVICE_CONFIG_H
+#define TUSB_TEST_DEVICE_CONFIG_H
+
+// Simulated device controller (portable/sim/dcd_sim.c)
+#define CFG_TUSB_MCU    OPT_MCU_NONE
+#define CFG_TUSB_OS     OPT_OS_NONE
+#define CFG_TUSB_DEBUG  0
+#define CFG_TUD_SIM     1
+
+#define CFG_TUD_ENABLED 1
+#define CFG_TUH_ENABLED 0
+
+#define CFG_TUD_ENDPOINT0_SIZE 64
+#define CFG_TUD_TASK_QUEUE_SZ  64
+#define CFG_TUD_TASK_STATS     1
+#define CFG_TUSB_TRACE_DEPTH   64
+
+#define CFG_TUD_CDC    1
+#define CFG_TUD_MSC    1
+#define CFG_TUD_VENDOR 1
+
+#ifndef CFG_TUD_CDC_RX_BUFSIZE
+  #define CFG_TUD_CDC_RX_BUFSIZE 1024
+#endif
+#ifndef CFG_TUD_CDC_TX_BUFSIZE
+  #define CFG_TUD_CDC_TX_BUFSIZE 1024
+#endif
+#define CFG_TUD_CDC_EP_BUFSIZE 512
+#ifndef CFG_TUD_CDC_RX_STAGED
+  #define CFG_TUD_CDC_RX_STAGED 1
+#endif
+#ifndef CFG_TUD_CDC_WRITE_BUFFER
+  #define CFG_TUD_CDC_WRITE_BUFFER 1
+#endif
+
+#define CFG_TUD_MSC_EP_BUFSIZE 4096
+
+#define CFG_TUD_VENDOR_RX_BUFSIZE 1024
+#define CFG_TUD_VENDOR_TX_BUFSIZE 1024
+#define CFG_TUD_VENDOR_EPSIZE     512
+#define CFG_TUD_VENDOR_RX_STAGED  1
+#define CFG_TUD_VENDOR_WRITE_BUFFER 1
+
+#endif
@@ -0,0 +1,601 @@
+/*
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2026 Ha Thach (tinyusb.org)
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ *
+ * This file is part of the TinyUSB stack.
+ */
+
+// Device stack running on the simulated device controller: the test plays the USB host, enumerates a CDC + MSC +
+// vendor device and checks data integrity and throughput of each class. Optional argument is the iteration count.
+
+#include <string.h>
+
+#include "tusb.h"
+#include "portable/sim/dcd_sim.h"
+#include "test_common.h"
+
+#define EPNUM_CDC_NOTIF   0x81
+#define EPNUM_CDC_OUT     0x02
+#define EPNUM_CDC_IN      0x82
+#define EPNUM_MSC_OUT     0x03
+#define EPNUM_MSC_IN      0x83
+#define EPNUM_VENDOR_OUT  0x04
+#define EPNUM_VENDOR_IN   0x84
+
+#define DISK_BLOCK_SIZE   512
+#define DISK_BLOCK_COUNT  1024
+
+//--------------------------------------------------------------------+
+// Descriptors
+//--------------------------------------------------------------------+
+static const tusb_desc_device_t desc_device = {
+  .bLength            = sizeof(tusb_desc_device_t),
+  .bDescriptorType    = TUSB_DESC_DEVICE,
+  .bcdUSB             = 0x0200,
+  .bDeviceClass       = TUSB_CLASS_MISC,
+  .bDeviceSubClass    = MISC_SUBCLASS_COMMON,
+  .bDeviceProtocol    = MISC_PROTOCOL_IAD,
+  .bMaxPacketSize0    = CFG_TUD_ENDPOINT0_SIZE,
+  .idVendor           = 0xCafe,
+  .idProduct          = 0x4001,
+  .bcdDevice          = 0x0100,
+  .iManufacturer      = 0,
+  .iProduct           = 0,
+  .iSerialNumber      = 0,
+  .bNumConfigurations = 1
+};
+
+#define CONFIG_TOTAL_LEN (TUD_CONFIG_DESC_LEN + TUD_CDC_DESC_LEN + TUD_MSC_DESC_LEN + TUD_VENDOR_DESC_LEN)
+
+static const uint8_t desc_configuration[] = {
+  TUD_CONFIG_DESCRIPTOR(1, 4, 0, CONFIG_TOTAL_LEN, 0x00, 100),
+  TUD_CDC_DESCRIPTOR(0, 0, EPNUM_CDC_NOTIF, 8, EPNUM_CDC_OUT, EPNUM_CDC_IN, 512),
+  TUD_MSC_DESCRIPTOR(2, 0, EPNUM_MSC_OUT, EPNUM_MSC_IN, 512),
+  TUD_VENDOR_DESCRIPTOR(3, 0, EPNUM_VENDOR_OUT, EPNUM_VENDOR_IN, 512),
+};
+
+const uint8_t *tud_descriptor_device_cb(void) {
+  return (const uint8_t *) &desc_device;
+}
+
+const uint8_t *tud_descriptor_configuration_cb(uint8_t index) {
+  (void) index;
+  return desc_configuration;
+}
+
+const uint16_t *tud_descriptor_string_cb(uint8_t index, uint16_t langid) {
+  (void) index;
+  (void) langid;
+  return NULL;
+}
+
+//--------------------------------------------------------------------+
+// MSC RAM disk
+//--------------------------------------------------------------------+
+static uint8_t disk[DISK_BLOCK_COUNT * DISK_BLOCK_SIZE];
+static uint32_t disk_bad_lba = UINT32_MAX; // write10 to this block fails
+
+int32_t tud_msc_read10_cb(uint8_t lun, uint32_t lba, uint32_t offset, void *buffer, uint32_t bufsize) {
+  memcpy(buffer, disk + lba * DISK_BLOCK_SIZE + offset, bufsize);
+  return (int32_t) bufsize;
+}
+
+int32_t tud_msc_write10_cb(uint8_t lun, uint32_t lba, uint32_t offset, uint8_t *buffer, uint32_t bufsize) {
+  if (disk_bad_lba >= lba && disk_bad_lba < lba + (offset + bufsize + DISK_BLOCK_SIZE - 1) / DISK_BLOCK_SIZE) {
+    return TUD_MSC_RET_ERROR;
+  }
+  memcpy(disk + lba * DISK_BLOCK_SIZE + offset, buffer, bufsize);
+  return (int32_t) bufsize;
+}
+
+void tud_msc_inquiry_cb(uint8_t lun, uint8_t vendor_id[8], uint8_t product_id[16], uint8_t product_rev[4]) {
+  memcpy(vendor_id, "TinyUSB ", 8);
+  memcpy(product_id, "Sim RAM Disk    ", 16);
+  memcpy(product_rev, "1.0 ", 4);
+}
+
+bool tud_msc_test_unit_ready_cb(uint8_t lun) {
+  return true;
+}
+
+void tud_msc_capacity_cb(uint8_t lun, uint32_t *block_count, uint16_t *block_size) {
+  *block_count = DISK_BLOCK_COUNT;
+  *block_size  = DISK_BLOCK_SIZE;
+}
+
+int32_t tud_msc_scsi_cb(uint8_t lun, const uint8_t scsi_cmd[16], void *buffer, uint16_t bufsize) {
+  return -1;
+}
+
+//--------------------------------------------------------------------+
+// Virtual host
+//--------------------------------------------------------------------+
+static uint8_t host_buf[65536];
+
+uint32_t tusb_time_millis_api(void) {
+  return (uint32_t) (test_time_now() * 1000);
+}
+
+static void run_task(void) {
+  while (tud_task_event_ready()) {
+    tud_task();
+  }
+}
+
+// Control transfer with data stage of at most one packet each direction
+static void control_xfer(const tusb_control_request_t *request, void *data) {
+  uint16_t xferred;
+  tud_sim_setup_send(0, request);
+  run_task();
+
+  if (request->wLength == 0) {
+    TEST_ASSERT(tud_sim_host_in(0, 0x80, host_buf, 0, &xferred));
+  } else if (request->bmRequestType_bit.direction == TUSB_DIR_IN) {
+    uint16_t total = 0;
+    while (total < request->wLength) {
+      TEST_ASSERT(tud_sim_host_in(0, 0x80, host_buf + total, CFG_TUD_ENDPOINT0_SIZE, &xferred));
+      total += xferred;
+      run_task();
+      if (xferred < CFG_TUD_ENDPOINT0_SIZE) {
+        break;
+      }
+    }
+    if (data) {
+      memcpy(data, host_buf, total);
+    }
+    TEST_ASSERT(tud_sim_host_out(0, 0x00, NULL, 0, &xferred));
+  } else {
+    TEST_ASSERT(tud_sim_host_out(0, 0x00, data, request->wLength, &xferred));
+    run_task();
+    TEST_ASSERT(tud_sim_host_in(0, 0x80, host_buf, 0, &xferred));
+  }
+  run_task();
+}
+
+// Read everything the device has queued on an IN endpoint
+static uint32_t host_in_all(uint8_t ep_addr, uint8_t *buffer, uint32_t bufsize) {
+  uint32_t total = 0;
+  uint16_t xferred;
+  while (total < bufsize &&
+         tud_sim_host_in(0, ep_addr, buffer + total, (uint16_t) tu_min32(bufsize - total, 65024), &xferred)) {
+    total += xferred;
+    run_task();
+  }
+  return total;
+}
+
+static inline uint8_t pattern(uint32_t i) {
+  return (uint8_t) (i * 7 + (i >> 8));
+}
+
+//--------------------------------------------------------------------+
+// Tests
+//--------------------------------------------------------------------+
+static void test_enumeration(void) {
+  tusb_desc_device_t desc;
+  const tusb_control_request_t get_desc = {
+    .bmRequestType = 0x80, .bRequest = TUSB_REQ_GET_DESCRIPTOR, .wValue = TUSB_DESC_DEVICE << 8,
+    .wIndex = 0, .wLength = sizeof(desc)
+  };
+  const tusb_control_request_t set_addr = {.bmRequestType = 0x00, .bRequest = TUSB_REQ_SET_ADDRESS, .wValue = 5};
+  const tusb_control_request_t set_config = {
+    .bmRequestType = 0x00, .bRequest = TUSB_REQ_SET_CONFIGURATION, .wValue = 1
+  };
+  const tusb_control_request_t set_dtr = {
+    .bmRequestType = 0x21, .bRequest = CDC_REQUEST_SET_CONTROL_LINE_STATE, .wValue = CDC_CONTROL_LINE_STATE_DTR
+  };
+
+  tud_sim_bus_reset(0, TUSB_SPEED_HIGH);
+  run_task();
+  control_xfer(&get_desc, &desc);
+  TEST_ASSERT(desc.idVendor == desc_device.idVendor && desc.idProduct == desc_device.idProduct);
+  control_xfer(&set_addr, NULL);
+  TEST_ASSERT(tud_sim_address(0) == 5);
+  control_xfer(&set_config, NULL);
+  TEST_ASSERT(tud_mounted());
+  control_xfer(&set_dtr, NULL);
+  TEST_ASSERT(tud_cdc_connected());
+  printf("enumeration ok\n");
+}
+
+// Device writes a byte sequence in odd sized chunks, host reads and verifies it
+static void test_cdc_tx(uint32_t iterations) {
+  uint8_t  chunk[300];
+  uint32_t written = 0, received = 0;
+  const uint32_t total = iterations * 256;
+  const double t0 = test_time_now();
+
+  while (received < total) {
+    const uint32_t n = tu_min32(tu_min32(tud_cdc_write_available(), sizeof(chunk)), total - written);
+    for (uint32_t i = 0; i < n; i++) {
+      chunk[i] = pattern(written + i);
+    }
+    written += tud_cdc_write(chunk, n);
+    tud_cdc_write_flush();
+    run_task();
+
+    const uint32_t count = host_in_all(EPNUM_CDC_IN, host_buf, sizeof(host_buf));
+    for (uint32_t i = 0; i < count; i++) {
+      TEST_ASSERT(host_buf[i] == pattern(received + i));
+    }
+    received += count;
+  }
+  test_report_rate("cdc tx", received, test_time_now() - t0);
+}
+
+#if CFG_TUD_CDC_TX_DIRECT
+// FIFO data sent in place must not be overwritten or cleared while the transfer is in progress, even if DTR drops
+static void test_cdc_tx_direct_dtr(void) {
+  const tusb_control_request_t line_state = {
+    .bmRequestType = 0x21, .bRequest = CDC_REQUEST_SET_CONTROL_LINE_STATE, .wValue = 0
+  };
+  tusb_control_request_t set_dtr = line_state;
+  set_dtr.wValue = CDC_CONTROL_LINE_STATE_DTR;
+  uint8_t chunk[CFG_TUD_CDC_TX_BUFSIZE];
+
+  // start from an empty aligned FIFO and fill it: sent in place with a single transfer
+  TEST_ASSERT(tud_cdc_write_clear());
+  for (uint32_t i = 0; i < sizeof(chunk); i++) {
+    chunk[i] = pattern(i);
+  }
+  TEST_ASSERT(tud_cdc_write(chunk, sizeof(chunk)) == sizeof(chunk));
+  tud_cdc_write_flush();
+  run_task();
+  TEST_ASSERT(!tud_cdc_write_clear());
+
+  // DTR drops: FIFO is not overwritable until the transfer completes
+  control_xfer(&line_state, NULL);
+  TEST_ASSERT(!tud_cdc_connected());
+  memset(chunk, 0xee, sizeof(chunk));
+  TEST_ASSERT(tud_cdc_write(chunk, sizeof(chunk)) == 0);
+
+  TEST_ASSERT(host_in_all(EPNUM_CDC_IN, host_buf, sizeof(host_buf)) == sizeof(chunk));
+  for (uint32_t i = 0; i < sizeof(chunk); i++) {
+    TEST_ASSERT(host_buf[i] == pattern(i));
+  }
+  TEST_ASSERT(tud_cdc_write_clear());
+
+  control_xfer(&set_dtr, NULL);
+  TEST_ASSERT(tud_cdc_connected());
+}
+#endif
+
+// Host writes a byte sequence, device reads and verifies it
+static void test_cdc_rx(uint32_t iterations) {
+  uint8_t  packet[512];
+  uint8_t  rx_buf[2048];
+  uint32_t sent = 0, received = 0;
+  const uint32_t total = iterations * 512;
+  const double t0 = test_time_now();
+
+  while (received < total) {
+    if (sent < total) {
+      uint16_t xferred;
+      for (uint32_t i = 0; i < sizeof(packet); i++) {
+        packet[i] = pattern(sent + i);
+      }
+      if (tud_sim_host_out(0, EPNUM_CDC_OUT, packet, sizeof(packet), &xferred)) {
+        sent += xferred;
+      }
+    }
+    run_task();
+
+    const uint32_t count = tud_cdc_read(rx_buf, sizeof(rx_buf));
+    for (uint32_t i = 0; i < count; i++) {
+      TEST_ASSERT(rx_buf[i] == pattern(received + i));
+    }
+    received += count;
+    run_task();
+  }
+  test_report_rate("cdc rx", received, test_time_now() - t0);
+}
+
+#if CFG_TUD_CDC_RX_STAGED
+// Device does not read: endpoint keeps receiving into its buffer once FIFO is full, these staged bytes are read after
+// FIFO ones
+static void test_cdc_rx_staged(void) {
+  uint8_t  packet[CFG_TUD_CDC_EP_BUFSIZE];
+  uint8_t  rx_buf[CFG_TUD_CDC_RX_BUFSIZE + CFG_TUD_CDC_EP_BUFSIZE];
+  uint32_t sent = 0;
+  uint16_t xferred;
+
+  do {
+    for (uint32_t i = 0; i < sizeof(packet); i++) {
+      packet[i] = pattern(sent + i);
+    }
+    if (!tud_sim_host_out(0, EPNUM_CDC_OUT, packet, sizeof(packet), &xferred)) {
+      break;
+    }
+    sent += xferred;
+    run_task();
+  } while (1);
+  TEST_ASSERT(sent == sizeof(rx_buf));
+  TEST_ASSERT(tud_cdc_available() == sizeof(rx_buf));
+
+  uint8_t ch;
+  TEST_ASSERT(tud_cdc_peek(&ch) && ch == pattern(0));
+  TEST_ASSERT(tud_cdc_read(rx_buf, sizeof(rx_buf)) == sizeof(rx_buf));
+  for (uint32_t i = 0; i < sizeof(rx_buf); i++) {
+    TEST_ASSERT(rx_buf[i] == pattern(i));
+  }
+  run_task();
+}
+#endif
+
+static void msc_send_cbw(uint32_t tag, uint8_t opcode, uint32_t lba, uint16_t block_count) {
+  msc_cbw_t cbw = {
+    .signature   = MSC_CBW_SIGNATURE,
+    .tag         = tag,
+    .total_bytes = (uint32_t) block_count * DISK_BLOCK_SIZE,
+    .dir         = (opcode == SCSI_CMD_READ_10) ? TUSB_DIR_IN_MASK : 0,
+    .lun         = 0,
+    .cmd_len     = sizeof(scsi_read10_t),
+  };
+  scsi_read10_t cmd = {
+    .cmd_code    = opcode,
+    .lba         = tu_htonl(lba),
+    .block_count = tu_htons(block_count),
+  };
+  memcpy(cbw.command, &cmd, sizeof(cmd));
+
+  uint16_t xferred;
+  TEST_ASSERT(tud_sim_host_out(0, EPNUM_MSC_OUT, &cbw, sizeof(cbw), &xferred));
+  run_task();
+}
+
+static void msc_check_csw_status(uint32_t tag, uint8_t status, uint32_t residue) {
+  msc_csw_t csw;
+  uint16_t  xferred;
+  for (int retry = 0; !tud_sim_host_in(0, EPNUM_MSC_IN, &csw, sizeof(csw), &xferred); retry++) {
+    TEST_ASSERT(retry < 100);
+    run_task();
+  }
+  run_task();
+  TEST_ASSERT(xferred == sizeof(csw) && csw.signature == MSC_CSW_SIGNATURE && csw.tag == tag);
+  TEST_ASSERT(csw.status == status && csw.data_residue == residue);
+}
+
+static void msc_check_csw(uint32_t tag) {
+  msc_check_csw_status(tag, MSC_CSW_STATUS_PASSED, 0);
+}
+
+// WRITE10 a pattern to the whole disk in 32KB commands, then READ10 it back
+static void test_msc(uint32_t iterations) {
+  const uint16_t block_count = 64;
+  const uint32_t len = block_count * DISK_BLOCK_SIZE;
+  const uint32_t cmd_count = tu_max32(iterations / 20, DISK_BLOCK_COUNT / block_count);
+  uint32_t tag = 1;
+
+  double t0 = test_time_now();
+  for (uint32_t c = 0; c < cmd_count; c++) {
+    const uint32_t lba = (c * block_count) % DISK_BLOCK_COUNT;
+    msc_send_cbw(tag, SCSI_CMD_WRITE_10, lba, block_count);
+    for (uint32_t i = 0; i < len; i++) {
+      host_buf[i] = pattern(lba * DISK_BLOCK_SIZE + i);
+    }
+    uint32_t sent = 0;
+    while (sent < len) {
+      uint16_t xferred;
+      if (tud_sim_host_out(0, EPNUM_MSC_OUT, host_buf + sent, 512, &xferred)) {
+        sent += xferred;
+      }
+      run_task();
+    }
+    msc_check_csw(tag++);
+  }
+  test_report_rate("msc write10", (double) cmd_count * len, test_time_now() - t0);
+
+  for (uint32_t i = 0; i < sizeof(disk); i++) {
+    TEST_ASSERT(disk[i] == pattern(i));
+  }
+
+  t0 = test_time_now();
+  for (uint32_t c = 0; c < cmd_count; c++) {
+    const uint32_t lba = (c * block_count) % DISK_BLOCK_COUNT;
+    msc_send_cbw(tag, SCSI_CMD_READ_10, lba, block_count);
+    uint32_t received = 0;
+    while (received < len) {
+      uint16_t xferred;
+      if (tud_sim_host_in(0, EPNUM_MSC_IN, host_buf + received, (uint16_t) (len - received), &xferred)) {
+        received += xferred;
+      }
+      run_task();
+    }
+    for (uint32_t i = 0; i < len; i++) {
+      TEST_ASSERT(host_buf[i] == pattern(lba * DISK_BLOCK_SIZE + i));
+    }
+    msc_check_csw(tag++);
+  }
+  test_report_rate("msc read10", (double) cmd_count * len, test_time_now() - t0);
+}
+
+// WRITE10 failing in the middle: OUT endpoint is stalled only after the in-flight transfer, then the host clears
+// the halt and the next command succeeds
+static void test_msc_write_error(void) {
+  const uint16_t block_count = 64;
+  const uint32_t len = block_count * DISK_BLOCK_SIZE;
+  const uint32_t good_len = CFG_TUD_MSC_EP_BUFSIZE; // first buffer is committed before the bad block
+  const tusb_control_request_t clear_halt = {
+    .bmRequestType = 0x02, .bRequest = TUSB_REQ_CLEAR_FEATURE, .wValue = TUSB_REQ_FEATURE_EDPT_HALT,
+    .wIndex = EPNUM_MSC_OUT
+  };
+  uint32_t tag = 0x1000;
+
+  disk_bad_lba = good_len / DISK_BLOCK_SIZE;
+  msc_send_cbw(tag, SCSI_CMD_WRITE_10, 0, block_count);
+  uint32_t sent = 0;
+  while (!tud_sim_edpt_stalled(0, EPNUM_MSC_OUT)) {
+    uint16_t xferred;
+    if (tud_sim_host_out(0, EPNUM_MSC_OUT, host_buf + sent, 512, &xferred)) {
+      sent += xferred;
+    }
+    TEST_ASSERT(sent < len);
+    run_task();
+  }
+  // bad buffer and every transfer already queued behind it are received before stalling
+  TEST_ASSERT(sent == good_len + CFG_TUD_MSC_EP_BUFCOUNT * CFG_TUD_MSC_EP_BUFSIZE);
+  msc_check_csw_status(tag++, MSC_CSW_STATUS_FAILED, len - good_len);
+  disk_bad_lba = UINT32_MAX;
+
+  control_xfer(&clear_halt, NULL);
+  TEST_ASSERT(!tud_sim_edpt_stalled(0, EPNUM_MSC_OUT));
+
+  msc_send_cbw(tag, SCSI_CMD_WRITE_10, 0, block_count);
+  for (sent = 0; sent < len;) {
+    uint16_t xferred;
+    if (tud_sim_host_out(0, EPNUM_MSC_OUT, host_buf + sent, 512, &xferred)) {
+      sent += xferred;
+    }
+    run_task();
+  }
+  msc_check_csw(tag);
+}
+
+#if CFG_TUD_CDC_WRITE_BUFFER
+// Buffer sent without FIFO: sent count is final once no longer busy, bus reset aborts it. Must be the last test
+static void test_cdc_write_buffer(void) {
+  static TU_ATTR_ALIGNED(4) uint8_t buf[4096];
+  for (uint32_t i = 0; i < sizeof(buf); i++) {
+    buf[i] = pattern(i);
+  }
+
+  TEST_ASSERT(tud_cdc_write_buffer(buf, sizeof(buf)));
+  run_task();
+  TEST_ASSERT(host_in_all(EPNUM_CDC_IN, host_buf, sizeof(host_buf)) == sizeof(buf));
+  TEST_ASSERT(memcmp(host_buf, buf, sizeof(buf)) == 0);
+  TEST_ASSERT(!tud_cdc_write_buffer_busy() && tud_cdc_write_buffer_sent() == sizeof(buf));
+
+  // host stops reading in the middle of the transfer
+  uint16_t xferred;
+  TEST_ASSERT(tud_cdc_write_buffer(buf, sizeof(buf)));
+  run_task();
+  TEST_ASSERT(tud_sim_host_in(0, EPNUM_CDC_IN, host_buf, 512, &xferred) && xferred == 512);
+  TEST_ASSERT(tud_cdc_write_buffer_busy());
+  tud_sim_bus_reset(0, TUSB_SPEED_HIGH);
+  run_task();
+  TEST_ASSERT(!tud_cdc_write_buffer_busy() && tud_cdc_write_buffer_sent() == 0);
+}
+#endif
+
+// Vendor loopback: host data is echoed back by the device
+static void test_vendor(uint32_t iterations) {
+  uint8_t  packet[512];
+  uint8_t  echo[1024];
+  uint32_t sent = 0, received = 0;
+  const uint32_t total = iterations * 512;
+  const double t0 = test_time_now();
+
+  while (received < total) {
+    if (sent < total) {
+      uint16_t xferred;
+      for (uint32_t i = 0; i < sizeof(packet); i++) {
+        packet[i] = pattern(sent + i);
+      }
+      if (tud_sim_host_out(0, EPNUM_VENDOR_OUT, packet, sizeof(packet), &xferred)) {
+        sent += xferred;
+      }
+    }
+    run_task();
+
+    const uint32_t n = tud_vendor_read(echo, tu_min32(sizeof(echo), tud_vendor_write_available()));
+    TEST_ASSERT(tud_vendor_write(echo, n) == n);
+    tud_vendor_write_flush();
+    run_task();
+
+    const uint32_t count = host_in_all(EPNUM_VENDOR_IN, host_buf, sizeof(host_buf));
+    for (uint32_t i = 0; i < count; i++) {
+      TEST_ASSERT(host_buf[i] == pattern(received + i));
+    }
+    received += count;
+  }
+  test_report_rate("vendor loopback", received, test_time_now() - t0);
+}
+
+#if CFG_TUD_TASK_MERGE_SOF
+static uint32_t sof_cb_count;
+static uint32_t sof_cb_frame;
+
+void tud_sof_cb(uint32_t frame_count) {
+  sof_cb_count++;
+  sof_cb_frame = frame_count;
+}
+
+// Consecutive SOF events are dispatched once with the latest frame count
+static void test_sof_merge(void) {
+  tud_task_stats_t before;
+  tud_task_stats_t after;
+
+  run_task();
+  tud_sof_cb_enable(true);
+  tud_task_stats_get(&before);
+  for (uint32_t frame = 1; frame <= 8; frame++) {
+    tud_sim_sof(0, frame);
+  }
+  run_task();
+  tud_task_stats_get(&after);
+  tud_sof_cb_enable(false);
+
+  TEST_ASSERT(sof_cb_count == 1 && sof_cb_frame == 8);
+  TEST_ASSERT(after.event_count - before.event_count == 8 && after.dispatch_count - before.dispatch_count == 1);
+}
+#endif
+
+int main(int argc, char **argv) {
+  const uint32_t iterations = (argc > 1) ? (uint32_t) atoi(argv[1]) : 2000;
+
+  const tusb_rhport_init_t dev_init = {.role = TUSB_ROLE_DEVICE, .speed = TUSB_SPEED_HIGH};
+  TEST_ASSERT(tusb_init(0, &dev_init));
+
+  test_enumeration();
+  test_cdc_tx(iterations);
+  #if CFG_TUD_CDC_TX_DIRECT
+  test_cdc_tx_direct_dtr();
+  #endif
+  test_cdc_rx(iterations);
+  #if CFG_TUD_CDC_RX_STAGED
+  test_cdc_rx_staged();
+  #endif
+  test_msc(iterations);
+  test_msc_write_error();
+  test_vendor(iterations);
+  #if CFG_TUD_TASK_MERGE_SOF
+  test_sof_merge();
+  #endif
+  #if CFG_TUD_CDC_WRITE_BUFFER
+  test_cdc_write_buffer();
+  #endif
+
+  // pending events can never exceed queue size
+  tud_task_stats_t stats;
+  tud_task_stats_get(&stats);
+  TEST_ASSERT(stats.event_count > 0 && stats.queue_hwm <= stats.queue_size);
+
+  // trace buffer is full of whole entries, clear empties it
+  tu_trace_entry_t entries[4];
+  TEST_ASSERT(tu_trace_count() == CFG_TUSB_TRACE_DEPTH);
+  TEST_ASSERT(tu_trace_read(entries, 4) == 4);
+  tu_trace_clear();
+  TEST_ASSERT(tu_trace_count() == 0);
+
+  printf("device sim: all tests passed\n");
+  return 0;
+}
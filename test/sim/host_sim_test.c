@@ -0,0 +1,302 @@
+/*
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2026 Ha Thach (tinyusb.org)
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ *
+ * This file is part of the TinyUSB stack.
+ */
+
+// Host stack running on the simulated host controller: a virtual hub with MSC, CDC-ACM, FTDI, HID and MIDI devices
+// is enumerated, then MSC and serial data are verified and devices are plugged/unplugged repeatedly.
+// Optional argument is the number of plug cycles.
+
+#include <string.h>
+
+#include "tusb.h"
+#include "portable/sim/hcd_sim.h"
+#include "test_common.h"
+
+#define DEVICE_COUNT     5
+#define DISK_BLOCK_SIZE  512
+#define DISK_BLOCK_COUNT 2048
+
+enum {
+  HUB_PORT_MSC = 1,
+  HUB_PORT_CDC,
+  HUB_PORT_FTDI,
+  HUB_PORT_HID,
+  HUB_PORT_MIDI,
+};
+
+static tuh_sim_device_t hub_dev, msc_dev, cdc_dev, ftdi_dev, hid_dev, midi_dev;
+static tuh_sim_hub_t    hub;
+static tuh_sim_msc_t    msc;
+static tuh_sim_serial_t cdc_serial, ftdi_serial, midi_serial;
+static tuh_sim_hid_t    hid;
+
+static uint8_t disk[DISK_BLOCK_COUNT * DISK_BLOCK_SIZE];
+
+static int mounted_count, cdc_mounted, hid_mounted;
+static uint8_t msc_daddr;
+static volatile bool msc_done;
+static uint32_t hid_reports;
+
+//--------------------------------------------------------------------+
+// Callbacks
+//--------------------------------------------------------------------+
+// enumeration delays elapse in virtual time
+uint32_t tusb_time_millis_api(void) {
+  return hcd_frame_number(0);
+}
+
+void tuh_mount_cb(uint8_t daddr) {
+  mounted_count++;
+}
+
+void tuh_umount_cb(uint8_t daddr) {
+  mounted_count--;
+}
+
+void tuh_msc_mount_cb(uint8_t daddr) {
+  msc_daddr = daddr;
+}
+
+void tuh_msc_umount_cb(uint8_t daddr) {
+  msc_daddr = 0;
+}
+
+void tuh_cdc_mount_cb(uint8_t idx) {
+  cdc_mounted++;
+}
+
+void tuh_cdc_umount_cb(uint8_t idx) {
+  cdc_mounted--;
+}
+
+void tuh_hid_mount_cb(uint8_t daddr, uint8_t idx, const uint8_t *desc_report, uint16_t desc_len) {
+  hid_mounted++;
+  tuh_hid_receive_report(daddr, idx);
+}
+
+void tuh_hid_umount_cb(uint8_t daddr, uint8_t idx) {
+  hid_mounted--;
+}
+
+void tuh_hid_report_received_cb(uint8_t daddr, uint8_t idx, const uint8_t *report, uint16_t len) {
+  hid_reports++;
+  tuh_hid_receive_report(daddr, idx);
+}
+
+void tuh_midi_mount_cb(uint8_t idx, const tuh_midi_mount_cb_t *mount_cb_data) {
+}
+
+void tuh_midi_umount_cb(uint8_t idx) {
+}
+
+static bool msc_complete_cb(uint8_t daddr, const tuh_msc_complete_data_t *cb_data) {
+  TEST_ASSERT(cb_data->csw->status == MSC_CSW_STATUS_PASSED);
+  msc_done = true;
+  return true;
+}
+
+// commands pending when device is removed must be completed with failed status
+static uint32_t msc_failed;
+static bool msc_failed_cb(uint8_t daddr, const tuh_msc_complete_data_t *cb_data) {
+  TEST_ASSERT(cb_data->csw->status == MSC_CSW_STATUS_FAILED);
+  TEST_ASSERT(!tuh_msc_read10(daddr, 0, cb_data->scsi_data, 0, 1, msc_complete_cb, 0)); // no longer accepted
+  msc_failed++;
+  return true;
+}
+
+//--------------------------------------------------------------------+
+// Helper
+//--------------------------------------------------------------------+
+// run stack for a number of 1ms frames
+static void run_frames(uint32_t frames) {
+  for (uint32_t i = 0; i < frames; i++) {
+    tuh_int_handler(0, false);
+    tuh_task();
+  }
+}
+
+// run until all devices behind the hub are mounted (hub itself is not reported), return number of frames it took
+static uint32_t wait_all_mounted(void) {
+  const uint32_t start = hcd_frame_number(0);
+  while (mounted_count < DEVICE_COUNT) {
+    TEST_ASSERT(hcd_frame_number(0) - start < 20000);
+    run_frames(1);
+  }
+  return hcd_frame_number(0) - start;
+}
+
+static inline uint8_t pattern(uint32_t i) {
+  return (uint8_t) (i * 7 + (i / 251));
+}
+
+//--------------------------------------------------------------------+
+// Tests
+//--------------------------------------------------------------------+
+static void test_enumeration(void) {
+  const uint32_t frames = wait_all_mounted();
+  TEST_ASSERT(msc_daddr != 0 && cdc_mounted == 2 && hid_mounted == 1);
+  run_frames(100);
+  TEST_ASSERT(hid_reports > 0);
+  printf("enumeration of hub + %u devices: %u frames\n", DEVICE_COUNT, frames);
+}
+
+static void msc_wait(void) {
+  while (!msc_done) {
+    run_frames(1);
+  }
+  msc_done = false;
+}
+
+static void test_msc(uint32_t iterations) {
+  static uint8_t buf[64 * DISK_BLOCK_SIZE];
+  const uint16_t block_count = 64;
+
+  for (uint32_t i = 0; i < sizeof(buf); i++) {
+    buf[i] = pattern(i);
+  }
+  TEST_ASSERT(tuh_msc_write10(msc_daddr, 0, buf, 5, block_count, msc_complete_cb, 0));
+  msc_wait();
+  TEST_ASSERT(memcmp(disk + 5 * DISK_BLOCK_SIZE, buf, sizeof(buf)) == 0);
+
+  for (uint32_t i = 0; i < sizeof(disk); i++) {
+    disk[i] = pattern(i);
+  }
+  const double t0 = test_time_now();
+  for (uint32_t c = 0; c < iterations; c++) {
+    const uint32_t lba = (c * block_count) % DISK_BLOCK_COUNT;
+    TEST_ASSERT(tuh_msc_read10(msc_daddr, 0, buf, lba, block_count, msc_complete_cb, 0));
+    msc_wait();
+    TEST_ASSERT(memcmp(buf, disk + lba * DISK_BLOCK_SIZE, sizeof(buf)) == 0);
+  }
+  test_report_rate("msc read10", (double) iterations * sizeof(buf), test_time_now() - t0);
+}
+
+// Unplug MSC while commands are in flight and queued
+static void test_msc_unplug(void) {
+  static uint8_t buf[CFG_TUH_MSC_QUEUE_DEPTH + 1][DISK_BLOCK_SIZE];
+  for (uint32_t i = 0; i < CFG_TUH_MSC_QUEUE_DEPTH + 1; i++) {
+    TEST_ASSERT(tuh_msc_read10(msc_daddr, 0, buf[i], i, 1, msc_failed_cb, 0));
+  }
+  TEST_ASSERT(tuh_msc_queue_count(msc_daddr) == CFG_TUH_MSC_QUEUE_DEPTH);
+
+  TEST_ASSERT(tuh_sim_hub_detach(&hub_dev, HUB_PORT_MSC));
+  run_frames(600);
+  TEST_ASSERT(msc_daddr == 0 && msc_failed == CFG_TUH_MSC_QUEUE_DEPTH + 1);
+
+  TEST_ASSERT(tuh_sim_hub_attach(&hub_dev, HUB_PORT_MSC, &msc_dev));
+  const uint32_t start = hcd_frame_number(0);
+  while (msc_daddr == 0) {
+    TEST_ASSERT(hcd_frame_number(0) - start < 5000);
+    run_frames(1);
+  }
+}
+
+// Stream a byte sequence through loopback serial devices with a slow reader, so that RX FIFO runs full
+static void test_cdc_loopback(void) {
+  for (uint8_t idx = 0; idx < CFG_TUH_CDC; idx++) {
+    const uint32_t total = 200000;
+    uint32_t written = 0, received = 0;
+    uint8_t  buf[256];
+
+    TEST_ASSERT(tuh_cdc_mounted(idx));
+    for (uint32_t frame = 0; received < total; frame++) {
+      TEST_ASSERT(frame < 100000);
+      const uint32_t n = tu_min32(tu_min32(tuh_cdc_write_available(idx), sizeof(buf)), total - written);
+      for (uint32_t i = 0; i < n; i++) {
+        buf[i] = pattern(written + i);
+      }
+      written += tuh_cdc_write(idx, buf, n);
+      tuh_cdc_write_flush(idx);
+      run_frames(1);
+
+      const uint32_t count = tuh_cdc_read(idx, buf, (frame % 3) ? 40 : 200);
+      for (uint32_t i = 0; i < count; i++) {
+        TEST_ASSERT(buf[i] == pattern(received + i));
+      }
+      received += count;
+    }
+    printf("cdc%u loopback %u bytes ok\n", idx, received);
+  }
+}
+
+static void test_plug_cycles(uint32_t cycles) {
+  double t0 = test_time_now();
+  for (uint32_t c = 0; c < cycles; c++) {
+    TEST_ASSERT(tuh_sim_hub_detach(&hub_dev, HUB_PORT_HID));
+    run_frames(600);
+    TEST_ASSERT(hid_mounted == 0);
+    TEST_ASSERT(tuh_sim_hub_attach(&hub_dev, HUB_PORT_HID, &hid_dev));
+    const uint32_t start = hcd_frame_number(0);
+    while (hid_mounted == 0) {
+      TEST_ASSERT(hcd_frame_number(0) - start < 5000);
+      run_frames(1);
+    }
+  }
+  printf("hub port plug cycles: %u, %.3f ms wall each\n", cycles, (test_time_now() - t0) * 1e3 / cycles);
+
+  t0 = test_time_now();
+  for (uint32_t c = 0; c < cycles; c++) {
+    tuh_sim_detach(0);
+    run_frames(50);
+    TEST_ASSERT(mounted_count == 0);
+    TEST_ASSERT(tuh_sim_attach(0, &hub_dev));
+    wait_all_mounted();
+  }
+  printf("root port plug cycles: %u, %.3f ms wall each\n", cycles, (test_time_now() - t0) * 1e3 / cycles);
+}
+
+int main(int argc, char **argv) {
+  const uint32_t cycles = (argc > 1) ? (uint32_t) atoi(argv[1]) : 20;
+
+  tuh_sim_hub_init(&hub_dev, &hub, TUSB_SPEED_HIGH, TUH_SIM_HUB_PORT_MAX);
+  tuh_sim_msc_init(&msc_dev, &msc, TUSB_SPEED_HIGH, disk, DISK_BLOCK_COUNT, DISK_BLOCK_SIZE);
+  tuh_sim_cdc_init(&cdc_dev, &cdc_serial, TUSB_SPEED_HIGH, true);
+  tuh_sim_ftdi_init(&ftdi_dev, &ftdi_serial, true);
+  tuh_sim_hid_init(&hid_dev, &hid);
+  tuh_sim_midi_init(&midi_dev, &midi_serial, true);
+  TEST_ASSERT(tuh_sim_hub_attach(&hub_dev, HUB_PORT_MSC, &msc_dev));
+  TEST_ASSERT(tuh_sim_hub_attach(&hub_dev, HUB_PORT_CDC, &cdc_dev));
+  TEST_ASSERT(tuh_sim_hub_attach(&hub_dev, HUB_PORT_FTDI, &ftdi_dev));
+  TEST_ASSERT(tuh_sim_hub_attach(&hub_dev, HUB_PORT_HID, &hid_dev));
+  TEST_ASSERT(tuh_sim_hub_attach(&hub_dev, HUB_PORT_MIDI, &midi_dev));
+
+  const tusb_rhport_init_t host_init = {.role = TUSB_ROLE_HOST, .speed = TUSB_SPEED_AUTO};
+  TEST_ASSERT(tusb_init(0, &host_init));
+  TEST_ASSERT(tuh_sim_attach(0, &hub_dev));
+
+  test_enumeration();
+  test_msc(cycles * 10);
+  test_msc_unplug();
+  test_cdc_loopback();
+  test_plug_cycles(cycles);
+
+  // pending events can never exceed queue size
+  tuh_task_stats_t stats;
+  tuh_task_stats_get(&stats);
+  TEST_ASSERT(stats.event_count > 0 && stats.queue_hwm <= stats.queue_size);
+
+  printf("host sim: all tests passed\n");
+  return 0;
+}